@@ -23,12 +23,18 @@ endif()
 # -------------------------------------------------------------------------------------------------- #
 check_c_source_compiles("
   #include <wmmintrin.h>
+  #if defined( __GNUC__ ) || defined( __clang__ )
+   __attribute__(( target( \"pclmul,sse2\" )))
+  #endif
+  static __m128i clmul( __m128i a, __m128i b ) {
+   return _mm_clmulepi64_si128( a, b, 0x00 );
+  }
   int main( void ) {
 
-   __m128i a, b, c;
-   c = _mm_clmulepi64_si128( a, b, 0x00 );
+   __m128i a = _mm_setzero_si128(), b = _mm_setzero_si128(), c;
+   c = clmul( a, b );
 
-  return 0;
+  return _mm_cvtsi128_si32( c );
  }" AK_HAVE_BUILTIN_CLMULEPI64 )
 
 if( AK_HAVE_BUILTIN_CLMULEPI64 )
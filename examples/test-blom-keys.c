@@ -8,6 +8,7 @@
  int user_generate_test( const ak_uint32 , const ak_uint32 , ak_uint8 * );
  int user_generate_abonent_test( ak_blomkey , ak_uint8 * );
  int user_generate_pairwise_test( ak_blomkey , ak_blomkey , ak_uint8 *, bool_t );
+ int user_generate_pairwise_batch_test( ak_blomkey , ak_oid , ak_uint8 * );
  int user_import_matrix_test( ak_uint8 * );
  int user_import_abonent_test( ak_uint8 * );
 
@@ -85,7 +86,7 @@
 
  /* вывод ключевой информации */
   if( master.size <= 5 ) {
-    printf("matrix (%u bytes):\n", master.size*master.size*master.count );
+    printf("matrix (%u bytes):\n", master.size*( master.size+1 )/2*master.count );
     for( i = 0; i < ak_min( 5, master.size ); i++ ) {
       for( j = 0; j < ak_min( 5, master.size ); j++ ) {
          printf("a[%u,%u]: %s\n", i, j, ak_ptr_to_hexstr(
@@ -209,6 +210,10 @@
      goto labex2;
    }
 
+ /* ключи, выработанные в пакетном режиме, должны совпадать с ключами, выработанными по одному */
+  if( user_generate_pairwise_batch_test( abonent_one, oid, onehmac ) != EXIT_SUCCESS )
+    goto labex2;
+
   if( check_flag ) {
     if( ak_ptr_is_equal( onehmac, check, ak_hmac_get_tag_size( oneKey ))) {
       printf("%s - checked value is Ok\n", __func__ );
@@ -234,6 +239,53 @@
  return exitcode;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+ int user_generate_pairwise_batch_test( ak_blomkey abonent, ak_oid oid, ak_uint8 *hmac )
+{
+  size_t i;
+  char names[20][32];
+  ak_uint8 keys[20][64], key[64], out[64];
+  struct blomkey_pairwise_task tasks[20];
+  int exitcode = EXIT_FAILURE;
+
+  memset( tasks, 0, sizeof( tasks ));
+  for( i = 0; i < 20; i++ ) {
+     if( i == 11 ) tasks[i].id = IDtwo;
+      else {
+       sprintf( names[i], "sensor node %u", (unsigned int) i );
+       tasks[i].id = names[i];
+     }
+     tasks[i].id_size = strlen( tasks[i].id );
+     tasks[i].key = keys[i];
+     tasks[i].key_size = sizeof( keys[i] );
+  }
+  if( ak_blomkey_create_pairwise_key_batch( abonent, tasks, 20, oid ) != ak_error_ok ) {
+    printf("%s - incorrect batch generation of pairwise keys\n", __func__ );
+    return EXIT_FAILURE;
+  }
+  for( i = 0; i < 20; i++ ) {
+     ak_blomkey_create_pairwise_key_as_ptr( abonent, tasks[i].id, tasks[i].id_size,
+                                                                             key, sizeof( key ));
+     if( !ak_ptr_is_equal( key, keys[i], abonent->count )) {
+       printf("%s - wrong batch value of pairwise key for \"%s\"\n",
+                                                                   __func__, (char *)tasks[i].id );
+       goto labex;
+     }
+  }
+  ak_hmac_ptr( tasks[11].skey, "make love not war", 16, out,
+                                                         ak_hmac_get_tag_size( tasks[11].skey ));
+  if( !ak_ptr_is_equal( out, hmac, ak_hmac_get_tag_size( tasks[11].skey ))) {
+    printf("%s - wrong batch generation of %s pairwise key\n", __func__, oid->name[0] );
+    goto labex;
+  }
+  printf("%s - batch generation of %u pairwise keys is Ok\n", __func__, 20 );
+  exitcode = EXIT_SUCCESS;
+
+ labex:
+  for( i = 0; i < 20; i++ ) ak_oid_delete_object( oid, tasks[i].skey );
+ return exitcode;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int user_import_matrix_test( ak_uint8 *check )
 {
@@ -248,7 +300,7 @@
 
  /* вывод ключевой информации */
   if( master.size <= 5 ) {
-    printf("matrix (%u bytes):\n", master.size*master.size*master.count );
+    printf("matrix (%u bytes):\n", master.size*( master.size+1 )/2*master.count );
     for( i = 0; i < ak_min( 5, master.size ); i++ ) {
       for( j = 0; j < ak_min( 5, master.size ); j++ ) {
          printf("a[%u,%u]: %s\n", i, j, ak_ptr_to_hexstr(
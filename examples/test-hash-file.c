@@ -0,0 +1,100 @@
+/* Тестовый пример, проверяющий вычисление хеш-кода от содержимого файла.
+   Результаты, полученные для обычного файла (обрабатывается с помощью последовательного
+   отображения в память нескольких фрагментов) и для канала (обрабатывается с помощью чтения),
+   сравниваются с хеш-кодом, вычисленным от той же области памяти.
+
+   test-hash-file.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+#if defined(__unix__) || defined(__APPLE__)
+ #include <unistd.h>
+ #include <sys/wait.h>
+#endif
+
+/* длина данных не кратна длине блока, превышает суммарный размер буфферов чтения
+   и два фрагмента, одновременно отображаемых в память (по 64 Мб), так что обработка
+   обычного файла переходит через границы фрагментов и завершается неполным фрагментом */
+ #define data_size ( (size_t) 2*64*1024*1024 + 4099 )
+
+/* сравнение хеш-кода файла с хеш-кодом, вычисленным от памяти */
+ int test_function( ak_hash ctx, const char *filename, const char *name, const ak_uint8 *result )
+{
+  ak_uint8 out[32];
+  int error = ak_error_ok;
+
+  memset( out, 0, sizeof( out ));
+  printf( "%s: ", name ); fflush( stdout );
+  if(( error = ak_hash_file( ctx, filename, out, sizeof( out ))) != ak_error_ok ) {
+    printf( "error %d\n", error );
+    return ak_false;
+  }
+  printf( "%s ", ak_ptr_to_hexstr( out, sizeof( out ), ak_false ));
+  if( memcmp( out, result, sizeof( out )) != 0 ) { printf( "Wrong\n" ); return ak_false; }
+  printf( "Ok\n" );
+ return ak_true;
+}
+
+ int main( void )
+{
+  size_t idx = 0;
+  FILE *fp = NULL;
+  struct hash ctx;
+  ak_uint8 result[32], *data = NULL;
+  int error = EXIT_SUCCESS;
+  const char *filename = "test-hash-file.dat";
+
+  printf( "file hashing test for libakrypt, version %s\n", ak_libakrypt_version( ));
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+
+  if(( data = malloc( data_size )) == NULL ) return ak_libakrypt_destroy();
+  for( idx = 0; idx < data_size; idx++ ) data[idx] = ( ak_uint8 )( idx*7 + ( idx >> 11 ));
+
+  ak_hash_create_streebog256( &ctx );
+  ak_hash_ptr( &ctx, data, data_size, result, sizeof( result ));
+  printf( "memory: %s\n", ak_ptr_to_hexstr( result, sizeof( result ), ak_false ));
+
+ /* обычный файл */
+  if(( fp = fopen( filename, "wb" )) == NULL ) error = EXIT_FAILURE;
+   else {
+     if( fwrite( data, 1, data_size, fp ) != data_size ) error = EXIT_FAILURE;
+     fclose( fp );
+     if( test_function( &ctx, filename, "regular file", result ) != ak_true ) error = EXIT_FAILURE;
+     remove( filename );
+   }
+
+#if defined(__unix__) || defined(__APPLE__)
+ /* канал, данные в который записываются порожденным процессом небольшими фрагментами */
+  {
+    int fd[2];
+    pid_t pid;
+    char name[64];
+
+    if( pipe( fd ) != 0 ) error = EXIT_FAILURE;
+     else {
+      if(( pid = fork( )) == 0 ) {
+        close( fd[0] );
+        for( idx = 0; idx < data_size; idx += 4099 )
+           if( write( fd[1], data + idx, ak_min( 4099, data_size - idx )) < 0 ) _exit( 1 );
+        close( fd[1] );
+        _exit( 0 );
+      }
+      close( fd[1] );
+      snprintf( name, sizeof( name ), "/dev/fd/%d", fd[0] );
+      if(( pid < 0 ) || ( test_function( &ctx, name, "pipe", result ) != ak_true ))
+        error = EXIT_FAILURE;
+      close( fd[0] );
+      if( pid > 0 ) waitpid( pid, NULL, 0 );
+    }
+  }
+#endif
+
+  ak_hash_destroy( &ctx );
+  free( data );
+  ak_libakrypt_destroy();
+
+ return error;
+}
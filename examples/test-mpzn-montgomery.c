@@ -224,6 +224,83 @@
  return ( val == count );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/* тест для операции возведения в степень в представлении монтгомери */
+ bool_t modpow_montgomery_test( size_t size, const char *prime, ak_uint64 n0, size_t count )
+{
+  size_t i = 0, val = 0, valv = 0;
+  mpz_t xm, km, zm, pm, rm, sm;
+  ak_mpznmax x, k, p, z;
+  struct random generator;
+  clock_t tmr;
+
+  mpz_init(xm);
+  mpz_init(km);
+  mpz_init(zm);
+  mpz_init(pm);
+  mpz_init(rm);
+  mpz_init(sm);
+  ak_random_create_lcg( &generator );
+
+  mpz_set_str( pm, prime, 16 );
+  mpz_set_ui( rm, 2 ); mpz_pow_ui( rm, rm, size*64 ); mpz_mod( rm, rm, pm ); /* r (mod p) */
+  mpz_invert( sm, rm, pm );                                                  /* r^{-1} (mod p) */
+  ak_mpz_to_mpzn( pm, p, size );
+
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( x, p, size, &generator );
+     ak_mpzn_set_random( k, size, &generator );
+     if( i%4 == 0 ) ak_mpzn_set_ui( k, size, i ); /* небольшие показатели, в том числе ноль */
+     ak_mpzn_to_mpz( x, size, xm );
+     ak_mpzn_to_mpz( k, size, km );
+
+     // тестовый пример: (x r^{-1})^k r (mod p)
+     mpz_mul( zm, xm, sm ); mpz_mod( zm, zm, pm );
+     mpz_powm( zm, zm, km, pm );
+     mpz_mul( zm, zm, rm ); mpz_mod( zm, zm, pm );
+
+     ak_mpzn_modpow_montgomery( z, x, k, p, n0, size );
+     ak_mpzn_to_mpz( z, size, xm );
+     if( mpz_cmp( xm, zm ) == 0 ) val++;
+
+     ak_mpzn_modpow_montgomery_vartime( z, x, k, p, n0, size );
+     ak_mpzn_to_mpz( z, size, xm );
+     if( mpz_cmp( xm, zm ) == 0 ) valv++;
+  }
+  printf(" correct montgomery exponentiations %ld (fixed window), %ld (sliding window) from %ld\n",
+                                                                              val, valv, count );
+  // speed test
+  ak_mpzn_set_random_modulo( x, p, size, &generator );
+  ak_mpzn_set_random( k, size, &generator );
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_modpow_montgomery( x, x, k, p, n0, size );
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs (fixed window)\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_modpow_montgomery_vartime( x, x, k, p, n0, size );
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs (sliding window)\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  ak_mpzn_to_mpz( x, size, xm );
+  ak_mpzn_to_mpz( k, size, km );
+  tmr = clock();
+  for( i = 0; i < count; i++ ) mpz_powm( xm, xm, km, pm );
+  tmr = clock() - tmr;
+  printf(" gmp time:  %.3fs\n\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  ak_random_destroy( &generator );
+  mpz_clear(sm);
+  mpz_clear(rm);
+  mpz_clear(pm);
+  mpz_clear(zm);
+  mpz_clear(km);
+  mpz_clear(xm);
+
+ return (( val == count ) && ( valv == count ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int main( void )
 {
@@ -248,10 +325,10 @@
         printf(" - ak_mpzn_mul_montgomery() function test for ak_mpzn256 started\n");
         totalmany++;
         if( mul_montgomery_test( wc->size, str, wc->n, count )) howmany++;
+        printf(" - ak_mpzn_modpow_montgomery() function test for ak_mpzn256 started\n");
+        totalmany++;
+        if( modpow_montgomery_test( wc->size, str, wc->n, count/1000 )) howmany++;
         if( str ) free( (void *)str );
-
-  // добавить modpow!!
-
       }
       if( wc->size == ak_mpzn512_size ) {
         printf(" - p: %s\n", str = ak_mpzn_to_hexstr_alloc( wc->p, wc->size ));
@@ -261,6 +338,9 @@
         printf(" - ak_mpzn_mul_montgomery() function test for ak_mpzn512 started\n");
         totalmany++;
         if( mul_montgomery_test( wc->size, str, wc->n, count )) howmany++;
+        printf(" - ak_mpzn_modpow_montgomery() function test for ak_mpzn512 started\n");
+        totalmany++;
+        if( modpow_montgomery_test( wc->size, str, wc->n, count/1000 )) howmany++;
         if( str ) free( (void *)str );
       }
     }
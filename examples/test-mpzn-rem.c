@@ -55,6 +55,23 @@
   printf(" %lu (%lu) tests passed successfully from %lu \n", mpzcount, mycount, count );
   if(( mpzcount == count ) && (  mycount == count )) rescount++;
 
+ /* третий тест - приведение по модулю q с помощью умножения Монтгомери */
+  printf(" - q: (ak_wcurve_rem_q)\n");
+  mpzcount = mycount = 0;
+  for( j = 0; j < count; j++ ) {
+     ak_mpzn_set_random( x, wc->size, &generator );
+     if( j%2 ) memset( x, 0xff, wc->size*sizeof( ak_uint64 )); /* максимальное значение */
+     ak_wcurve_rem_q( r, x, wc ); /* r <- x (mod q) */
+
+     ak_mpzn_to_mpz( x, wc->size, xp );
+     mpz_mod( rp, xp, pp ); /* rp <- xp (mod pp) */
+
+     ak_mpzn_to_mpz( r, wc->size, xp ); if( !mpz_cmp( rp, xp )) mpzcount++;
+     ak_mpz_to_mpzn( rp, l, wc->size ); if( !ak_mpzn_cmp( r, l, wc->size )) mycount++;
+  }
+  printf(" %lu (%lu) tests passed successfully from %lu \n", mpzcount, mycount, count );
+  if(( mpzcount == count ) && (  mycount == count )) rescount++;
+
   ak_random_destroy( &generator );
   mpz_clear( xp );
   mpz_clear( rp );
@@ -150,7 +167,7 @@
   while( oid != NULL ) {
     if( oid->mode == wcurve_params ) {
      /* достаем простое число */
-      totalmany += 2;
+      totalmany += 3;
       howmany += mpzn_rem_test( (ak_wcurve)(oid->data), 1000000 );
     }
     oid = ak_oid_findnext_by_engine( oid, identifier );
@@ -375,13 +375,12 @@
     goto lab1;
   }
 
- /* копируем данные и проверям, что точка действительно принадлежит кривой */
+ /* копируем данные и проверям, что точка действительно принадлежит подгруппе точек кривой */
   ak_mpzn_set_little_endian( vkey->qpoint.x, val, ptr, val64, ak_false );
   ak_mpzn_set_little_endian( vkey->qpoint.y, val, ((ak_uint8*)ptr)+val64, val64, ak_false );
   ak_mpzn_set_ui( vkey->qpoint.z, val, 1 );
-  if( ak_wpoint_is_ok( &vkey->qpoint, vkey->wc ) != ak_true ) {
-    ak_error_message_fmt( error = ak_error_curve_point, __func__ ,
-                                                  "the public key isn't on given elliptic curve" );
+  if(( error = ak_verifykey_check_point( vkey )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "the public key isn't a point of given elliptic curve" );
     goto lab1;
   }
 
@@ -771,8 +771,8 @@
  \return Функция возвращает \ref ak_error_ok (ноль) в случае успеха, в случае неудачи
     возвращается код ошибки.                                                                       */
 /* ----------------------------------------------------------------------------------------------- */
- static int ak_skey_export_to_asn1_with_password( ak_pointer key,
-                                       ak_asn1 root, const char *password, const size_t pass_size )
+ int ak_skey_export_to_asn1_with_password( ak_pointer key,
+                                              ak_asn1 root, const char *password, const size_t pass_size )
 {
   int error = ak_error_ok;
   struct bckey ekey, ikey; /* производные ключи шифрования и имитозащиты */
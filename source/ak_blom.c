@@ -5,6 +5,11 @@
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество ключей парной связи, вычисляемых одновременно функцией
+    ak_blomkey_create_pairwise_key_batch(). */
+ #define ak_blomkey_batch_block  ( 8 )
+
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup skey-blom-doc Реализация схемы Блома распределения ключевой информации @{
    Схема Блома представляет собой механизм выработки секретных симметричных ключей парной связи,
@@ -59,6 +64,8 @@
   Создание ключа абонента \f$ Ka \f$ может быть выполнено с помощью функции ak_blomkey_create_abonent_key().
 
   Создание ключа парной связи \f$ Kab \f$ - с помощью функции ak_blomkey_create_pairwise_key().
+  Для одновременной выработки ключей парной связи с большим количеством абонентов
+  предназначена функция ak_blomkey_create_pairwise_key_batch().
 
   Удаление созданных ключей выполняется с помощью функции ak_blomkey_destroy().
 
@@ -68,6 +75,186 @@
 
   Отметим, что неприводимые многочлены, используемые для реализации элементарных операций
   в конечном поле \f$ GF(2^n)\f$, определены в файле ak_gf2n.c                                  @} */
+/* ----------------------------------------------------------------------------------------------- */
+/*                 размещение мастер-ключа в памяти и вычисление контрольной суммы                 */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает номер первого элемента строки `row` верхнетреугольной части
+    симметричной матрицы размера `size`; строки хранятся последовательно, строка с номером `row`
+    содержит элементы \f$ a_{row,row}, \ldots, a_{row,size-1} \f$. */
+ static inline size_t ak_blomkey_row_offset( const size_t size, const size_t row )
+{
+  return ( row*( 2*size - row + 1 )) >> 1;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает размер ключевых данных в октетах (без имитовставки). */
+ static size_t ak_blomkey_get_memsize( ak_blomkey bkey )
+{
+  if( bkey->type == blom_matrix_key )
+    return ak_blomkey_row_offset( bkey->size, bkey->size )*bkey->count;
+ return ( size_t )bkey->size*bkey->count;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Порция работы, выполняемая одним потоком при выработке мастер-ключа
+    и вычислении контрольной суммы. */
+ typedef struct blomkey_thread {
+  /*! \brief Обрабатываемая потоком область памяти. */
+   ak_uint8 *data;
+  /*! \brief Размер области памяти (в октетах). */
+   size_t size;
+  /*! \brief Генератор, используемый потоком для выработки ключевых данных. */
+   ak_random generator;
+  /*! \brief Собственный генератор потока. */
+   struct random local;
+  /*! \brief Контекст хеш-функции, используемый потоком. */
+   ak_hash hash;
+  /*! \brief Собственный контекст хеш-функции потока. */
+   struct hash ctx;
+  /*! \brief Область памяти для хеш-кодов фрагментов. */
+   ak_uint8 *out;
+  /*! \brief Код ошибки, возникшей при выполнении потока. */
+   int error;
+ } *ak_blomkey_thread;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер фрагмента ключевых данных, для которого вычисляется отдельный хеш-код
+    при вычислении контрольной суммы. */
+ #define ak_blomkey_leaf_size  ( 1048576 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заполняет порцию ключевых данных случайными значениями. */
+ static void *ak_blomkey_random_thread( void *ptr )
+{
+  ak_blomkey_thread th = ( ak_blomkey_thread ) ptr;
+  th->error = ak_random_ptr( th->generator, th->data, ( ssize_t )th->size );
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет хеш-коды фрагментов из порции ключевых данных. */
+ static void *ak_blomkey_hash_thread( void *ptr )
+{
+  size_t len = 0;
+  ak_uint8 *data = NULL, *out = NULL;
+  ak_blomkey_thread th = ( ak_blomkey_thread ) ptr;
+
+  th->error = ak_error_ok;
+  for( data = th->data, out = th->out; data < th->data + th->size; data += len, out += 32 ) {
+     len = ak_min( ak_blomkey_leaf_size, ( size_t )( th->data + th->size - data ));
+     if(( th->error = ak_hash_ptr( th->hash, data, len, out, 32 )) != ak_error_ok ) break;
+  }
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заполняет ключевые данные мастер-ключа случайными значениями.
+    \details Область памяти разбивается на непрерывные части, количество которых определяется
+    опцией `threads_count`, и части заполняются параллельно. Первая часть заполняется
+    генератором `generator`, каждая из остальных - собственным генератором того же типа,
+    начальное состояние которого вырабатывается генератором `generator`. Если создать
+    генератор того же типа невозможно, то данные вырабатываются в одном потоке. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_blomkey_generate_data( ak_blomkey bkey, ak_random generator )
+{
+  ak_uint8 seed[64];
+  ak_blomkey_thread th = NULL;
+  int error = ak_error_ok;
+  size_t idx = 0, elements = ak_blomkey_row_offset( bkey->size, bkey->size ),
+         threads = ak_libakrypt_get_threads_count( elements*bkey->count/ak_blomkey_leaf_size );
+
+  if(( th = calloc( threads, sizeof( struct blomkey_thread ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+
+ /* вырабатываем собственные генераторы потоков */
+  for( idx = 1; idx < threads; idx++ ) {
+     if(( generator->oid == NULL ) ||
+        ( ak_random_create_oid( &th[idx].local, generator->oid ) != ak_error_ok )) break;
+     if( th[idx].local.randomize_ptr != NULL ) {
+       if(( ak_random_ptr( generator, seed, sizeof( seed )) != ak_error_ok ) ||
+          ( ak_random_randomize( &th[idx].local, seed, sizeof( seed )) != ak_error_ok )) {
+         ak_random_destroy( &th[idx].local );
+         break;
+       }
+     }
+     th[idx].generator = &th[idx].local;
+  }
+  ak_ptr_wipe( seed, sizeof( seed ), generator );
+  if( idx < threads ) {
+    while( idx > 1 ) ak_random_destroy( &th[--idx].local );
+    threads = 1;
+  }
+  th[0].generator = generator;
+
+ /* каждый поток получает непрерывную часть матрицы */
+  for( idx = 0; idx < threads; idx++ ) {
+     size_t first = idx*elements/threads;
+     th[idx].data = bkey->data + first*bkey->count;
+     th[idx].size = (( idx+1 )*elements/threads - first )*bkey->count;
+  }
+  ak_libakrypt_run_threads( ak_blomkey_random_thread, th,
+                                                      sizeof( struct blomkey_thread ), threads );
+
+  for( idx = 0; idx < threads; idx++ ) {
+     if(( error == ak_error_ok ) && ( th[idx].error != ak_error_ok )) error = th[idx].error;
+     if( idx ) ak_random_destroy( &th[idx].local );
+  }
+  free( th );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет контрольную сумму ключевых данных.
+    \details Ключевые данные разбиваются на фрагменты длины \ref ak_blomkey_leaf_size октетов,
+    для каждого фрагмента вычисляется хеш-код, после чего контрольная сумма вычисляется
+    как хеш-код от последовательности хеш-кодов фрагментов. Значение не зависит от количества
+    потоков, между которыми распределяются фрагменты (см. опцию `threads_count`). */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_blomkey_get_icode( ak_blomkey bkey, ak_uint8 *icode )
+{
+  ak_uint8 *out = NULL;
+  ak_blomkey_thread th = NULL;
+  int error = ak_error_ok;
+  size_t idx = 0, memsize = ak_blomkey_get_memsize( bkey ),
+         leaves = ( memsize + ak_blomkey_leaf_size - 1 )/ak_blomkey_leaf_size,
+         threads = ak_libakrypt_get_threads_count( leaves );
+
+  if(( out = malloc( 32*leaves )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  if(( th = calloc( threads, sizeof( struct blomkey_thread ))) == NULL ) {
+    free( out );
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  }
+
+ /* первый поток использует контекст ключа, остальные - собственные контексты */
+  th[0].hash = &bkey->ctx;
+  for( idx = 1; idx < threads; idx++ ) {
+     if( ak_hash_create_oid( &th[idx].ctx, bkey->ctx.oid ) != ak_error_ok ) break;
+     th[idx].hash = &th[idx].ctx;
+  }
+  threads = idx;
+
+ /* каждый поток получает непрерывную последовательность фрагментов */
+  for( idx = 0; idx < threads; idx++ ) {
+     size_t first = idx*leaves/threads, last = ( idx+1 )*leaves/threads;
+     th[idx].data = bkey->data + first*ak_blomkey_leaf_size;
+     th[idx].size = ak_min( last*ak_blomkey_leaf_size, memsize ) - first*ak_blomkey_leaf_size;
+     th[idx].out = out + 32*first;
+  }
+  ak_libakrypt_run_threads( ak_blomkey_hash_thread, th,
+                                                      sizeof( struct blomkey_thread ), threads );
+
+  for( idx = 0; idx < threads; idx++ ) {
+     if(( error == ak_error_ok ) && ( th[idx].error != ak_error_ok )) error = th[idx].error;
+     if( idx ) ak_hash_destroy( &th[idx].ctx );
+  }
+  if( error == ak_error_ok ) error = ak_hash_ptr( &bkey->ctx, out, 32*leaves, icode, 32 );
+
+  free( th );
+  free( out );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  static bool_t ak_blomkey_check_icode( ak_blomkey bkey )
 {
@@ -84,9 +271,10 @@
 
  /* вычисляем контрольную сумму и сравниваем */
   memset( value, 0, sizeof( value ));
-  ak_hash_ptr( &bkey->ctx, bkey->data,
-                    bkey->type == blom_matrix_key ? (bkey->size)*(bkey->size)*bkey->count :
-                                                             (bkey->size)*bkey->count, value, 32 );
+  if( ak_blomkey_get_icode( bkey, value ) != ak_error_ok ) {
+    ak_error_message( ak_error_get_value(), __func__, "incorrect calculation of integrity code" );
+    return ak_false;
+  }
   if( ak_ptr_is_equal( value, bkey->icode, 32 ) == ak_false ) {
     ak_error_message( ak_error_not_equal_data, __func__, "integrity code is wrong" );
     return ak_false;
@@ -94,12 +282,59 @@
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет имитовставку ключевых данных при экспорте и импорте ключа.
+    \details Имитовставка вычисляется от синхропосылки `iv` и ключевых данных, при этом
+    мастер-ключ обрабатывается построчно как полная симметричная матрица размера
+    (`size`)x(`size`) элементов; это сохраняет совместимость с ранее созданными файлами. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_blomkey_get_cmac( ak_blomkey bkey, ak_bckey ikey, ak_uint8 *iv, ak_uint8 *out )
+{
+  ak_uint8 *row = NULL;
+  struct random generator;
+  int error = ak_error_ok;
+  size_t i, j, len = ( size_t )bkey->size*bkey->count, memsize = ak_blomkey_get_memsize( bkey );
+
+  ak_bckey_cmac_clean( ikey );
+  ak_bckey_cmac_update( ikey, iv, 16 );
+  if( bkey->type != blom_matrix_key ) {
+    if( memsize > 16 ) ak_bckey_cmac_update( ikey, bkey->data, memsize - 16 );
+   return ak_bckey_cmac_finalize( ikey, bkey->data + memsize - 16, 16, out, 16 );
+  }
+
+ /* восстанавливаем строки матрицы по ее верхнетреугольной части */
+  if(( row = malloc( len )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  for( i = 0; i < bkey->size; i++ ) {
+     for( j = 0; j < i; j++ )
+        memcpy( row + j*bkey->count, bkey->data +
+                         ( ak_blomkey_row_offset( bkey->size, j ) + i - j )*bkey->count, bkey->count );
+     memcpy( row + i*bkey->count, bkey->data +
+                     ak_blomkey_row_offset( bkey->size, i )*bkey->count, len - i*bkey->count );
+     if( i < bkey->size - 1 ) ak_bckey_cmac_update( ikey, row, len );
+      else {
+        ak_bckey_cmac_update( ikey, row, len - 16 );
+        error = ak_bckey_cmac_finalize( ikey, row + len - 16, 16, out, 16 );
+      }
+  }
+
+  if( ak_random_create_lcg( &generator ) == ak_error_ok ) {
+    ak_ptr_wipe( row, len, &generator );
+    ak_random_destroy( &generator );
+  }
+  free( row );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! В ходе своего выполнения функция вырабатывает симметричную матрицу,
     состоящую из (`size`)x(`size`) элементов конечного поля \f$ GF(2^n)\f$, где `n` это количество
     бит (задается параметром `count`). Например, для поля \f$ GF(2^{256})\f$ величина `count` должна
     принимать значение 32.
 
+    В памяти хранится только верхнетреугольная часть матрицы, элементы которой вырабатываются
+    параллельно несколькими потоками (количество потоков определяется опцией `threads_count`).
+
     \param bkey указатель на контекст мастер-ключа
     \param size размер матрицы
     \param count количество октетов, определяющих размер конечного поля;
@@ -112,8 +347,7 @@
                                                       const ak_uint32 count, ak_random generator )
 {
   int error = ak_error_ok;
-  ak_uint32 column = 0, row = 0;
-  size_t memsize = size*size*count;
+  size_t memsize = 0;
 
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                       "using null pointer to secret key context" );
@@ -123,21 +357,23 @@
   if(( count != ak_galois256_size ) && ( count != ak_galois512_size ))
    return ak_error_message( ak_error_undefined_value, __func__,
                                        "this function accepts only 256 or 512 bit galois fields" );
+  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                "using null pointer to random number generator" );
+  memset( bkey, 0, sizeof( struct blomkey ));
   bkey->type = blom_matrix_key;
   bkey->count = count;
   bkey->size = size;
+  memsize = ak_blomkey_get_memsize( bkey );
   if(( bkey->data = malloc( memsize + 16 )) == NULL ) /* 16 это размер имитовставки */
     return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
 
-  memset( bkey->data, 0, memsize + 16 );
-  for( column = 0; column < size; column++ ) {
-    /* копируем созданное ранее */
-     for( row = 0; row < column; row++ ) memcpy( bkey->data + column*count*size+row*count,
-                                     ak_blomkey_get_element_by_index( bkey, row, column ), count );
-    /* создаем новое */
-     ak_random_ptr( generator, bkey->data+column*count*(size+1),( size - column )*count );
-  }
-  
+  memset( bkey->data + memsize, 0, 16 );
+  if(( error = ak_blomkey_generate_data( bkey, generator )) != ak_error_ok ) {
+    free( bkey->data );
+    bkey->data = NULL;
+    return ak_error_message( error, __func__, "incorrect generation of secret matrix" );
+  }
+
   switch( bkey->count ) {
     case ak_galois256_size: error = ak_hash_create_streebog256( &bkey->ctx );
                             break;
@@ -150,8 +386,8 @@
     ak_blomkey_destroy( bkey );
     return ak_error_message( error, __func__, "incorrect creation of hash function context" );
   }
-  if(( error = ak_hash_ptr( &bkey->ctx, bkey->data, memsize,
-                                    bkey->icode, 32 )) != ak_error_ok ) ak_blomkey_destroy( bkey );
+  if(( error = ak_blomkey_get_icode( bkey, bkey->icode )) != ak_error_ok )
+    ak_blomkey_destroy( bkey );
  return error;
 }
 
@@ -169,9 +405,10 @@
                                                                ak_pointer id, const size_t idsize )
 {
   ak_uint8 value[64];
-  size_t memsize = 0;
   ak_int32 column = 0;
   ak_uint32 i, row = 0;
+  struct gf2n_table tab;
+  size_t memsize = 0, offset = 0;
   int error = ak_error_ok;
 
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
@@ -196,6 +433,10 @@
  /* формируем хэш от идентификатора */
   if(( error = ak_hash_ptr( &bkey->ctx, id, idsize, value, bkey->count )) != ak_error_ok )
     return ak_error_message( error, __func__, "incorrect evauation of initial hash value" );
+ /* хэш-значение является общим множителем во всех вычислениях по схеме Горнера,
+    поэтому для него заранее вычисляется таблица кратных значений */
+  if(( error = ak_gf2n_table_create( &tab, value, bkey->count, 0 )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of multiplication table" );
 
  /* формируем ключевые данные */
   if(( bkey->data = malloc( ( memsize = bkey->size*matrix->count ) + 16 )) == NULL )
@@ -205,16 +446,22 @@
   for( row = 0; row < bkey->size; row++ ) { /* схема Горнера для вычисления значений многочлена */
      ak_uint8 *sum = bkey->data + row*bkey->count;
      memset( sum, 0, bkey->count );
+    /* элементы a[row,column] при column >= row последовательно расположены в строке row
+       верхнетреугольной части, остальные - в столбце row, т.е. a[row,column] = a[column,row] */
+     offset = ak_blomkey_row_offset( bkey->size, row ) - row;
      for( column = bkey->size - 1; column >= 0; column-- ) {
-        ak_uint8 *key = ak_blomkey_get_element_by_index( matrix, row, column );
-        if( bkey->count == ak_galois256_size ) ak_gf256_mul( sum, sum, value );
-         else ak_gf512_mul( sum, sum, value );
-        for( i = 0; i < ( bkey->count >> 3 ); i++ ) ((ak_uint64 *)sum)[i] ^= ((ak_uint64 *)key)[i];
+        ak_uint64 *key;
+        if(( ak_uint32 )column >= row ) key = ( ak_uint64 * )( matrix->data +
+                                                                   ( offset + column )*bkey->count );
+         else key = ( ak_uint64 * )( matrix->data +
+                      ( ak_blomkey_row_offset( bkey->size, column ) + row - column )*bkey->count );
+        ak_gf2n_table_mul( &tab, sum, sum );
+        for( i = 0; i < ( bkey->count >> 3 ); i++ ) ((ak_uint64 *)sum)[i] ^= key[i];
      }
   }
 
-  if(( error = ak_hash_ptr( &bkey->ctx, bkey->data, memsize,
-                                    bkey->icode, 32 )) != ak_error_ok ) ak_blomkey_destroy( bkey );
+  if(( error = ak_blomkey_get_icode( bkey, bkey->icode )) != ak_error_ok )
+    ak_blomkey_destroy( bkey );
  return error;
 }
 
@@ -301,6 +548,7 @@
   ak_uint32 i = 0;
   ak_int32 row = 0;
   ak_uint8 value[64];
+  struct gf2n_table tab;
   int error = ak_error_ok;
 
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
@@ -319,12 +567,13 @@
  /* формируем хэш от идентификатора */
   if(( error = ak_hash_ptr( &bkey->ctx, id, idsize, value, bkey->count )) != ak_error_ok )
     return ak_error_message( error, __func__, "incorrect evauation of initial hash value" );
+  if(( error = ak_gf2n_table_create( &tab, value, bkey->count, 0 )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of multiplication table" );
 
   memset( key, 0, bkey->count );
   for( row = bkey->size - 1; row >= 0; row-- ) {
      ak_uint8 *element = ak_blomkey_get_element_by_index( bkey, row, 0 );
-     if( bkey->count == ak_galois256_size ) ak_gf256_mul( key, key, value );
-       else ak_gf512_mul( key, key, value );
+     ak_gf2n_table_mul( &tab, key, key );
      for( i = 0; i < ( bkey->count >> 3 ); i++ ) ((ak_uint64 *)key)[i] ^= ((ak_uint64 *)element)[i];
   }
 
@@ -332,7 +581,134 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \param bkey указатель на контекст мастер-ключа или ключа абонента
+/*! Функция вырабатывает ключи парной связи абонента `bkey` с абонентами, идентификаторы
+    которых заданы в массиве заданий. Для каждого задания должен быть определен идентификатор
+    абонента; ключ парной связи помещается в область памяти `key` (если указатель отличен от NULL),
+    а при заданном идентификаторе алгоритма `oid` - также в создаваемый функцией контекст
+    секретного ключа `skey`, который должен быть позднее удален с помощью
+    функции ak_oid_delete_object(). Результат выполнения задания помещается в поле `error`.
+
+    В отличие от последовательного вызова функции ak_blomkey_create_pairwise_key_as_ptr(),
+    контрольная сумма ключа абонента проверяется один раз, а значения многочленов
+    для блока заданий вычисляются одновременно: на каждом шаге схемы Горнера выполняется
+    независимое умножение для каждого задания блока, что позволяет процессору совмещать
+    выполнение умножений в конечном поле.
+
+    \param bkey указатель на контекст ключа абонента
+    \param tasks массив заданий
+    \param count количество заданий
+    \param oid идентификатор алгоритма, для которого предназначены ключи парной связи, или NULL
+    (в настоящее время  поддерживаются только секретные ключи блочных алгоритмов шифрования
+     и ключи алгоритмов HMAC).
+    \return Функция возвращает \ref ak_error_ok, если все ключи парной связи выработаны.
+    В противном случае возвращается код ошибки первого невыполненного задания.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_blomkey_create_pairwise_key_batch( ak_blomkey bkey,
+                               ak_blomkey_pairwise_task tasks, const size_t count, ak_oid oid )
+{
+  ak_int32 row = 0;
+  ak_uint8 value[64];
+  ak_gf2n_table tab = NULL;
+  struct random generator;
+  int error = ak_error_ok;
+  size_t i = 0, idx = 0, first = 0, len = 0;
+  ak_uint64 sum[ak_blomkey_batch_block][8];
+
+  if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to abonent's key" );
+  if( bkey->type != blom_abonent_key ) return ak_error_message( ak_error_wrong_key_type,
+                                                   __func__, "incorrect type of blom secret key" );
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                              "using null pointer to tasks array" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "using empty array of tasks" );
+  if( oid != NULL ) {
+    if( oid->mode != algorithm ) return ak_error_message( ak_error_oid_mode, __func__,
+                                                  "using wrong mode to pairwise key identifier" );
+    if(( oid->engine != block_cipher ) && ( oid->engine != hmac_function ))
+      return ak_error_message( ak_error_oid_engine, __func__,
+                                                "using wrong engine to pairwise key identifier" );
+  }
+  if( !ak_blomkey_check_icode( bkey ))
+    return ak_error_message( ak_error_get_value(), __func__, "using wrong blom master key" );
+  if(( tab = malloc( ak_blomkey_batch_block*sizeof( struct gf2n_table ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+
+  for( first = 0; first < count; first += len ) {
+     len = ak_min( count - first, ak_blomkey_batch_block );
+
+    /* формируем хэш от идентификаторов и таблицы кратных значений */
+     for( idx = 0; idx < len; idx++ ) {
+        ak_blomkey_pairwise_task task = tasks + first + idx;
+        task->skey = NULL;
+        memset( sum[idx], 0, sizeof( sum[idx] ));
+        if(( task->id == NULL ) || ( !task->id_size )) {
+          task->error = ak_error_message( ak_error_undefined_value, __func__,
+                                                          "using undefined abonent's identifier" );
+          continue;
+        }
+        if(( task->key != NULL ) && ( task->key_size < bkey->count )) {
+          task->error = ak_error_message( ak_error_wrong_length, __func__,
+                                           "insufficient memory size for storing a pairwise key" );
+          continue;
+        }
+        if(( task->error = ak_hash_ptr( &bkey->ctx, task->id, task->id_size,
+                                                          value, bkey->count )) != ak_error_ok ) {
+          ak_error_message( task->error, __func__, "incorrect evauation of initial hash value" );
+          continue;
+        }
+        if(( task->error = ak_gf2n_table_create( tab+idx, value,
+                                                             bkey->count, 0 )) != ak_error_ok )
+          ak_error_message( task->error, __func__, "incorrect creation of multiplication table" );
+     }
+
+    /* схема Горнера, выполняемая одновременно для всех заданий блока */
+     for( row = bkey->size - 1; row >= 0; row-- ) {
+        ak_uint64 *element = ( ak_uint64 * )( bkey->data + row*bkey->count );
+        for( idx = 0; idx < len; idx++ ) {
+           if( tasks[first+idx].error != ak_error_ok ) continue;
+           ak_gf2n_table_mul( tab+idx, sum[idx], sum[idx] );
+           for( i = 0; i < ( bkey->count >> 3 ); i++ ) sum[idx][i] ^= element[i];
+        }
+     }
+
+    /* размещаем результаты */
+     for( idx = 0; idx < len; idx++ ) {
+        ak_blomkey_pairwise_task task = tasks + first + idx;
+        if( task->error != ak_error_ok ) continue;
+        if( task->key != NULL ) memcpy( task->key, sum[idx], bkey->count );
+        if( oid == NULL ) continue;
+        if(( task->skey = ak_oid_new_object( oid )) == NULL ) {
+          task->error = ak_error_message( ak_error_get_value(), __func__,
+                                                             "wrong generation of pairwise key" );
+          continue;
+        }
+        if(( task->error = oid->func.first.set_key( task->skey, sum[idx],
+                     ak_min( bkey->count, ((ak_skey)task->skey)->key_size ))) != ak_error_ok ) {
+          ak_error_message( task->error, __func__, "incorrect assigning of pairwise key value" );
+          ak_oid_delete_object( oid, task->skey );
+          task->skey = NULL;
+        }
+     }
+  }
+
+  if( ak_random_create_lcg( &generator ) == ak_error_ok ) {
+    ak_ptr_wipe( sum, sizeof( sum ), &generator );
+    ak_random_destroy( &generator );
+  }
+  free( tab );
+
+  for( idx = 0; idx < count; idx++ )
+     if(( error = tasks[idx].error ) != ak_error_ok ) break;
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Поскольку мастер-ключ хранится в виде верхнетреугольной части симметричной матрицы,
+    для элементов, расположенных ниже главной диагонали, функция возвращает указатель на
+    симметричный им элемент.
+
+    \param bkey указатель на контекст мастер-ключа или ключа абонента
     \param row номер строки
     \param column номер столбца; для ключей абонентов данное значение не учитывается.
     \return В случае успеха, функция возвращает указатель на область памяти, содержащей
@@ -350,7 +726,10 @@
     return NULL;
   }
   switch( bkey->type ) {
-   case blom_matrix_key: return bkey->data + (bkey->size*row + column)*bkey->count;
+   case blom_matrix_key:
+     if( row > column ) return bkey->data +
+                         ( ak_blomkey_row_offset( bkey->size, column ) + row - column )*bkey->count;
+     return bkey->data + ( ak_blomkey_row_offset( bkey->size, row ) + column - row )*bkey->count;
    case blom_abonent_key: return bkey->data + row*bkey->count;
    default:
      ak_error_message_fmt( ak_error_undefined_value, __func__ ,
@@ -373,8 +752,7 @@
   if( bkey->data != NULL ) {
     ak_random_create_lcg( &generator );
     ak_ptr_wipe( bkey->data, /* очищаем либо матрицу, либо строку */
-       bkey->type == blom_matrix_key ?
-                (bkey->size)*(bkey->size)*(bkey->count) : (bkey->size)*(bkey->count), &generator );
+                                                     ak_blomkey_get_memsize( bkey ), &generator );
     ak_random_destroy( &generator );
     free( bkey->data );
   }
@@ -453,7 +831,7 @@
   iv[15] = bkey->size&0xFF;
   ak_random_destroy( &generator );
 
- /* вычисляем размер ключевых данных */
+ /* вычисляем размер ключевых данных (ресурс ключей определяется размером полной матрицы) */
   if( bkey->type == blom_matrix_key ) memsize = (bkey->size)*(bkey->size)*(bkey->count);
    else memsize = (bkey->size)*(bkey->count);
   if( memsize%16 != 0 ) return ak_error_message( ak_error_wrong_key_length, __func__,
@@ -468,10 +846,11 @@
 
  /* вычисляем контрольную сумму, которая будет сохранена в файл */
   ikey.key.resource.value.counter = blocks + 1;
-  ak_bckey_cmac_clean( &ikey );
-  ak_bckey_cmac_update( &ikey, iv, 16 );
-  if( blocks > 1 ) ak_bckey_cmac_update( &ikey, bkey->data, memsize - 16 );
-  ak_bckey_cmac_finalize( &ikey, bkey->data + memsize - 16, 16, bkey->data + memsize, 16 );
+  if(( error = ak_blomkey_get_cmac( bkey, &ikey, iv,
+                            bkey->data + ak_blomkey_get_memsize( bkey ))) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect calculation of control sum" );
+    goto labex;
+  }
 
  /* создаем имя файла и сохраняем данные */
   if(( error = ak_skey_generate_file_name_from_buffer( iv, 8,
@@ -493,15 +872,15 @@
  /* сохраняем данные в оптимальном виде */
   ekey.key.resource.value.counter = blocks + 1;
   switch( bkey->type ) {
-   case blom_matrix_key:                   /* сохраняем только существенные данные, т.е. */
-    /* фактически, мы сохраняем верхнетреугольную матрицу, отбрасывая симметричную часть */
+   case blom_matrix_key:     /* сохраняем верхнетреугольную матрицу, в виде которой ключ */
+    /* хранится в памяти; шифрование выполняется построчно для совместимости формата файла */
      for( i = 0; i < bkey->size; i++ ) {
         memsize = ( bkey->size - i )*bkey->count;
         if( i == ( bkey->size - 1 )) memsize += 16; /* добавляем контрольную сумму */
 
         ltail = ( memsize )%sizeof( buffer );
         lblocks = ( memsize - ltail )/sizeof( buffer );
-        ptr = bkey->data + i*bkey->count*(bkey->size + 1);
+        ptr = bkey->data + ak_blomkey_row_offset( bkey->size, i )*bkey->count;
 
         for( j = 0; j < lblocks; j++ ) {
            ak_bckey_ctr( &ekey, ptr, buffer, sizeof( buffer ), j == 0 ? iv : NULL, 8 );
@@ -621,7 +1000,7 @@
     goto labex;
   }
 
- /* вычисляем размер ключевых данных */
+ /* вычисляем размер ключевых данных (ресурс ключей определяется размером полной матрицы) */
   if( bkey->type == blom_matrix_key ) memsize = (bkey->size)*(bkey->size)*(bkey->count);
    else memsize = (bkey->size)*(bkey->count);
   if( memsize%16 != 0 ) {
@@ -633,11 +1012,11 @@
     ak_error_message( error = ak_error_wrong_key_length, __func__, "using short secret key" );
     goto labex;
   }
-  if(( bkey->data = malloc( memsize + 16 )) == NULL ) { /* 16 это размер имитовставки */
+  if(( bkey->data = malloc( ak_blomkey_get_memsize( bkey ) + 16 )) == NULL ) {
     ak_error_message( error = ak_error_out_of_memory, __func__, "incorrect memory allocation" );
     goto labex;
   }
-  memset( bkey->data, 0, memsize + 16 );
+  memset( bkey->data, 0, ak_blomkey_get_memsize( bkey ) + 16 ); /* 16 это размер имитовставки */
 
  /* вычисляем ключи */
   iter = ( iv[8] << 8 ) + iv[9];
@@ -650,16 +1029,12 @@
  /* считываем данные */
   ekey.key.resource.value.counter = blocks + 1;
   switch( bkey->type ) {
-   case blom_matrix_key: /* считываем верхнетреугольную матрицу и разворачиваем ее */
+   case blom_matrix_key: /* считываем верхнетреугольную матрицу */
      for( i = 0; i < bkey->size; i++ ) {
-       /* копируем созданное ранее */
-        for( j = 0; j < i; j++ ) memcpy( bkey->data + i*bkey->count*bkey->size+j*bkey->count,
-                                      ak_blomkey_get_element_by_index( bkey, j, i ), bkey->count );
-       /* создаем новое */
         iter = ( bkey->size - i )*bkey->count;
         if( i == ( bkey->size - 1 )) iter += 16; /* добавляем контрольную сумму */
 
-        ptr = bkey->data + i*bkey->count*(bkey->size + 1);
+        ptr = bkey->data + ak_blomkey_row_offset( bkey->size, i )*bkey->count;
         ltail = iter%sizeof( buffer );
         lblocks = ( iter - ltail )/sizeof( buffer );
 
@@ -714,12 +1089,12 @@
 
  /* вычисляем и проверяем значение имитовставки  */
   ikey.key.resource.value.counter = blocks + 1;
-  ak_bckey_cmac_clean( &ikey );
-  ak_bckey_cmac_update( &ikey, iv, 16 );
-  if( blocks > 1 ) ak_bckey_cmac_update( &ikey, bkey->data, memsize - 16 );
-  ak_bckey_cmac_finalize( &ikey, bkey->data + memsize - 16, 16, iv, 16 );
+  if(( error = ak_blomkey_get_cmac( bkey, &ikey, iv, iv )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect calculation of control sum" );
+    goto labex1;
+  }
 
-  if( !ak_ptr_is_equal( bkey->data + memsize, iv, 16 )) {
+  if( !ak_ptr_is_equal( bkey->data + ak_blomkey_get_memsize( bkey ), iv, 16 )) {
     ak_error_message( error = ak_error_not_equal_data, __func__,
                                     "incorrect value of control sum, may be wrong password ... " );
     goto labex1;
@@ -739,7 +1114,7 @@
     ak_error_message( error, __func__, "incorrect creation of hash function context" );
     goto labex1;
   }
-  if(( error = ak_hash_ptr( &bkey->ctx, bkey->data, memsize, bkey->icode, 32 )) != ak_error_ok ) {
+  if(( error = ak_blomkey_get_icode( bkey, bkey->icode )) != ak_error_ok ) {
     ak_error_message( error,  __func__ , "incorrect calculation of control sum" );
     ak_hash_destroy( &bkey->ctx );
   }
@@ -4,7 +4,7 @@
 /*  Файл ak_curves.с                                                                               */
 /*  - содержит реализацию функций для работы с эллиптическими кривыми.                             */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_STRING_H
@@ -15,6 +15,9 @@
 #ifdef AK_HAVE_STRINGS_H
  #include <strings.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет величину \f$\Delta \equiv -16(4a^3 + 27b^2) \pmod{p} \f$, зависящую
@@ -30,27 +33,27 @@
  /* определяем константы 4 и 27 в представлении Монтгомери */
   ak_mpzn_set_ui( d, ec->size, 4 );
   ak_mpzn_set_ui( s, ak_mpznmax_size, 27 );
-  ak_mpzn_mul_montgomery( d, d, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->r2, ec->p, ec->n, ec->size );
 
  /* вычисляем 4a^3 (mod p) значение в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
 
  /* вычисляем значение 4a^3 + 27b^2 (mod p) в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->b, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->b, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( d, d, s, ec->p, ec->size );
 
  /* определяем константу -16 в представлении Монтгомери и вычисляем D = -16(4a^3+27b^2) (mod p) */
   ak_mpzn_set_ui( s, ec->size, 16 );
   ak_mpzn_sub( s, ec->p, s, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( d, d, s, ec->p, ec->n, ec->size );
 
  /* возвращаем результат (в обычном представлении) */
-  ak_mpzn_mul_montgomery( d, d, one, ec->p, ec->n, ec->size );
+  ec->mul( d, d, one, ec->p, ec->n, ec->size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -71,9 +74,44 @@
 }
 
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \equiv xr \pmod{q} \f$, \f$ 0 \leq z < q \f$, т.е. приводит
+    значение \f$ x \f$ по модулю \f$ q \f$ и сразу переводит его в представление Монтгомери.
+    Для этого выполняется одно умножение на \f$ r^2 \pmod{q} \f$: поскольку
+    \f$ x < r \f$ и \f$ r^2 \pmod{q} < q \f$, результат умножения Монтгомери всегда полностью
+    приведен по модулю \f$ q \f$. В отличие от функции ak_mpzn_rem(), функция не накладывает
+    ограничений на старшее слово модуля и время ее работы не зависит от значения \f$ x \f$.
+
+    @param z Вычет, в который помещается результат
+    @param x Произвольное значение длины `ec->size` слов.
+    @param ec Контекст эллиптической кривой.                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_rem_q_montgomery( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  ec->mulq( z, x, ec->r2q, ec->q, ec->nq, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \equiv x \pmod{q} \f$, \f$ 0 \leq z < q \f$, с помощью двух
+    умножений Монтгомери (см. ak_wcurve_rem_q_montgomery()).
+
+    @param z Вычет, в который помещается результат
+    @param x Произвольное значение длины `ec->size` слов.
+    @param ec Контекст эллиптической кривой.                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_rem_q( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  ak_mpzn512 one = ak_mpzn512_one;
+
+  ec->mulq( z, x, ec->r2q, ec->q, ec->nq, ec->size );
+  ec->mulq( z, z, one, ec->q, ec->nq, ec->size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для проведения проверки функция вырабатывает случайное число \f$ t \pmod{q} \f$ и проверяет
-    выполнимость равенства \f$ t \cdot t^{-1} \equiv 1 \pmod{q}\f$.
+    выполнимость равенства \f$ t \cdot t^{-1} \equiv 1 \pmod{q}\f$, где обратный элемент
+    вычисляется с помощью малой теоремы Ферма. Кроме того, проверяется, что специализированная
+    функция умножения по модулю \f$ q \f$ совпадает с функцией ak_mpzn_mul_montgomery().
 
     @param ec Контекст эллиптической кривой.
 
@@ -85,19 +123,28 @@
   ak_mpzn512 r, s, t;
   struct random generator;
 
+  if( ec->mulq == NULL ) return ak_error_curve_order_parameters;
+
   ak_random_create_lcg( &generator );
   ak_mpzn_set_random( t, ec->size, &generator );
-  ak_mpzn_rem( t, t, ec->q, ec->size );
+  ak_mpzn_set_random( r, ec->size, &generator );
   ak_random_destroy( &generator );
 
+ /* сравниваем специализированное и общее умножение (t может быть больше q) */
+  ak_wcurve_rem_q( r, r, ec );
+  ec->mulq( s, t, r, ec->q, ec->nq, ec->size );
+  ak_mpzn_mul_montgomery( r, t, r, ec->q, ec->nq, ec->size );
+  if( ak_mpzn_cmp( r, s, ec->size )) return ak_error_curve_order_parameters;
+
+  ak_wcurve_rem_q( t, t, ec );
   ak_mpzn_set_ui( r, ec->size, 2 );
   ak_mpzn_sub( r, ec->q, r, ec->size );
-  ak_mpzn_modpow_montgomery( s, t, r, ec->q, ec->nq, ec->size );
-  ak_mpzn_mul_montgomery( t, s, t, ec->q, ec->nq, ec->size );
+  ak_mpzn_modpow_montgomery_vartime( s, t, r, ec->q, ec->nq, ec->size );
+  ec->mulq( t, s, t, ec->q, ec->nq, ec->size );
 
-  ak_mpzn_mul_montgomery( t, t, ec->r2q, ec->q, ec->nq, ec->size );
-  ak_mpzn_mul_montgomery( t, t, ec->point.z, ec->q, ec->nq, ec->size );
-  ak_mpzn_mul_montgomery( t, t, ec->point.z, ec->q, ec->nq, ec->size );
+  ec->mulq( t, t, ec->r2q, ec->q, ec->nq, ec->size );
+  ec->mulq( t, t, ec->point.z, ec->q, ec->nq, ec->size );
+  ec->mulq( t, t, ec->point.z, ec->q, ec->nq, ec->size );
   if( ak_mpzn_cmp_ui( t, ec->size, 1 )) return ak_error_ok;
    else return ak_error_curve_order_parameters;
 }
@@ -182,10 +229,10 @@
   if( oid != NULL ) {
     ak_error_message_fmt( error, __func__, "elliptic curve: %s (oid: %s)",
                                                                        oid->name[0], oid->id[0] );
-    ak_mpzn_mul_montgomery( tmp, ec->a, one, ec->p, ec->n, ec->size );
+    ec->mul( tmp, ec->a, one, ec->p, ec->n, ec->size );
     ak_error_message_fmt( error, __func__, " a = %s",
                                      str = ak_mpzn_to_hexstr_alloc( tmp, ec->size )); free( str );
-    ak_mpzn_mul_montgomery( tmp, ec->b, one, ec->p, ec->n, ec->size );
+    ec->mul( tmp, ec->b, one, ec->p, ec->n, ec->size );
     ak_error_message_fmt( error, __func__, " b = %s",
                                      str = ak_mpzn_to_hexstr_alloc( tmp, ec->size )); free( str );
     ak_error_message_fmt( error, __func__, " b = %s",
@@ -235,9 +282,9 @@
 
   fprintf( fp, "\nparameters:\n");
 
-  ak_mpzn_mul_montgomery( tmp, ec->a, one, ec->p, ec->n, ec->size );
+  ec->mul( tmp, ec->a, one, ec->p, ec->n, ec->size );
   fprintf( fp, "  a =  0x%s\n", ak_mpzn_to_hexstr( tmp, ec->size ));
-  ak_mpzn_mul_montgomery( tmp, ec->b, one, ec->p, ec->n, ec->size );
+  ec->mul( tmp, ec->b, one, ec->p, ec->n, ec->size );
   fprintf( fp, "  b =  0x%s\n", ak_mpzn_to_hexstr( tmp, ec->size ));
 
   fprintf( fp, "  p =  0x%s\n", ak_mpzn_to_hexstr( ec->p, ec->size ));
@@ -250,6 +297,362 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сравнивает результаты специализированных функций умножения и возведения
+    в квадрат, заданных в параметрах кривой, с результатами функции ak_mpzn_mul_montgomery().      */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_test_arithmetic( ak_wcurve wc )
+{
+  size_t i = 0, j = 0;
+  ak_mpznmax x, y, z, w;
+
+  if(( wc->mul == NULL ) || ( wc->sqr == NULL )) return ak_false;
+  ak_mpzn_set( y, wc->p, wc->size );
+  y[0]--;
+  for( i = 0; i < 4; i++ ) {
+     switch( i ) {
+       case 0: /* x = p-1 */
+         ak_mpzn_set( x, wc->p, wc->size );
+         x[0]--;
+         break;
+       case 1: /* x = 1 */
+         ak_mpzn_set_ui( x, wc->size, 1 );
+         break;
+       default:
+         for( j = 0; j < wc->size; j++ ) x[j] = 0x9e3779b97f4a7c15LL*( i+j+1 );
+         ak_mpzn_rem( x, x, wc->p, wc->size );
+     }
+     ak_mpzn_mul_montgomery( z, x, y, wc->p, wc->n, wc->size );
+     wc->mul( w, x, y, wc->p, wc->n, wc->size );
+     if( ak_mpzn_cmp( z, w, wc->size )) return ak_false;
+
+     ak_mpzn_mul_montgomery( z, x, x, wc->p, wc->n, wc->size );
+     wc->sqr( w, x, wc->p, wc->n, wc->size );
+     if( ak_mpzn_cmp( z, w, wc->size )) return ak_false;
+     ak_mpzn_set( y, z, wc->size );
+  }
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет вычисление обратных элементов по модулям \f$ p \f$ и \f$ q \f$,
+    сравнивая произведение вычета на обратный к нему с единицей.                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_test_inverse( ak_wcurve wc )
+{
+  size_t i = 0, j = 0, m = 0;
+  ak_mpznmax x, y, z;
+  ak_uint64 *mod, *r2, n0;
+
+  for( m = 0; m < 2; m++ ) {
+     mod = m ? wc->q : wc->p;
+     r2 = m ? wc->r2q : wc->r2;
+     n0 = m ? wc->nq : wc->n;
+     for( i = 0; i < 3; i++ ) {
+        switch( i ) {
+          case 0: /* x = 1 */
+            ak_mpzn_set_ui( x, wc->size, 1 );
+            break;
+          case 1: /* x = m-1 */
+            ak_mpzn_set( x, mod, wc->size );
+            x[0]--;
+            break;
+          default:
+            for( j = 0; j < wc->size; j++ ) x[j] = 0x9e3779b97f4a7c15LL*( j+1 );
+            ak_mpzn_rem( x, x, mod, wc->size );
+        }
+        ak_mpzn_modinv( y, x, mod, wc->size );
+        ak_mpzn_modinv_vartime( z, x, mod, wc->size );
+        if( ak_mpzn_cmp( y, z, wc->size )) return ak_false;
+
+       /* x*y*r^{-1}*r^2*r^{-1} = 1 */
+        ak_mpzn_mul_montgomery( y, y, x, mod, n0, wc->size );
+        ak_mpzn_mul_montgomery( y, y, r2, mod, n0, wc->size );
+        if( !ak_mpzn_cmp_ui( y, wc->size, 1 )) return ak_false;
+     }
+  }
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет признак \f$ a \equiv -3 \pmod{p} \f$, заданный в параметрах кривой,
+    и сравнивает кратную точку, вычисленную в координатах Якоби функцией ak_wpoint_pow(),
+    с кратной точкой, вычисленной с помощью сложений и удвоений в проективных координатах.        */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_test_jacobian( ak_wcurve wc )
+{
+  long long int i = 0;
+  ak_mpznmax t, k;
+  struct wpoint wp, wq;
+
+ /* t <- a + 3 в представлении Монтгомери */
+  ak_mpzn_set_ui( t, wc->size, 3 );
+  wc->mul( t, t, wc->r2, wc->p, wc->n, wc->size );
+  ak_mpzn_add_montgomery( t, t, wc->a, wc->p, wc->size );
+  if( ak_mpzn_cmp_ui( t, wc->size, 0 ) != wc->a_is_minus_three ) return ak_false;
+
+  for( i = 0; i < ( long long int )wc->size; i++ ) k[i] = 0x9e3779b97f4a7c15LL*( i+1 );
+  ak_wpoint_pow( &wp, &wc->point, k, wc->size, wc );
+  ak_wpoint_reduce( &wp, wc );
+
+  ak_wpoint_set_as_unit( &wq, wc );
+  for( i = 64*wc->size-1; i >= 0; i-- ) {
+     ak_wpoint_double( &wq, wc );
+     if(( k[i >> 6] >> ( i&0x3f ))&1 ) ak_wpoint_add( &wq, &wc->point, wc );
+  }
+  ak_wpoint_reduce( &wq, wc );
+  if( ak_mpzn_cmp( wp.x, wq.x, wc->size ) || ak_mpzn_cmp( wp.y, wq.y, wc->size ))
+    return ak_false;
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет согласованность параметров эквивалентной кривой Эдвардса
+    с параметрами кривой в форме Вейерштрасса:
+    \f$ 4s \equiv 1 - d, \ 6t \equiv 1 + d, \ a \equiv s^2 - 3t^2, \ b \equiv 2t^3 - ts^2 \pmod{p} \f$.
+    Для кривых, не имеющих эквивалентной формы Эдвардса, функция возвращает \ref ak_true.        */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_test_edwards( ak_wcurve wc )
+{
+  ak_mpznmax one, u, v, w;
+  ak_uint64 *d = NULL, *s = NULL, *t = NULL;
+
+  if( wc->ecurve == NULL ) return ak_true;
+  d = ( ak_uint64 * )wc->ecurve->d;
+  s = ( ak_uint64 * )wc->ecurve->s;
+  t = ( ak_uint64 * )wc->ecurve->t;
+
+  ak_mpzn_set_ui( one, wc->size, 1 );
+  wc->mul( one, one, wc->r2, wc->p, wc->n, wc->size );
+
+ /* 4s = 1 - d */
+  ak_mpzn_lshift_montgomery( u, s, wc->p, wc->size );
+  ak_mpzn_lshift_montgomery( u, u, wc->p, wc->size );
+  ak_mpzn_sub_montgomery( v, one, d, wc->p, wc->size );
+  if( ak_mpzn_cmp( u, v, wc->size )) return ak_false;
+
+ /* 6t = 1 + d */
+  ak_mpzn_lshift_montgomery( u, t, wc->p, wc->size );
+  ak_mpzn_add_montgomery( v, u, t, wc->p, wc->size );
+  ak_mpzn_lshift_montgomery( v, v, wc->p, wc->size );
+  ak_mpzn_add_montgomery( w, one, d, wc->p, wc->size );
+  if( ak_mpzn_cmp( v, w, wc->size )) return ak_false;
+
+ /* a = s^2 - 3t^2 */
+  wc->sqr( u, s, wc->p, wc->n, wc->size );                     // u = s^2
+  wc->sqr( v, t, wc->p, wc->n, wc->size );                     // v = t^2
+  ak_mpzn_lshift_montgomery( w, v, wc->p, wc->size );
+  ak_mpzn_add_montgomery( w, w, v, wc->p, wc->size );
+  ak_mpzn_sub_montgomery( w, u, w, wc->p, wc->size );
+  if( ak_mpzn_cmp( w, wc->a, wc->size )) return ak_false;
+
+ /* b = t(2t^2 - s^2) */
+  ak_mpzn_lshift_montgomery( w, v, wc->p, wc->size );
+  ak_mpzn_sub_montgomery( w, w, u, wc->p, wc->size );
+  wc->mul( w, w, t, wc->p, wc->n, wc->size );
+  if( ak_mpzn_cmp( w, wc->b, wc->size )) return ak_false;
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сравнивает кратные точки, вычисленные с помощью таблицы кратных точек
+    или представления wNAF, с кратными точками, вычисленными с помощью лесенки Монтгомери.       */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_test_fixed_base( ak_wcurve wc )
+{
+  size_t i = 0, j = 0;
+  struct wpoint wp, wq, wr;
+  ak_mpznmax k, t;
+
+  for( i = 0; i < 3; i++ ) {
+     switch( i ) {
+       case 0: /* k = q-1 */
+         ak_mpzn_set( k, wc->q, wc->size );
+         k[0]--;
+         break;
+       case 1: /* k содержит нулевые окна */
+         for( j = 0; j < wc->size; j++ ) k[j] = 0xf00f0000ff000a01LL;
+         break;
+       default: /* k = 1 */
+         ak_mpzn_set_ui( k, wc->size, 1 );
+     }
+     ak_wpoint_pow( &wp, &wc->point, k, wc->size, wc );
+     ak_wpoint_reduce( &wp, wc );
+     ak_wpoint_pow_base( &wq, k, wc->size, wc );
+     ak_wpoint_reduce( &wq, wc );
+     if( ak_mpzn_cmp( wp.x, wq.x, wc->size ) || ak_mpzn_cmp( wp.y, wq.y, wc->size ))
+       return ak_false;
+
+    /* лесенка в co-Z координатах (для k = 1 и k = q-1 используется ak_wpoint_pow()) */
+     ak_mpzn_rem( t, k, wc->q, wc->size );
+     ak_wpoint_pow_coz( &wq, &wc->point, t, wc );
+     ak_wpoint_reduce( &wq, wc );
+     if( ak_mpzn_cmp( wp.x, wq.x, wc->size ) || ak_mpzn_cmp( wp.y, wq.y, wc->size ))
+       return ak_false;
+
+    /* [k]P + [k]([k]P) = [k+k^2]P */
+     ak_wpoint_double_pow( &wq, k, &wp, k, wc->size, wc );
+     ak_wpoint_reduce( &wq, wc );
+     ak_wpoint_pow( &wr, &wp, k, wc->size, wc );
+     ak_wpoint_add( &wr, &wp, wc );
+     ak_wpoint_reduce( &wr, wc );
+     if( ak_mpzn_cmp( wr.x, wq.x, wc->size ) || ak_mpzn_cmp( wr.y, wq.y, wc->size ))
+       return ak_false;
+  }
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_add_complete( ak_wpoint , ak_wpoint , ak_wcurve );
+
+/*! \brief Контрольная сумма последовательности вызовов функций умножения. */
+ static ak_uint64 wcurve_trace = 0;
+/*! \brief Функции умножения, вызовы которых подсчитываются. */
+ static ak_function_mpzn_mul_montgomery *wcurve_trace_mul = NULL;
+ static ak_function_mpzn_sqr_montgomery *wcurve_trace_sqr = NULL;
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wcurve_trace_update( ak_uint64 tag, const void *z, const void *x,
+                                                                                  const void *y )
+{
+  wcurve_trace = ( wcurve_trace ^ tag )*0x100000001b3LL;
+  wcurve_trace = ( wcurve_trace ^ ( ak_uint64 )( size_t )z )*0x100000001b3LL;
+  wcurve_trace = ( wcurve_trace ^ ( ak_uint64 )( size_t )x )*0x100000001b3LL;
+  wcurve_trace = ( wcurve_trace ^ ( ak_uint64 )( size_t )y )*0x100000001b3LL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wcurve_trace_mul( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                            ak_uint64 *p, ak_uint64 n, const size_t size )
+{
+  ak_wcurve_trace_update( 1, z, x, y );
+  wcurve_trace_mul( z, x, y, p, n, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wcurve_trace_sqr( ak_uint64 *z, ak_uint64 *x,
+                                            ak_uint64 *p, ak_uint64 n, const size_t size )
+{
+  ak_wcurve_trace_update( 2, z, x, NULL );
+  wcurve_trace_sqr( z, x, p, n, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет сложение точек по полным формулам для бесконечно удаленной,
+    совпадающих и противоположных точек, а также то, что последовательность умножений,
+    выполняемых функцией ak_wpoint_table_pow() для кривой в форме Вейерштрасса,
+    не зависит от значения скаляра.                                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_test_constant_time( ak_wcurve wc )
+{
+  size_t i = 0, j = 0;
+  bool_t result = ak_false;
+  struct wcurve ec;
+  struct wpoint_table wt;
+  struct wpoint wp, wq, wr, wo;
+  ak_uint64 trace = 0;
+  ak_mpznmax k;
+
+ /* P = [k]P_0, Q = [2k]P_0 */
+  for( j = 0; j < wc->size; j++ ) k[j] = 0x9e3779b97f4a7c15LL*( j+3 );
+  ak_wpoint_pow( &wp, &wc->point, k, wc->size, wc );
+  ak_wpoint_set_wpoint( &wq, &wp, wc );
+  ak_wpoint_double( &wq, wc );
+
+ /* O + P = P, P + O = P */
+  ak_wpoint_set_wpoint( &wo, &wp, wc );
+  ak_wpoint_reduce( &wo, wc );
+  for( i = 0; i < 2; i++ ) {
+     ak_wpoint_set_as_unit( &wr, wc );
+     if( i ) ak_wpoint_add_complete( &wr, &wp, wc );
+      else {
+        struct wpoint wu;
+        ak_wpoint_set_as_unit( &wu, wc );
+        ak_wpoint_set_wpoint( &wr, &wp, wc );
+        ak_wpoint_add_complete( &wr, &wu, wc );
+      }
+     ak_wpoint_reduce( &wr, wc );
+     if( ak_mpzn_cmp( wr.x, wo.x, wc->size ) || ak_mpzn_cmp( wr.y, wo.y, wc->size ))
+       return ak_false;
+  }
+
+ /* P + P = [2]P */
+  ak_wpoint_set_wpoint( &wr, &wp, wc );
+  ak_wpoint_add_complete( &wr, &wp, wc );
+  ak_wpoint_reduce( &wr, wc );
+  ak_wpoint_set_wpoint( &wo, &wq, wc );
+  ak_wpoint_reduce( &wo, wc );
+  if( ak_mpzn_cmp( wr.x, wo.x, wc->size ) || ak_mpzn_cmp( wr.y, wo.y, wc->size ))
+    return ak_false;
+
+ /* P + [2]P = [3]P */
+  ak_wpoint_set_wpoint( &wr, &wp, wc );
+  ak_wpoint_add_complete( &wr, &wq, wc );
+  ak_wpoint_reduce( &wr, wc );
+  ak_wpoint_set_wpoint( &wo, &wq, wc );
+  ak_wpoint_add( &wo, &wp, wc );
+  ak_wpoint_reduce( &wo, wc );
+  if( ak_mpzn_cmp( wr.x, wo.x, wc->size ) || ak_mpzn_cmp( wr.y, wo.y, wc->size ))
+    return ak_false;
+
+ /* P + (-P) = O */
+  ak_wpoint_set_wpoint( &wr, &wp, wc );
+  ak_mpzn_sub( wr.y, wc->p, wr.y, wc->size );
+  ak_wpoint_add_complete( &wr, &wp, wc );
+  if( !ak_mpzn_cmp_ui( wr.z, wc->size, 0 )) return ak_false;
+
+ /* последовательность умножений при вычислении кратной точки с помощью таблицы;
+    копия кривой не использует форму Эдвардса, а ее функции умножения подсчитывают вызовы */
+  ec = *wc;
+  ec.ecurve = NULL;
+  if( ak_wpoint_table_create( &wt, &wc->point, &ec ) != ak_error_ok ) return ak_false;
+  wcurve_trace_mul = wc->mul;
+  wcurve_trace_sqr = wc->sqr;
+  ec.mul = ak_wcurve_trace_mul;
+  ec.sqr = ak_wcurve_trace_sqr;
+
+  for( i = 0; i < 5; i++ ) {
+     switch( i ) {
+       case 0: /* k = 0 */
+         ak_mpzn_set_ui( k, wc->size, 0 );
+         break;
+       case 1: /* k = 1 */
+         ak_mpzn_set_ui( k, wc->size, 1 );
+         break;
+       case 2: /* k = q-1 */
+         ak_mpzn_set( k, wc->q, wc->size );
+         k[0]--;
+         break;
+       case 3: /* все единицы */
+         for( j = 0; j < wc->size; j++ ) k[j] = 0xffffffffffffffffLL;
+         break;
+       default: /* k содержит нулевые окна */
+         for( j = 0; j < wc->size; j++ ) k[j] = 0xf00f0000ff000a01LL;
+     }
+     wcurve_trace = 0xcbf29ce484222325LL;
+     ak_wpoint_table_pow( &wr, &wt, k, wc->size, &ec );
+     if( i == 0 ) trace = wcurve_trace;
+      else if( trace != wcurve_trace ) goto labex;
+
+    /* результат совпадает с вычисленным лесенкой Монтгомери */
+     ak_wpoint_reduce( &wr, wc );
+     ak_wpoint_pow( &wo, &wc->point, k, wc->size, wc );
+     ak_wpoint_reduce( &wo, wc );
+     if( ak_mpzn_cmp( wr.x, wo.x, wc->size ) || ak_mpzn_cmp( wr.y, wo.y, wc->size ) ||
+         ak_mpzn_cmp( wr.z, wo.z, wc->size )) goto labex;
+  }
+  result = ak_true;
+
+ labex:
+  ak_wpoint_table_destroy( &wt );
+ return result;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Проверяются параметры всех эллиптических кривых, доступных через механизм OID.
     Проверка производится путем вызова функции ak_wcurve_is_ok().
@@ -295,6 +698,42 @@
                                                            oid->name[0], oid->id[0], p );
         result = ak_false;
         goto lab_exit;
+      }
+      if( !ak_wcurve_test_arithmetic( wc )) {
+        ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+             "curve %s (OID: %s) has wrong field multiplication", oid->name[0], oid->id[0] );
+        result = ak_false;
+        goto lab_exit;
+      }
+      if( !ak_wcurve_test_inverse( wc )) {
+        ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                "curve %s (OID: %s) has wrong modular inversion", oid->name[0], oid->id[0] );
+        result = ak_false;
+        goto lab_exit;
+      }
+      if( !ak_wcurve_test_jacobian( wc )) {
+        ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                "curve %s (OID: %s) has wrong Jacobian arithmetic", oid->name[0], oid->id[0] );
+        result = ak_false;
+        goto lab_exit;
+      }
+      if( !ak_wcurve_test_edwards( wc )) {
+        ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+             "curve %s (OID: %s) has wrong twisted Edwards form", oid->name[0], oid->id[0] );
+        result = ak_false;
+        goto lab_exit;
+      }
+      if( !ak_wcurve_test_fixed_base( wc )) {
+        ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+           "curve %s (OID: %s) has wrong fast point multiplication", oid->name[0], oid->id[0] );
+        result = ak_false;
+        goto lab_exit;
+      }
+      if( !ak_wcurve_test_constant_time( wc )) {
+        ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+          "curve %s (OID: %s) has wrong constant time multiplication", oid->name[0], oid->id[0] );
+        result = ak_false;
+        goto lab_exit;
       } else
           if( audit > ak_log_standard ) {
             ak_error_message_fmt( ak_error_ok, __func__ , "curve %s (OID: %s) is Ok",
@@ -393,23 +832,23 @@
 
  /* Проверяем принадлежность точки заданной кривой */
   ak_mpzn_set( t, ec->a, ec->size );
-  ak_mpzn_mul_montgomery( t, t, wp->x, ec->p, ec->n, ec->size );
+  ec->mul( t, t, wp->x, ec->p, ec->n, ec->size );
   ak_mpzn_set( s, ec->b, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->z, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина (ax+bz)
 
   ak_mpzn_set( s, wp->z, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
+  ec->sqr( s, s, ec->p, ec->n, ec->size );
+  ec->mul( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
 
   ak_mpzn_set( s, wp->x, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->x, ec->p, ec->n, ec->size );
+  ec->sqr( s, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->x, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина x^3 + (ax+bz)z^2
 
   ak_mpzn_set( s, wp->y, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
+  ec->sqr( s, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
 
   if( ak_mpzn_cmp( t, s, ec->size )) return ak_false;
  return ak_true;
@@ -451,30 +890,30 @@
    return;
  }
  // dbl-2007-bl
- ak_mpzn_mul_montgomery( u1, wp->x, wp->x, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u2, wp->z, wp->z, ec->p, ec->n, ec->size );
+ ec->sqr( u1, wp->x, ec->p, ec->n, ec->size );
+ ec->sqr( u2, wp->z, ec->p, ec->n, ec->size );
  ak_mpzn_lshift_montgomery( u4, u1, ec->p, ec->size );
  ak_mpzn_add_montgomery( u4, u4, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( u3, u2, ec->a, ec->p, ec->n, ec->size );
+ ec->mul( u3, u2, ec->a, ec->p, ec->n, ec->size );
  ak_mpzn_add_montgomery( u3, u3, u4, ec->p, ec->size );  // u3 = az^2 + 3x^2
- ak_mpzn_mul_montgomery( u4, wp->y, wp->z, ec->p, ec->n, ec->size );
+ ec->mul( u4, wp->y, wp->z, ec->p, ec->n, ec->size );
  ak_mpzn_lshift_montgomery( u4, u4, ec->p, ec->size );   // u4 = 2yz
- ak_mpzn_mul_montgomery( u5, wp->y, u4, ec->p, ec->n, ec->size ); // u5 = 2y^2z
+ ec->mul( u5, wp->y, u4, ec->p, ec->n, ec->size ); // u5 = 2y^2z
  ak_mpzn_lshift_montgomery( u6, u5, ec->p, ec->size ); // u6 = 2u5
- ak_mpzn_mul_montgomery( u7, u6, wp->x, ec->p, ec->n, ec->size ); // u7 = 8xy^2z
+ ec->mul( u7, u6, wp->x, ec->p, ec->n, ec->size ); // u7 = 8xy^2z
  ak_mpzn_lshift_montgomery( u1, u7, ec->p, ec->size );
  ak_mpzn_sub( u1, ec->p, u1, ec->size );
- ak_mpzn_mul_montgomery( u2, u3, u3, ec->p, ec->n, ec->size );
+ ec->sqr( u2, u3, ec->p, ec->n, ec->size );
  ak_mpzn_add_montgomery( u2, u2, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->x, u2, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u6, u6, u5, ec->p, ec->n, ec->size );
+ ec->mul( wp->x, u2, u4, ec->p, ec->n, ec->size );
+ ec->mul( u6, u6, u5, ec->p, ec->n, ec->size );
  ak_mpzn_sub( u6, ec->p, u6, ec->size );
  ak_mpzn_sub( u2, ec->p, u2, ec->size );
  ak_mpzn_add_montgomery( u2, u2, u7, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->y, u2, u3, ec->p, ec->n, ec->size );
+ ec->mul( wp->y, u2, u3, ec->p, ec->n, ec->size );
  ak_mpzn_add_montgomery( wp->y, wp->y, u6, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->z, u4, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->z, wp->z, u4, ec->p, ec->n, ec->size );
+ ec->sqr( wp->z, u4, ec->p, ec->n, ec->size );
+ ec->mul( wp->z, wp->z, u4, ec->p, ec->n, ec->size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -522,11 +961,11 @@
   }
   // поскольку удвоение точки с помощью формул сложения дает бесконечно удаленную точку,
   // необходимо выполнить проверку
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp2->x, wp1->z, ec->p, ec->n, ec->size );
+  ec->mul( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u2, wp2->x, wp1->z, ec->p, ec->n, ec->size );
   if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) { // случай совпадения х-координат точки
-    ak_mpzn_mul_montgomery( u1, wp1->y, wp2->z, ec->p, ec->n, ec->size );
-    ak_mpzn_mul_montgomery( u2, wp2->y, wp1->z, ec->p, ec->n, ec->size );
+    ec->mul( u1, wp1->y, wp2->z, ec->p, ec->n, ec->size );
+    ec->mul( u2, wp2->y, wp1->z, ec->p, ec->n, ec->size );
     if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) // случай полного совпадения точек
       ak_wpoint_double( wp1, ec );
      else ak_wpoint_set_as_unit( wp1, ec );
@@ -534,31 +973,31 @@
   }
 
   //add-1998-cmo-2
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp1->y, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u2, wp1->y, wp2->z, ec->p, ec->n, ec->size );
   ak_mpzn_sub( u2, ec->p, u2, ec->size );
-  ak_mpzn_mul_montgomery( u3, wp1->z, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u4, wp2->y, wp1->z, ec->p, ec->n, ec->size );
+  ec->mul( u3, wp1->z, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u4, wp2->y, wp1->z, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( u4, u4, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u5, u4, u4, ec->p, ec->n, ec->size );
+  ec->sqr( u5, u4, ec->p, ec->n, ec->size );
   ak_mpzn_sub( u7, ec->p, u1, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp2->x, wp1->z, ec->p, ec->n, ec->size );
+  ec->mul( wp1->x, wp2->x, wp1->z, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( wp1->x, wp1->x, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u7, wp1->x, wp1->x, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u6, u7, wp1->x, ec->p, ec->n, ec->size);
-  ak_mpzn_mul_montgomery( u1, u7, u1, ec->p, ec->n, ec->size );
+  ec->sqr( u7, wp1->x, ec->p, ec->n, ec->size );
+  ec->mul( u6, u7, wp1->x, ec->p, ec->n, ec->size );
+  ec->mul( u1, u7, u1, ec->p, ec->n, ec->size );
   ak_mpzn_lshift_montgomery( u7, u1, ec->p, ec->size );
   ak_mpzn_add_montgomery( u7, u7, u6, ec->p, ec->size );
   ak_mpzn_sub( u7, ec->p, u7, ec->size );
-  ak_mpzn_mul_montgomery( u5, u5, u3, ec->p, ec->n, ec->size );
+  ec->mul( u5, u5, u3, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( u5, u5, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp1->x, u5, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, u2, u6, ec->p, ec->n, ec->size );
+  ec->mul( wp1->x, wp1->x, u5, ec->p, ec->n, ec->size );
+  ec->mul( u2, u2, u6, ec->p, ec->n, ec->size );
   ak_mpzn_sub( u5, ec->p, u5, ec->size );
   ak_mpzn_add_montgomery( u1, u1, u5, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->y, u4, u1, ec->p, ec->n, ec->size );
+  ec->mul( wp1->y, u4, u1, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( wp1->y, wp1->y, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->z, u6, u3, ec->p, ec->n, ec->size );
+  ec->mul( wp1->z, u6, u3, ec->p, ec->n, ec->size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -566,34 +1005,640 @@
     задаваемое следующим вектором \f$ P = \left( \frac{x}{z} \pmod{p}, \frac{y}{z} \pmod{p}, 1\right) \f$,
     где \f$ p \f$ модуль эллиптической кривой.
 
+    Обращение координаты \f$ z \f$ выполняется функцией ak_mpzn_modinv(), время работы которой
+    не зависит от приводимой точки.
+
     @param wp Точка кривой, которая приводится к аффинной форме
     @param ec Эллиптическая кривая, которой принадлежит точка                                      */
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_reduce( ak_wpoint wp, ak_wcurve ec )
 {
- ak_mpznmax u, one = ak_mpznmax_one;
+ ak_mpznmax u;
  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
    ak_wpoint_set_as_unit( wp, ec );
    return;
  }
 
- ak_mpzn_set_ui( u, ec->size, 2 );
- ak_mpzn_sub( u, ec->p, u, ec->size );
- ak_mpzn_modpow_montgomery( u, wp->z, u, ec->p, ec->n, ec->size ); // u <- z^{p-2} (mod p)
- ak_mpzn_mul_montgomery( u, u, one, ec->p, ec->n, ec->size );
+ ak_mpzn_modinv( u, wp->z, ec->p, ec->size ); // u <- z^{-1}r^{-1} (mod p)
+ ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
 
- ak_mpzn_mul_montgomery( wp->x, wp->x, u, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->y, wp->y, u, ec->p, ec->n, ec->size );
+ ec->mul( wp->x, wp->x, u, ec->p, ec->n, ec->size );
+ ec->mul( wp->y, wp->y, u, ec->p, ec->n, ec->size );
  ak_mpzn_set_ui( wp->z, ec->size, 1 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция аналогична функции ak_wpoint_reduce(), однако для обращения координаты \f$ z \f$
+    использует функцию ak_mpzn_modinv_vartime(), время работы которой зависит от значения
+    координаты. Функция предназначена для приведения точек, вычисленных по открытым данным,
+    например, при проверке электронной подписи.
+
+    @param wp Точка кривой, которая приводится к аффинной форме
+    @param ec Эллиптическая кривая, которой принадлежит точка                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_reduce_vartime( ak_wpoint wp, ak_wcurve ec )
+{
+ ak_mpznmax u;
+ if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
+   ak_wpoint_set_as_unit( wp, ec );
+   return;
+ }
+
+ ak_mpzn_modinv_vartime( u, wp->z, ec->p, ec->size ); // u <- z^{-1}r^{-1} (mod p)
+ ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
+
+ ec->mul( wp->x, wp->x, u, ec->p, ec->n, ec->size );
+ ec->mul( wp->y, wp->y, u, ec->p, ec->n, ec->size );
+ ak_mpzn_set_ui( wp->z, ec->size, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                          вычисления в координатах Якоби                                         */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция приводит точку \f$ P = (x:y:z) \f$ из проективных координат в координаты Якоби
+    \f$ (X:Y:Z) = (xz:yz^2:z) \f$, для которых \f$ x/z = X/Z^2 \f$ и \f$ y/z = Y/Z^3 \f$.
+
+    Координаты Якоби используются только внутри функций вычисления кратных точек;
+    для хранения результатов используется класс \ref wpoint с проективными координатами.      */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_to_jacobian( ak_wpoint wj, ak_wpoint wp, ak_wcurve ec )
+{
+  ak_mpznmax zz;
+
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_as_unit( wj, ec );
+    return;
+  }
+  ec->sqr( zz, wp->z, ec->p, ec->n, ec->size );
+  ec->mul( wj->y, wp->y, zz, ec->p, ec->n, ec->size );
+  ec->mul( wj->x, wp->x, wp->z, ec->p, ec->n, ec->size );
+  ak_mpzn_set( wj->z, wp->z, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция приводит точку \f$ (X:Y:Z) \f$ из координат Якоби в проективные
+    координаты \f$ (XZ:Y:Z^3) \f$.                                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_from_jacobian( ak_wpoint wp, ak_wpoint wj, ak_wcurve ec )
+{
+  ak_mpznmax zz;
+
+  if( ak_mpzn_cmp_ui( wj->z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_as_unit( wp, ec );
+    return;
+  }
+  ec->sqr( zz, wj->z, ec->p, ec->n, ec->size );
+  ec->mul( wp->x, wj->x, wj->z, ec->p, ec->n, ec->size );
+  ec->mul( wp->z, zz, wj->z, ec->p, ec->n, ec->size );
+  ak_mpzn_set( wp->y, wj->y, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удвоение точки, заданной в координатах Якоби.
+
+    Для кривых с коэффициентом \f$ a \equiv -3 \pmod{p} \f$ используются формулы dbl-2001-b
+    (3M + 5S), для остальных кривых - формулы dbl-2007-bl (1M + 8S + умножение на \f$ a \f$),
+    см. <a href="http://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian.html">Explicit-Formulas
+    Database</a>.
+
+    \code
+      a = -3:                              произвольное a:
+      delta = Z1^2                         XX = X1^2, YY = Y1^2, YYYY = YY^2, ZZ = Z1^2
+      gamma = Y1^2                         S = 2*((X1+YY)^2-XX-YYYY)
+      beta = X1*gamma                      M = 3*XX+a*ZZ^2
+      alpha = 3*(X1-delta)*(X1+delta)      X3 = M^2-2*S
+      X3 = alpha^2-8*beta                  Y3 = M*(S-X3)-8*YYYY
+      Z3 = (Y1+Z1)^2-gamma-delta           Z3 = (Y1+Z1)^2-YY-ZZ
+      Y3 = alpha*(4*beta-X3)-8*gamma^2
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_double_jacobian( ak_wpoint wp, ak_wcurve ec )
+{
+  ak_mpznmax u1, u2, u3, u4;
+
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) return;
+  if( ak_mpzn_cmp_ui( wp->y, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_as_unit( wp, ec );
+    return;
+  }
+
+  if( ec->a_is_minus_three ) {
+   // dbl-2001-b
+    ec->sqr( u1, wp->z, ec->p, ec->n, ec->size );              // u1 = delta
+    ec->sqr( u2, wp->y, ec->p, ec->n, ec->size );              // u2 = gamma
+    ec->mul( u3, wp->x, u2, ec->p, ec->n, ec->size );          // u3 = beta
+    ak_mpzn_sub_montgomery( u4, wp->x, u1, ec->p, ec->size );
+    ak_mpzn_add_montgomery( wp->x, wp->x, u1, ec->p, ec->size );
+    ec->mul( u4, u4, wp->x, ec->p, ec->n, ec->size );
+    ak_mpzn_lshift_montgomery( wp->x, u4, ec->p, ec->size );
+    ak_mpzn_add_montgomery( u4, u4, wp->x, ec->p, ec->size );  // u4 = alpha
+    ak_mpzn_add_montgomery( wp->z, wp->z, wp->y, ec->p, ec->size );
+    ec->sqr( wp->z, wp->z, ec->p, ec->n, ec->size );
+    ak_mpzn_sub_montgomery( wp->z, wp->z, u2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( wp->z, wp->z, u1, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( u3, u3, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( u3, u3, ec->p, ec->size );      // u3 = 4*beta
+    ec->sqr( wp->x, u4, ec->p, ec->n, ec->size );
+    ak_mpzn_lshift_montgomery( u1, u3, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( wp->x, wp->x, u1, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( u3, u3, wp->x, ec->p, ec->size );
+    ec->mul( wp->y, u4, u3, ec->p, ec->n, ec->size );
+    ec->sqr( u2, u2, ec->p, ec->n, ec->size );
+    ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( wp->y, wp->y, u2, ec->p, ec->size );
+    return;
+  }
+
+ // dbl-2007-bl
+  ec->sqr( u1, wp->x, ec->p, ec->n, ec->size );                // u1 = XX
+  ec->sqr( u2, wp->y, ec->p, ec->n, ec->size );                // u2 = YY
+  ec->sqr( u3, wp->z, ec->p, ec->n, ec->size );                // u3 = ZZ
+  ak_mpzn_add_montgomery( wp->z, wp->z, wp->y, ec->p, ec->size );
+  ec->sqr( wp->z, wp->z, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wp->z, wp->z, u2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp->z, wp->z, u3, ec->p, ec->size );
+  ak_mpzn_add_montgomery( wp->x, wp->x, u2, ec->p, ec->size );
+  ec->sqr( wp->x, wp->x, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wp->x, wp->x, u1, ec->p, ec->size );
+  ec->sqr( u2, u2, ec->p, ec->n, ec->size );                   // u2 = YYYY
+  ak_mpzn_sub_montgomery( wp->x, wp->x, u2, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u4, wp->x, ec->p, ec->size );     // u4 = S
+  ec->sqr( u3, u3, ec->p, ec->n, ec->size );
+  ec->mul( u3, u3, ec->a, ec->p, ec->n, ec->size );
+  ak_mpzn_add_montgomery( u3, u3, u1, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u1, u1, ec->p, ec->size );
+  ak_mpzn_add_montgomery( u3, u3, u1, ec->p, ec->size );       // u3 = M
+  ec->sqr( wp->x, u3, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( u1, u4, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp->x, wp->x, u1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( u4, u4, wp->x, ec->p, ec->size );
+  ec->mul( wp->y, u3, u4, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp->y, wp->y, u2, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение двух точек, заданных в координатах Якоби; результат помещается
+    в точку \f$ P \f$.
+
+    Используются формулы add-2007-bl (11M + 5S). Совпадающие и противоположные точки
+    обрабатываются отдельно.
+
+    \code
+      Z1Z1 = Z1^2, Z2Z2 = Z2^2
+      U1 = X1*Z2Z2, U2 = X2*Z1Z1
+      S1 = Y1*Z2*Z2Z2, S2 = Y2*Z1*Z1Z1
+      H = U2-U1, I = (2*H)^2, J = H*I
+      r = 2*(S2-S1), V = U1*I
+      X3 = r^2-J-2*V
+      Y3 = r*(V-X3)-2*S1*J
+      Z3 = ((Z1+Z2)^2-Z1Z1-Z2Z2)*H
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_add_jacobian( ak_wpoint wp1, ak_wpoint wp2, ak_wcurve ec )
+{
+  ak_mpznmax u1, u2, s1, s2, z1z1, z2z2, h, r;
+
+  if( ak_mpzn_cmp_ui( wp2->z, ec->size, 0 ) == ak_true ) return;
+  if( ak_mpzn_cmp_ui( wp1->z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_wpoint( wp1, wp2, ec );
+    return;
+  }
+
+  ec->sqr( z1z1, wp1->z, ec->p, ec->n, ec->size );
+  ec->sqr( z2z2, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u1, wp1->x, z2z2, ec->p, ec->n, ec->size );
+  ec->mul( u2, wp2->x, z1z1, ec->p, ec->n, ec->size );
+  ec->mul( s1, wp2->z, z2z2, ec->p, ec->n, ec->size );
+  ec->mul( s1, wp1->y, s1, ec->p, ec->n, ec->size );
+  ec->mul( s2, wp1->z, z1z1, ec->p, ec->n, ec->size );
+  ec->mul( s2, wp2->y, s2, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( h, u2, u1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( r, s2, s1, ec->p, ec->size );
+  if( ak_mpzn_cmp_ui( h, ec->size, 0 ) == ak_true ) { // случай совпадения х-координат точек
+    if( ak_mpzn_cmp_ui( r, ec->size, 0 ) == ak_true ) ak_wpoint_double_jacobian( wp1, ec );
+     else ak_wpoint_set_as_unit( wp1, ec );
+    return;
+  }
+
+ // add-2007-bl
+  ak_mpzn_add_montgomery( wp1->z, wp1->z, wp2->z, ec->p, ec->size );
+  ec->sqr( wp1->z, wp1->z, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wp1->z, wp1->z, z1z1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->z, wp1->z, z2z2, ec->p, ec->size );
+  ec->mul( wp1->z, wp1->z, h, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( u2, h, ec->p, ec->size );
+  ec->sqr( u2, u2, ec->p, ec->n, ec->size );                   // u2 = I
+  ec->mul( h, h, u2, ec->p, ec->n, ec->size );                 // h = J
+  ec->mul( u1, u1, u2, ec->p, ec->n, ec->size );               // u1 = V
+  ak_mpzn_lshift_montgomery( r, r, ec->p, ec->size );
+  ec->sqr( wp1->x, r, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, h, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, u2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( u1, u1, wp1->x, ec->p, ec->size );
+  ec->mul( wp1->y, r, u1, ec->p, ec->n, ec->size );
+  ec->mul( s1, s1, h, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( s1, s1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->y, wp1->y, s1, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Прибавление к точке \f$ P \f$, заданной в координатах Якоби, точки \f$ Q = (x_2, y_2) \f$,
+    заданной в аффинных координатах в представлении Монтгомери.
+
+    Используются формулы madd-2007-bl (7M + 4S). Координата \f$ z \f$ точки \f$ Q \f$ используется
+    только как признак бесконечно удаленной точки (значение ноль). Поскольку бесконечно удаленные
+    и совпадающие точки обрабатываются ветвлением, функция используется только для вычислений
+    с открытыми данными (см. ak_wpoint_add_complete()).
+
+    \code
+      Z1Z1 = Z1^2
+      U2 = X2*Z1Z1, S2 = Y2*Z1*Z1Z1
+      H = U2-X1, HH = H^2, I = 4*HH, J = H*I
+      r = 2*(S2-Y1), V = X1*I
+      X3 = r^2-J-2*V
+      Y3 = r*(V-X3)-2*Y1*J
+      Z3 = (Z1+H)^2-Z1Z1-HH
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_add_mixed( ak_wpoint wp1, ak_wpoint wp2, ak_wcurve ec )
+{
+  ak_mpznmax z1z1, u2, s2, hh, i;
+
+  if( ak_mpzn_cmp_ui( wp2->z, ec->size, 0 ) == ak_true ) return;
+  if( ak_mpzn_cmp_ui( wp1->z, ec->size, 0 ) == ak_true ) {
+    ak_mpzn_set( wp1->x, wp2->x, ec->size );
+    ak_mpzn_set( wp1->y, wp2->y, ec->size );
+    ak_mpzn_set_ui( wp1->z, ec->size, 1 );
+    ec->mul( wp1->z, wp1->z, ec->r2, ec->p, ec->n, ec->size );
+    return;
+  }
+
+  ec->sqr( z1z1, wp1->z, ec->p, ec->n, ec->size );
+  ec->mul( u2, wp2->x, z1z1, ec->p, ec->n, ec->size );
+  ec->mul( s2, wp1->z, z1z1, ec->p, ec->n, ec->size );
+  ec->mul( s2, wp2->y, s2, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( u2, u2, wp1->x, ec->p, ec->size );   // u2 = H
+  ak_mpzn_sub_montgomery( s2, s2, wp1->y, ec->p, ec->size );
+  if( ak_mpzn_cmp_ui( u2, ec->size, 0 ) == ak_true ) { // случай совпадения х-координат точек
+    if( ak_mpzn_cmp_ui( s2, ec->size, 0 ) == ak_true ) ak_wpoint_double_jacobian( wp1, ec );
+     else ak_wpoint_set_as_unit( wp1, ec );
+    return;
+  }
+
+ // madd-2007-bl
+  ec->sqr( hh, u2, ec->p, ec->n, ec->size );
+  ak_mpzn_add_montgomery( wp1->z, wp1->z, u2, ec->p, ec->size );
+  ec->sqr( wp1->z, wp1->z, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wp1->z, wp1->z, z1z1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->z, wp1->z, hh, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( i, hh, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( i, i, ec->p, ec->size );          // i = I
+  ec->mul( u2, u2, i, ec->p, ec->n, ec->size );                // u2 = J
+  ec->mul( i, wp1->x, i, ec->p, ec->n, ec->size );             // i = V
+  ak_mpzn_lshift_montgomery( s2, s2, ec->p, ec->size );        // s2 = r
+  ec->sqr( wp1->x, s2, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, u2, ec->p, ec->size );
+  ak_mpzn_lshift_montgomery( hh, i, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( wp1->x, wp1->x, hh, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( i, i, wp1->x, ec->p, ec->size );
+  ec->mul( u2, wp1->y, u2, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u2, ec->p, ec->size );
+  ec->mul( wp1->y, s2, i, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wp1->y, wp1->y, u2, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение двух точек, заданных в проективных координатах, по полным формулам;
+    результат помещается в точку \f$ P \f$.
+
+    Используются формулы J. Renes, C. Costello, L. Batina (Complete addition formulas for prime
+    order elliptic curves, 2016): алгоритм 4 для кривых с \f$ a \equiv -3 \pmod{p} \f$ (12M + 2 умножения
+    на \f$ b \f$) и алгоритм 1 для остальных кривых (12M + 3 умножения на \f$ a \f$ и 2 на \f$ 3b \f$).
+    Формулы корректны для любых точек кривой нечетного порядка, в том числе для бесконечно удаленной
+    и совпадающих точек, поэтому функция не содержит ветвлений, и последовательность операций
+    не зависит от значений координат.                                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_add_complete( ak_wpoint wp1, ak_wpoint wp2, ak_wcurve ec )
+{
+  ak_mpznmax t0, t1, t2, t3, t4, t5, b3, x3, y3, z3;
+
+  ec->mul( t0, wp1->x, wp2->x, ec->p, ec->n, ec->size );
+  ec->mul( t1, wp1->y, wp2->y, ec->p, ec->n, ec->size );
+  ec->mul( t2, wp1->z, wp2->z, ec->p, ec->n, ec->size );
+  ak_mpzn_add_montgomery( t3, wp1->x, wp1->y, ec->p, ec->size );
+  ak_mpzn_add_montgomery( t4, wp2->x, wp2->y, ec->p, ec->size );
+  ec->mul( t3, t3, t4, ec->p, ec->n, ec->size );
+  ak_mpzn_add_montgomery( t4, t0, t1, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( t3, t3, t4, ec->p, ec->size );       // t3 = X1Y2 + X2Y1
+
+  if( ec->a_is_minus_three ) {
+   // алгоритм 4
+    ak_mpzn_add_montgomery( t4, wp1->y, wp1->z, ec->p, ec->size );
+    ak_mpzn_add_montgomery( x3, wp2->y, wp2->z, ec->p, ec->size );
+    ec->mul( t4, t4, x3, ec->p, ec->n, ec->size );
+    ak_mpzn_add_montgomery( x3, t1, t2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( t4, t4, x3, ec->p, ec->size );     // t4 = Y1Z2 + Y2Z1
+    ak_mpzn_add_montgomery( x3, wp1->x, wp1->z, ec->p, ec->size );
+    ak_mpzn_add_montgomery( y3, wp2->x, wp2->z, ec->p, ec->size );
+    ec->mul( x3, x3, y3, ec->p, ec->n, ec->size );
+    ak_mpzn_add_montgomery( y3, t0, t2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( y3, x3, y3, ec->p, ec->size );     // y3 = X1Z2 + X2Z1
+    ec->mul( z3, ec->b, t2, ec->p, ec->n, ec->size );
+    ak_mpzn_sub_montgomery( x3, y3, z3, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( z3, x3, ec->p, ec->size );
+    ak_mpzn_add_montgomery( x3, x3, z3, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( z3, t1, x3, ec->p, ec->size );
+    ak_mpzn_add_montgomery( x3, t1, x3, ec->p, ec->size );
+    ec->mul( y3, ec->b, y3, ec->p, ec->n, ec->size );
+    ak_mpzn_lshift_montgomery( t1, t2, ec->p, ec->size );
+    ak_mpzn_add_montgomery( t2, t1, t2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( y3, y3, t2, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( y3, y3, t0, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( t1, y3, ec->p, ec->size );
+    ak_mpzn_add_montgomery( y3, t1, y3, ec->p, ec->size );
+    ak_mpzn_lshift_montgomery( t1, t0, ec->p, ec->size );
+    ak_mpzn_add_montgomery( t0, t1, t0, ec->p, ec->size );
+    ak_mpzn_sub_montgomery( t0, t0, t2, ec->p, ec->size );
+    ec->mul( t1, t4, y3, ec->p, ec->n, ec->size );
+    ec->mul( t2, t0, y3, ec->p, ec->n, ec->size );
+    ec->mul( y3, x3, z3, ec->p, ec->n, ec->size );
+    ak_mpzn_add_montgomery( y3, y3, t2, ec->p, ec->size );
+    ec->mul( x3, x3, t3, ec->p, ec->n, ec->size );
+    ak_mpzn_sub_montgomery( x3, x3, t1, ec->p, ec->size );
+    ec->mul( z3, t4, z3, ec->p, ec->n, ec->size );
+    ec->mul( t1, t3, t0, ec->p, ec->n, ec->size );
+    ak_mpzn_add_montgomery( z3, z3, t1, ec->p, ec->size );
+  } else {
+   // алгоритм 1, b3 = 3b
+     ak_mpzn_lshift_montgomery( b3, ec->b, ec->p, ec->size );
+     ak_mpzn_add_montgomery( b3, b3, ec->b, ec->p, ec->size );
+     ak_mpzn_add_montgomery( t4, wp1->x, wp1->z, ec->p, ec->size );
+     ak_mpzn_add_montgomery( t5, wp2->x, wp2->z, ec->p, ec->size );
+     ec->mul( t4, t4, t5, ec->p, ec->n, ec->size );
+     ak_mpzn_add_montgomery( t5, t0, t2, ec->p, ec->size );
+     ak_mpzn_sub_montgomery( t4, t4, t5, ec->p, ec->size );    // t4 = X1Z2 + X2Z1
+     ak_mpzn_add_montgomery( t5, wp1->y, wp1->z, ec->p, ec->size );
+     ak_mpzn_add_montgomery( x3, wp2->y, wp2->z, ec->p, ec->size );
+     ec->mul( t5, t5, x3, ec->p, ec->n, ec->size );
+     ak_mpzn_add_montgomery( x3, t1, t2, ec->p, ec->size );
+     ak_mpzn_sub_montgomery( t5, t5, x3, ec->p, ec->size );    // t5 = Y1Z2 + Y2Z1
+     ec->mul( z3, ec->a, t4, ec->p, ec->n, ec->size );
+     ec->mul( x3, b3, t2, ec->p, ec->n, ec->size );
+     ak_mpzn_add_montgomery( z3, x3, z3, ec->p, ec->size );
+     ak_mpzn_sub_montgomery( x3, t1, z3, ec->p, ec->size );
+     ak_mpzn_add_montgomery( z3, t1, z3, ec->p, ec->size );
+     ec->mul( y3, x3, z3, ec->p, ec->n, ec->size );
+     ak_mpzn_lshift_montgomery( t1, t0, ec->p, ec->size );
+     ak_mpzn_add_montgomery( t1, t1, t0, ec->p, ec->size );
+     ec->mul( t2, ec->a, t2, ec->p, ec->n, ec->size );
+     ec->mul( t4, b3, t4, ec->p, ec->n, ec->size );
+     ak_mpzn_add_montgomery( t1, t1, t2, ec->p, ec->size );
+     ak_mpzn_sub_montgomery( t2, t0, t2, ec->p, ec->size );
+     ec->mul( t2, ec->a, t2, ec->p, ec->n, ec->size );
+     ak_mpzn_add_montgomery( t4, t4, t2, ec->p, ec->size );
+     ec->mul( t0, t1, t4, ec->p, ec->n, ec->size );
+     ak_mpzn_add_montgomery( y3, y3, t0, ec->p, ec->size );
+     ec->mul( t0, t5, t4, ec->p, ec->n, ec->size );
+     ec->mul( x3, t3, x3, ec->p, ec->n, ec->size );
+     ak_mpzn_sub_montgomery( x3, x3, t0, ec->p, ec->size );
+     ec->mul( t0, t3, t1, ec->p, ec->n, ec->size );
+     ec->mul( z3, t5, z3, ec->p, ec->n, ec->size );
+     ak_mpzn_add_montgomery( z3, z3, t0, ec->p, ec->size );
+  }
+
+  ak_mpzn_set( wp1->x, x3, ec->size );
+  ak_mpzn_set( wp1->y, y3, ec->size );
+  ak_mpzn_set( wp1->z, z3, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                    вычисления на эквивалентной кривой в форме Эдвардса                           */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Точка кривой в форме Эдвардса в расширенных координатах \f$ (X:Y:T:Z) \f$, для которых
+    \f$ u = X/Z,\ v = Y/Z \f$ и \f$ XY = TZ \f$. Координаты хранятся в представлении Монтгомери. */
+ struct epoint {
+  /*! \brief Координата \f$ X \f$ точки. */
+   ak_uint64 x[ak_mpzn512_size];
+  /*! \brief Координата \f$ Y \f$ точки. */
+   ak_uint64 y[ak_mpzn512_size];
+  /*! \brief Координата \f$ T \f$ точки. */
+   ak_uint64 t[ak_mpzn512_size];
+  /*! \brief Координата \f$ Z \f$ точки. */
+   ak_uint64 z[ak_mpzn512_size];
+ };
+/*! \brief Контекст точки кривой в форме Эдвардса. */
+ typedef struct epoint *ak_epoint;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция присваивает точке нейтральный элемент \f$ (0:1:0:1) \f$ группы точек
+    кривой Эдвардса.                                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_set_as_unit( ak_epoint ep, ak_wcurve ec )
+{
+  ak_mpzn_set_ui( ep->x, ec->size, 0 );
+  ak_mpzn_set_ui( ep->t, ec->size, 0 );
+  ak_mpzn_set_ui( ep->y, ec->size, 1 );
+  ec->mul( ep->y, ep->y, ec->r2, ec->p, ec->n, ec->size );
+  ak_mpzn_set( ep->z, ep->y, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет точку кривой Эдвардса, соответствующую точке \f$ P = (x:y:z) \f$
+    кривой в форме Вейерштрасса.
+
+    Для \f$ x' = x - tz \f$ расширенные координаты точки равны
+    \f$ (x'(x'+sz) : y(x'-sz) : x'(x'-sz) : y(x'+sz)) \f$, что не требует обращения элементов.
+    Бесконечно удаленная точка переходит в нейтральный элемент.
+
+    @return Функция возвращает \ref ak_false, если точка является исключительной для
+    бирационального отображения (это возможно только для точек порядка 2 или 4).                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wpoint_to_epoint( ak_epoint ep, ak_wpoint wp, ak_wcurve ec )
+{
+  ak_mpznmax u1, u2, u3;
+
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
+    ak_epoint_set_as_unit( ep, ec );
+    return ak_true;
+  }
+  if( ak_mpzn_cmp_ui( wp->y, ec->size, 0 ) == ak_true ) return ak_false;
+
+  ec->mul( u1, ( ak_uint64 * )ec->ecurve->t, wp->z, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( u1, wp->x, u1, ec->p, ec->size );    // u1 = x'
+  ec->mul( u2, ( ak_uint64 * )ec->ecurve->s, wp->z, ec->p, ec->n, ec->size );
+  ak_mpzn_add_montgomery( u3, u1, u2, ec->p, ec->size );       // u3 = x'+sz
+  if( ak_mpzn_cmp_ui( u3, ec->size, 0 ) == ak_true ) return ak_false;
+  ak_mpzn_sub_montgomery( u2, u1, u2, ec->p, ec->size );       // u2 = x'-sz
+
+  ec->mul( ep->x, u1, u3, ec->p, ec->n, ec->size );
+  ec->mul( ep->t, u1, u2, ec->p, ec->n, ec->size );
+  ec->mul( ep->z, wp->y, u3, ec->p, ec->n, ec->size );
+  ec->mul( ep->y, wp->y, u2, ec->p, ec->n, ec->size );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет точку кривой в форме Вейерштрасса, соответствующую точке
+    \f$ (X:Y:T:Z) \f$ кривой Эдвардса:
+    \f$ P = ((s(Z+Y) + t(Z-Y))X : s(Z+Y)Z : (Z-Y)X) \f$.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_to_wpoint( ak_wpoint wp, ak_epoint ep, ak_wcurve ec )
+{
+  ak_mpznmax u1, u2;
+
+  if( ak_mpzn_cmp_ui( ep->x, ec->size, 0 ) == ak_true ) {
+    if( ak_mpzn_cmp( ep->y, ep->z, ec->size ) == 0 ) ak_wpoint_set_as_unit( wp, ec );
+     else { /* точка (0,-1) порядка 2 переходит в точку (t,0) */
+       ak_mpzn_set( wp->x, ( ak_uint64 * )ec->ecurve->t, ec->size );
+       ak_mpzn_set_ui( wp->y, ec->size, 0 );
+       ak_mpzn_set_ui( wp->z, ec->size, 1 );
+       ec->mul( wp->z, wp->z, ec->r2, ec->p, ec->n, ec->size );
+     }
+    return;
+  }
+
+  ak_mpzn_add_montgomery( u1, ep->z, ep->y, ec->p, ec->size );
+  ec->mul( u1, u1, ( ak_uint64 * )ec->ecurve->s, ec->p, ec->n, ec->size );   // u1 = s(Z+Y)
+  ak_mpzn_sub_montgomery( u2, ep->z, ep->y, ec->p, ec->size ); // u2 = Z-Y
+  ec->mul( wp->y, u1, ep->z, ec->p, ec->n, ec->size );
+  ec->mul( wp->z, u2, ep->x, ec->p, ec->n, ec->size );
+  ec->mul( u2, u2, ( ak_uint64 * )ec->ecurve->t, ec->p, ec->n, ec->size );
+  ak_mpzn_add_montgomery( u1, u1, u2, ec->p, ec->size );
+  ec->mul( wp->x, u1, ep->x, ec->p, ec->n, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удвоение точки кривой Эдвардса в расширенных координатах (формулы dbl-2008-hwcd, 4M + 4S).
+
+    \code
+      A = X1^2, B = Y1^2, C = 2*Z1^2
+      E = (X1+Y1)^2-A-B, G = A+B, F = G-C, H = A-B
+      X3 = E*F, Y3 = G*H, T3 = E*H, Z3 = F*G
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_double( ak_epoint ep, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, e;
+
+  ec->sqr( a, ep->x, ec->p, ec->n, ec->size );
+  ec->sqr( b, ep->y, ec->p, ec->n, ec->size );
+  ec->sqr( c, ep->z, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( c, c, ec->p, ec->size );
+  ak_mpzn_add_montgomery( e, ep->x, ep->y, ec->p, ec->size );
+  ec->sqr( e, e, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( e, e, a, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( e, e, b, ec->p, ec->size );          // e = E
+  ak_mpzn_sub_montgomery( ep->t, a, b, ec->p, ec->size );      // t = H
+  ak_mpzn_add_montgomery( a, a, b, ec->p, ec->size );          // a = G
+  ak_mpzn_sub_montgomery( c, a, c, ec->p, ec->size );          // c = F
+
+  ec->mul( ep->x, e, c, ec->p, ec->n, ec->size );
+  ec->mul( ep->y, a, ep->t, ec->p, ec->n, ec->size );
+  ec->mul( ep->t, e, ep->t, ec->p, ec->n, ec->size );
+  ec->mul( ep->z, c, a, ec->p, ec->n, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение точек кривой Эдвардса в расширенных координатах (формулы add-2008-hwcd).
+
+    Поскольку коэффициент \f$ d \f$ не является квадратом, формулы сложения полны, то есть
+    корректно обрабатывают совпадающие точки и нейтральный элемент.
+    Если параметр affine равен \ref ak_true, то точка \f$ Q \f$ задана аффинными
+    координатами \f$ (u, v, duv) \f$, а ее координата \f$ Z \f$ не используется (9M),
+    в противном случае используются все расширенные координаты (11M).
+
+    \code
+      A = X1*X2, B = Y1*Y2, C = d*T1*T2, D = Z1*Z2
+      E = (X1+Y1)*(X2+Y2)-A-B, F = D-C, G = D+C, H = B-A
+      X3 = E*F, Y3 = G*H, T3 = E*H, Z3 = F*G
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_add( ak_epoint ep1, ak_epoint ep2, bool_t affine, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, d, e;
+
+  ec->mul( a, ep1->x, ep2->x, ec->p, ec->n, ec->size );
+  ec->mul( b, ep1->y, ep2->y, ec->p, ec->n, ec->size );
+  ec->mul( c, ep1->t, ep2->t, ec->p, ec->n, ec->size );
+  if( affine ) ak_mpzn_set( d, ep1->z, ec->size );
+   else {
+     ec->mul( c, c, ( ak_uint64 * )ec->ecurve->d, ec->p, ec->n, ec->size );
+     ec->mul( d, ep1->z, ep2->z, ec->p, ec->n, ec->size );
+   }
+  ak_mpzn_add_montgomery( e, ep1->x, ep1->y, ec->p, ec->size );
+  ak_mpzn_add_montgomery( ep1->t, ep2->x, ep2->y, ec->p, ec->size );
+  ec->mul( e, e, ep1->t, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( e, e, a, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( e, e, b, ec->p, ec->size );          // e = E
+  ak_mpzn_sub_montgomery( b, b, a, ec->p, ec->size );          // b = H
+  ak_mpzn_add_montgomery( a, d, c, ec->p, ec->size );          // a = G
+  ak_mpzn_sub_montgomery( d, d, c, ec->p, ec->size );          // d = F
+
+  ec->mul( ep1->x, e, d, ec->p, ec->n, ec->size );
+  ec->mul( ep1->y, a, b, ec->p, ec->n, ec->size );
+  ec->mul( ep1->t, e, b, ec->p, ec->n, ec->size );
+  ec->mul( ep1->z, d, a, ec->p, ec->n, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заменяет точку \f$ (X:Y:T:Z) \f$ кривой Эдвардса на противоположную
+    \f$ (-X:Y:-T:Z) \f$.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_negate( ak_epoint ep, ak_wcurve ec )
+{
+  ak_mpznmax zero = ak_mpznmax_zero;
+
+  ak_mpzn_sub_montgomery( ep->x, zero, ep->x, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( ep->t, zero, ep->t, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет кратную точку \f$ Q = [k]P \f$ с помощью лесенки Монтгомери
+    на эквивалентной кривой Эдвардса.
+
+    @return Функция возвращает \ref ak_false, если точку \f$ P \f$ невозможно отобразить
+    на кривую Эдвардса; в этом случае значение \f$ Q \f$ не изменяется.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_epoint_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  ak_uint64 uk = 0;
+  long long int i, j;
+  struct epoint Q, R;
+
+  if( ak_wpoint_to_epoint( &R, wp, ec ) != ak_true ) return ak_false;
+  ak_epoint_set_as_unit( &Q, ec );
+
+  for( i = size-1; i >= 0; i-- ) {
+     uk = k[i];
+     for( j = 0; j < 64; j++ ) {
+       if( uk&0x8000000000000000LL ) {
+         ak_epoint_add( &Q, &R, ak_false, ec );
+         ak_epoint_double( &R, ec );
+       } else {
+           ak_epoint_add( &R, &Q, ak_false, ec );
+           ak_epoint_double( &Q, ec );
+         }
+       uk <<= 1;
+     }
+  }
+  ak_epoint_to_wpoint( wq, &Q, ec );
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для заданной точки \f$ P = (x:y:z) \f$ и заданного целого числа (вычета) \f$ k \f$
     функция вычисляет кратную точку \f$ Q \f$, удовлетворяющую
     равенству \f$  Q = [k]P = \underbrace{P+ \cdots + P}_{k}\f$.
 
     При вычислении используется метод `лесенки Монтгомери`, выравнивающий время работы алгоритма
-    вне зависимости от вида числа \f$ k \f$.
+    вне зависимости от вида числа \f$ k \f$. Промежуточные вычисления выполняются
+    в координатах Якоби, а для кривых, имеющих эквивалентную форму Эдвардса, - на кривой Эдвардса.
 
     \b Для \b информации:
      \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
@@ -613,21 +1658,187 @@
   long long int i, j;
   struct wpoint Q, R; /* две точки из лесенки Монтгомери */
 
+  if(( ec->ecurve != NULL ) && ak_epoint_pow( wq, wp, k, size, ec )) return;
+
  /* начальные значения для переменных */
   ak_wpoint_set_as_unit( &Q, ec );
-  ak_wpoint_set_wpoint( &R, wp, ec );
+  ak_wpoint_to_jacobian( &R, wp, ec );
 
  /* полный цикл по всем(!) битам числа k */
   for( i = size-1; i >= 0; i-- ) {
      uk = k[i];
      for( j = 0; j < 64; j++ ) {
-       if( uk&0x8000000000000000LL ) { ak_wpoint_add( &Q, &R, ec ); ak_wpoint_double( &R, ec ); }
-        else { ak_wpoint_add( &R, &Q, ec ); ak_wpoint_double( &Q, ec ); }
+       if( uk&0x8000000000000000LL ) {
+         ak_wpoint_add_jacobian( &Q, &R, ec );
+         ak_wpoint_double_jacobian( &R, ec );
+       } else {
+           ak_wpoint_add_jacobian( &R, &Q, ec );
+           ak_wpoint_double_jacobian( &Q, ec );
+         }
        uk <<= 1;
      }
   }
- /* копируем полученный результат */
-  ak_wpoint_set_wpoint( wq, &Q, ec );
+ /* возвращаемся к проективным координатам */
+  ak_wpoint_from_jacobian( wq, &Q, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Шаг лесенки Монтгомери для точек \f$ A = (X_1:Y_1:Z) \f$ и \f$ B = (X_2:Y_2:Z) \f$
+    в координатах Якоби с общей \f$ z \f$-координатой: вычисляются \f$ A \leftarrow 2A \f$ и
+    \f$ B \leftarrow A + B \f$ при условии \f$ B - A = \pm P \f$.
+
+    Шаг состоит из сопряженного сложения (ZADDC), вычисляющего \f$ A+B \f$ и \f$ A-B \f$,
+    и последующего сложения (ZADDU) этих точек, см. R. R. Goundar, M. Joye, A. Miyaji,
+    M. Rivain, A. Venelli, <i>Scalar multiplication on Weierstraß elliptic curves from
+    Co-Z arithmetic</i>, 2011. Стоимость шага составляет 11M + 5S.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_coz_step( ak_wpoint wa, ak_wpoint wb, ak_uint64 *z, ak_wcurve ec )
+{
+  ak_mpznmax c, w1, w2, a1, d, e;
+
+ /* ZADDC: B <- A + B, A <- A - B */
+  ak_mpzn_sub_montgomery( c, wa->x, wb->x, ec->p, ec->size );
+  ec->mul( z, z, c, ec->p, ec->n, ec->size );
+  ec->sqr( c, c, ec->p, ec->n, ec->size );
+  ec->mul( w1, wa->x, c, ec->p, ec->n, ec->size );
+  ec->mul( w2, wb->x, c, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( a1, w1, w2, ec->p, ec->size );
+  ec->mul( a1, a1, wa->y, ec->p, ec->n, ec->size );             // a1 = Y1(W1-W2)
+  ak_mpzn_add_montgomery( w2, w1, w2, ec->p, ec->size );        // w2 = W1+W2
+  ak_mpzn_sub_montgomery( d, wa->y, wb->y, ec->p, ec->size );
+  ak_mpzn_add_montgomery( e, wa->y, wb->y, ec->p, ec->size );
+
+  ec->sqr( c, d, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wb->x, c, w2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( c, w1, wb->x, ec->p, ec->size );
+  ec->mul( c, c, d, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wb->y, c, a1, ec->p, ec->size );
+
+  ec->sqr( c, e, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wa->x, c, w2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( c, w1, wa->x, ec->p, ec->size );
+  ec->mul( c, c, e, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wa->y, c, a1, ec->p, ec->size );
+
+ /* ZADDU: A <- B + A, B <- B (с новой общей координатой) */
+  ak_mpzn_sub_montgomery( c, wb->x, wa->x, ec->p, ec->size );
+  ec->mul( z, z, c, ec->p, ec->n, ec->size );
+  ec->sqr( c, c, ec->p, ec->n, ec->size );
+  ec->mul( w1, wb->x, c, ec->p, ec->n, ec->size );
+  ec->mul( w2, wa->x, c, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( a1, w1, w2, ec->p, ec->size );
+  ec->mul( a1, a1, wb->y, ec->p, ec->n, ec->size );
+  ak_mpzn_add_montgomery( w2, w1, w2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( d, wb->y, wa->y, ec->p, ec->size );
+
+  ec->sqr( c, d, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wa->x, c, w2, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( c, w1, wa->x, ec->p, ec->size );
+  ec->mul( c, c, d, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( wa->y, c, a1, ec->p, ec->size );
+  ak_mpzn_set( wb->x, w1, ec->size );
+  ak_mpzn_set( wb->y, a1, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция меняет местами координаты \f$ x, y \f$ двух точек, если маска
+    состоит из единиц, и оставляет точки без изменений, если маска равна нулю.                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_coz_swap( ak_wpoint wa, ak_wpoint wb, ak_uint64 mask, size_t size )
+{
+  size_t i = 0;
+  ak_uint64 t;
+
+  for( i = 0; i < size; i++ ) {
+     t = ( wa->x[i]^wb->x[i] )&mask; wa->x[i] ^= t; wb->x[i] ^= t;
+     t = ( wa->y[i]^wb->y[i] )&mask; wa->y[i] ^= t; wb->y[i] ^= t;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет кратную точку \f$ Q = [k]P \f$ с помощью лесенки Монтгомери, в которой
+    обе точки лесенки имеют общую \f$ z \f$-координату (co-Z арифметика). Шаг лесенки
+    выполняется без ветвлений, зависящих от \f$ k \f$, и требует 11 умножений и 5 возведений
+    в квадрат, что заметно меньше, чем у функции ak_wpoint_pow().
+
+    Для выравнивания времени вычислений скаляр заменяется числом \f$ k + q \f$ или \f$ k + 2q \f$,
+    старший бит которого всегда находится в одной и той же позиции. Если в ходе вычислений
+    возникает исключительный случай сложения (вероятность которого для \f$ 1 < k < q-2 \f$
+    пренебрежимо мала), результат вычисляется функцией ak_wpoint_pow().
+
+    \b Для \b информации:
+     \li Точка \f$ P \f$ должна принадлежать подгруппе порядка \f$ q \f$, а вычет \f$ k \f$
+     должен удовлетворять неравенству \f$ k < q \f$.
+     \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+     \li Исходная точка \f$ P \f$ и результирующая точка \f$ Q \f$ могут совпадать.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param wp Точка \f$ P \f$, которая возводится в степень.
+    @param k Степень кратности, вычет по модулю \f$ q \f$ длины `ec->size` слов.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_coz( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, ak_wcurve ec )
+{
+  long long int i = 0, bits = 0;
+  ak_uint64 t1[ak_mpzn512_size+1], t2[ak_mpzn512_size+1], mask = 0, bit = 0, prev = 0;
+  ak_mpznmax zz, u1, u2, z;
+  struct wpoint A, B, P;
+
+ /* аффинная точка P в представлении Монтгомери */
+  ak_wpoint_set_wpoint( &P, wp, ec );
+  if( ak_mpzn_cmp_ui( P.z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_as_unit( wq, ec );
+    return;
+  }
+  if( ak_mpzn_cmp_ui( P.z, ec->size, 1 ) != ak_true ) ak_wpoint_reduce( &P, ec );
+  ec->mul( P.x, P.x, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( P.y, P.y, ec->r2, ec->p, ec->n, ec->size );
+
+ /* скаляр k' = k + q или k' = k + 2q, содержащий bits+1 двоичных разрядов */
+  for( bits = 64*ec->size; bits > 0; bits-- )
+     if(( ec->q[( bits-1 ) >> 6] >> (( bits-1 )&0x3f ))&1 ) break;
+  t1[ec->size] = ak_mpzn_add( t1, k, ec->q, ec->size );
+  t2[ec->size] = t1[ec->size] + ak_mpzn_add( t2, t1, ec->q, ec->size );
+  mask = (( t1[bits >> 6] >> ( bits&0x3f ))&1 ) - 1;
+  for( i = 0; i <= ( long long int )ec->size; i++ ) t1[i] ^= ( t1[i]^t2[i] )&mask;
+
+ /* DBLU: A <- P, B <- 2P с общей координатой z = 2y */
+  ec->sqr( u1, P.x, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( u2, u1, ec->p, ec->size );
+  ak_mpzn_add_montgomery( u1, u1, u2, ec->p, ec->size );
+  ak_mpzn_add_montgomery( u1, u1, ec->a, ec->p, ec->size );      // u1 = M = 3x^2 + a
+  ak_mpzn_lshift_montgomery( z, P.y, ec->p, ec->size );          // z = 2y
+  ec->sqr( zz, z, ec->p, ec->n, ec->size );                      // zz = 4y^2
+  ec->mul( A.x, P.x, zz, ec->p, ec->n, ec->size );               // S = 4xy^2
+  ec->mul( A.y, z, zz, ec->p, ec->n, ec->size );
+  ec->mul( A.y, A.y, P.y, ec->p, ec->n, ec->size );              // 8y^4
+  ec->sqr( B.x, u1, ec->p, ec->n, ec->size );
+  ak_mpzn_lshift_montgomery( u2, A.x, ec->p, ec->size );
+  ak_mpzn_sub_montgomery( B.x, B.x, u2, ec->p, ec->size );       // M^2 - 2S
+  ak_mpzn_sub_montgomery( u2, A.x, B.x, ec->p, ec->size );
+  ec->mul( u2, u2, u1, ec->p, ec->n, ec->size );
+  ak_mpzn_sub_montgomery( B.y, u2, A.y, ec->p, ec->size );       // M(S - X) - 8y^4
+
+ /* лесенка (A, B) = ([m]P, [m+1]P) по разрядам bits-1, ..., 0; старший разряд равен единице */
+  prev = 0; /* признак того, что в A находится вторая точка лесенки */
+  for( i = bits-1; i >= 0; i-- ) {
+     bit = ( t1[i >> 6] >> ( i&0x3f ))&1;
+     ak_wpoint_coz_swap( &A, &B, 0 - ( bit^prev ), ec->size );
+     ak_wpoint_coz_step( &A, &B, z, ec );
+     prev = bit;
+  }
+  ak_wpoint_coz_swap( &A, &B, 0 - prev, ec->size );
+
+  memset( t1, 0, sizeof( t1 ));
+  memset( t2, 0, sizeof( t2 ));
+ /* исключительный случай: одна из точек лесенки оказалась бесконечно удаленной */
+  if( ak_mpzn_cmp_ui( z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_pow( wq, wp, k, ec->size, ec );
+    return;
+  }
+ /* A = [k']P = [k]P; возвращаемся к проективным координатам */
+  ak_mpzn_set( A.z, z, ec->size );
+  ak_wpoint_from_jacobian( wq, &A, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -652,6 +1863,693 @@
   return ak_mpzn_cmp_ui( ep.z, ec->size, 0 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для заданной точки \f$ P = (x:y:z) \f$ функция проверяет, что точка отлична от бесконечно
+    удаленной точки, принадлежит эллиптической кривой и лежит в подгруппе порядка \f$ q \f$.
+
+    Если кофактор кривой равен единице, то порядок группы точек кривой совпадает с
+    простым числом \f$ q \f$, и любая отличная от нуля точка кривой имеет порядок \f$ q \f$.
+    В этом случае проверка порядка, требующая вычисления кратной точки \f$ [q]P \f$,
+    не выполняется. Для кривых с кофактором, отличным от единицы, функция дополнительно
+    вызывает ak_wpoint_check_order().
+
+    @param wp точка \f$ P \f$ эллиптической кривой
+    @param ec эллиптическая кривая, на принадлежность которой проверяется точка \f$P\f$.
+
+    @return Функция возвращает \ref ak_true если все проверки выполнены. В противном случае
+    возвращается \ref ak_false.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_wpoint_check_subgroup( ak_wpoint wp, ak_wcurve ec )
+{
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 )) return ak_false;
+  if( ak_wpoint_is_ok( wp, ec ) != ak_true ) return ak_false;
+  if( ec->cofactor == 1 ) return ak_true;
+ return ak_wpoint_check_order( wp, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                     вычисление кратных точек с фиксированным основанием                         */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество точек таблицы, приходящихся на одно 4-х битное окно скаляра. */
+ #define ak_wpoint_table_width  ( 15 )
+/*! \brief Количество слов, занимаемых одной точкой таблицы: координаты \f$ (x, y) \f$ для кривых
+    в форме Вейерштрасса или \f$ (u, v, duv) \f$ для кривых, имеющих эквивалентную форму Эдвардса. */
+ #define ak_wpoint_table_stride( ec )  ((( ec )->ecurve == NULL ? 2 : 3 )*( ec )->size )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция приводит массив точек к аффинному виду, используя прием Монтгомери:
+    вместо обращения каждой из \f$ z \f$-координат вычисляется обратный элемент к их
+    произведению, после чего обратные элементы к каждой из координат находятся с помощью
+    трех умножений. Результат совпадает с результатом последовательного вызова функции
+    ak_wpoint_reduce() для каждой из точек, однако требует только одного обращения.
+
+    @param wp Массив точек; бесконечно удаленные точки допускаются.
+    @param count Количество точек.
+    @param ec Эллиптическая кривая, которой принадлежат точки.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint_reduce_batch( ak_wpoint wp, const size_t count, ak_wcurve ec )
+{
+  size_t i = 0, first = count;
+  ak_mpznmax u, v, one = ak_mpznmax_one, local[ak_wpoint_table_width], *prod = local;
+
+  if( wp == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                  "using null pointer to elliptic curve points" );
+  if( ec == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to elliptic curve" );
+  if( !count ) return ak_error_ok;
+  if(( count > ak_wpoint_table_width ) &&
+     (( prod = malloc( count*sizeof( ak_mpznmax ))) == NULL ))
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                 "incorrect memory allocation for temporary data" );
+
+ /* prod[i] - произведение z-координат всех конечных точек с индексами, не большими i */
+  for( i = 0; i < count; i++ ) {
+     if( ak_mpzn_cmp_ui( wp[i].z, ec->size, 0 ) == ak_true ) {
+       if( first < i ) ak_mpzn_set( prod[i], prod[i-1], ec->size );
+       continue;
+     }
+     if( first < i ) ec->mul( prod[i], prod[i-1], wp[i].z, ec->p, ec->n, ec->size );
+      else {
+        ak_mpzn_set( prod[i], wp[i].z, ec->size );
+        first = i;
+      }
+  }
+
+  if( first < count ) {
+   /* u <- (z_first ... z_{count-1})^{-1} (mod p) в представлении Монтгомери */
+    ak_mpzn_modinv( u, prod[count-1], ec->p, ec->size );
+    ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
+    ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
+  }
+
+  for( i = count; i > 0; i-- ) {
+     ak_wpoint pt = wp + i - 1;
+     if( ak_mpzn_cmp_ui( pt->z, ec->size, 0 ) == ak_true ) {
+       ak_wpoint_set_as_unit( pt, ec );
+       continue;
+     }
+    /* v <- z_{i-1}^{-1}, u <- обратный элемент к произведению предыдущих координат */
+     if( i - 1 > first ) {
+       ec->mul( v, u, prod[i-2], ec->p, ec->n, ec->size );
+       ec->mul( u, u, pt->z, ec->p, ec->n, ec->size );
+     } else ak_mpzn_set( v, u, ec->size );
+
+     ec->mul( v, v, one, ec->p, ec->n, ec->size );
+     ec->mul( pt->x, pt->x, v, ec->p, ec->n, ec->size );
+     ec->mul( pt->y, pt->y, v, ec->p, ec->n, ec->size );
+     ak_mpzn_set_ui( pt->z, ec->size, 1 );
+  }
+  if( prod != local ) free( prod );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для точки \f$ P \f$ вычисляются и сохраняются в аффинной форме (в представлении Монтгомери,
+    что позволяет использовать формулы смешанного сложения) точки \f$ [j16^i]P \f$, где
+    \f$ 1 \leq j \leq 15 \f$, а \f$ i \f$ пробегает все 4-х битные окна скаляра длины
+    \f$ 64 \cdot size \f$ бит. Для 256-ти битных кривых таблица занимает 60 Кб, для 512-ти
+    битных - 240 Кб. Для кривых, имеющих эквивалентную форму Эдвардса, в таблице хранятся
+    точки кривой Эдвардса вместе с величиной \f$ duv \f$, а размер таблицы увеличивается в полтора раза.
+
+    @param wt Контекст таблицы.
+    @param wp Точка \f$ P \f$ эллиптической кривой, для которой вычисляется таблица; точка
+    не должна быть бесконечно удаленной.
+    @param ec Эллиптическая кривая, которой принадлежит точка.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint_table_create( ak_wpoint_table wt, ak_wpoint wp, ak_wcurve ec )
+{
+  size_t i = 0, j = 0, stride = 0;
+  struct epoint ep;
+  struct wpoint base, pts[ak_wpoint_table_width];
+
+  if( wt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to points table" );
+  if( wp == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                   "using null pointer to elliptic curve point" );
+  if( ec == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to elliptic curve" );
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true )
+    return ak_error_message( ak_error_curve_point, __func__ ,
+                                                        "using point at infinity as table base" );
+  memset( wt, 0, sizeof( struct wpoint_table ));
+  wt->size = ec->size;
+  wt->count = ( ec->size << 6 ) >> 2;
+  stride = ak_wpoint_table_stride( ec );
+  if(( wt->data = malloc( wt->count*ak_wpoint_table_width*stride*sizeof( ak_uint64 ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                    "incorrect memory allocation for points table" );
+  ak_wpoint_set_wpoint( &wt->point, wp, ec );
+  ak_wpoint_set_wpoint( &base, wp, ec );
+
+  for( i = 0; i < wt->count; i++ ) {
+     ak_uint64 *ptr = wt->data + i*ak_wpoint_table_width*stride;
+
+    /* pts[j] = [(j+1)16^i]P, base <- [16^{i+1}]P */
+     ak_wpoint_set_wpoint( pts, &base, ec );
+     for( j = 1; j < ak_wpoint_table_width; j++ ) {
+        ak_wpoint_set_wpoint( pts+j, pts+j-1, ec );
+        ak_wpoint_add( pts+j, &base, ec );
+     }
+     ak_wpoint_add( &base, pts+ak_wpoint_table_width-1, ec );
+
+     for( j = 0; j < ak_wpoint_table_width; j++ )
+        if( ak_mpzn_cmp_ui( pts[j].z, ec->size, 0 ) == ak_true ) {
+          ak_wpoint_table_destroy( wt );
+          return ak_error_message( ak_error_curve_point_order, __func__ ,
+                                                  "using table base with unexpected small order" );
+        }
+    /* для кривой Эдвардса заменяем точки на их образы (x:y:z) <- (X:Y:Z) */
+     if( ec->ecurve != NULL )
+       for( j = 0; j < ak_wpoint_table_width; j++ ) {
+          if( ak_wpoint_to_epoint( &ep, pts+j, ec ) != ak_true ) {
+            ak_wpoint_table_destroy( wt );
+            return ak_error_message( ak_error_curve_point_order, __func__ ,
+                                                  "using table base with unexpected small order" );
+          }
+          ak_mpzn_set( pts[j].x, ep.x, ec->size );
+          ak_mpzn_set( pts[j].y, ep.y, ec->size );
+          ak_mpzn_set( pts[j].z, ep.z, ec->size );
+       }
+     ak_wpoint_reduce_batch( pts, ak_wpoint_table_width, ec );
+     for( j = 0; j < ak_wpoint_table_width; j++ ) {
+        ec->mul( pts[j].x, pts[j].x, ec->r2, ec->p, ec->n, ec->size );
+        ec->mul( pts[j].y, pts[j].y, ec->r2, ec->p, ec->n, ec->size );
+        memcpy( ptr + j*stride, pts[j].x, wt->size*sizeof( ak_uint64 ));
+        memcpy( ptr + j*stride + wt->size, pts[j].y, wt->size*sizeof( ak_uint64 ));
+        if( ec->ecurve != NULL ) {
+          ec->mul( pts[j].z, pts[j].x, pts[j].y, ec->p, ec->n, ec->size );
+          ec->mul( pts[j].z, pts[j].z, ( ak_uint64 * )ec->ecurve->d, ec->p, ec->n, ec->size );
+          memcpy( ptr + j*stride + 2*wt->size, pts[j].z, wt->size*sizeof( ak_uint64 ));
+        }
+     }
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param wt Контекст таблицы.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_wpoint_table_destroy( ak_wpoint_table wt )
+{
+  if( wt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to points table" );
+  if( wt->data != NULL ) free( wt->data );
+  memset( wt, 0, sizeof( struct wpoint_table ));
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет кратную точку \f$ Q = [k]P \f$ с помощью таблицы, содержащей точки
+    кривой Эдвардса. Поскольку формулы сложения полны, нулевым окнам скаляра соответствует
+    сложение с нейтральным элементом, и последовательность операций не зависит от \f$ k \f$.      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_table_pow( ak_wpoint wq, ak_wpoint_table wt,
+                                                   ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  struct epoint Q, S;
+  ak_mpznmax one;
+  size_t i = 0, j = 0, t = 0, stride = ak_wpoint_table_stride( ec );
+
+  ak_epoint_set_as_unit( &Q, ec );
+  ak_mpzn_set( one, Q.y, ec->size );
+  for( i = 0; i < wt->count; i++ ) {
+     const ak_uint64 *ptr = wt->data + i*ak_wpoint_table_width*stride;
+     ak_uint64 digit = (( i >> 4 ) < size ) ? ( k[i >> 4] >> (( i&0xf ) << 2 ))&0xf : 0,
+               zmask = (( digit | ( 0 - digit )) >> 63 ) - 1;
+
+    /* для нулевого окна выбирается нейтральный элемент (0, 1, 0) */
+     for( t = 0; t < wt->size; t++ ) {
+        S.x[t] = S.t[t] = 0;
+        S.y[t] = one[t]&zmask;
+     }
+     for( j = 0; j < ak_wpoint_table_width; j++ ) {
+        ak_uint64 diff = ( ak_uint64 )( j+1 ) ^ digit,
+                  mask = (( diff | ( 0 - diff )) >> 63 ) - 1;
+        for( t = 0; t < wt->size; t++ ) {
+           S.x[t] |= ptr[j*stride + t]&mask;
+           S.y[t] |= ptr[j*stride + wt->size + t]&mask;
+           S.t[t] |= ptr[j*stride + 2*wt->size + t]&mask;
+        }
+     }
+     ak_epoint_add( &Q, &S, ak_true, ec );
+  }
+  ak_epoint_to_wpoint( wq, &Q, ec );
+  memset( &Q, 0, sizeof( struct epoint ));
+  memset( &S, 0, sizeof( struct epoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет кратную точку \f$ Q = [k]P \f$, где \f$ P \f$ - точка, для которой
+    была вычислена таблица. Вычисление выполняется с помощью \f$ 16 \cdot size \f$ сложений
+    точек, что примерно в восемь раз быстрее функции ak_wpoint_pow().
+
+    Для каждого окна скаляра \f$ k \f$ из таблицы просматриваются все 15 точек, при этом
+    нужная точка выбирается с помощью маски. Таким образом, последовательность обращений
+    к памяти не зависит от значения \f$ k \f$.
+
+    Для кривых в форме Вейерштрасса сложение выполняется с помощью полных формул
+    (функция ak_wpoint_add_complete()) для каждого окна, в том числе нулевого;
+    результат сложения для нулевого окна отбрасывается с помощью маски.
+    Тем самым последовательность выполняемых операций также не зависит от значения \f$ k \f$.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param wt Таблица кратных точек.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ec Эллиптическая кривая, на которой происходят вычисления.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_table_pow( ak_wpoint wq, ak_wpoint_table wt, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  struct wpoint Q, R, S;
+  size_t i = 0, j = 0, t = 0, stride = ak_wpoint_table_stride( ec );
+
+ /* для степеней, превышающих размер таблицы, используем лесенку Монтгомери */
+  for( i = wt->size; i < size; i++ )
+     if( k[i] ) {
+       ak_wpoint_pow( wq, &wt->point, k, size, ec );
+       return;
+     }
+  if( ec->ecurve != NULL ) {
+    ak_epoint_table_pow( wq, wt, k, size, ec );
+    return;
+  }
+
+  ak_wpoint_set_as_unit( &Q, ec );
+  memset( &S, 0, sizeof( struct wpoint ));
+  ak_mpzn_set_ui( S.z, ec->size, 1 );
+  ec->mul( S.z, S.z, ec->r2, ec->p, ec->n, ec->size );
+  for( i = 0; i < wt->count; i++ ) {
+     const ak_uint64 *ptr = wt->data + i*ak_wpoint_table_width*stride;
+     ak_uint64 digit = (( i >> 4 ) < size ) ? ( k[i >> 4] >> (( i&0xf ) << 2 ))&0xf : 0,
+               zmask = (( digit | ( 0 - digit )) >> 63 ) - 1;
+
+    /* выбираем точку [digit 16^i]P, просматривая всю строку таблицы */
+     for( t = 0; t < wt->size; t++ ) S.x[t] = S.y[t] = 0;
+     for( j = 0; j < ak_wpoint_table_width; j++ ) {
+        ak_uint64 diff = ( ak_uint64 )( j+1 ) ^ digit,
+                  mask = (( diff | ( 0 - diff )) >> 63 ) - 1;
+        for( t = 0; t < wt->size; t++ ) {
+           S.x[t] |= ptr[j*stride + t]&mask;
+           S.y[t] |= ptr[j*stride + wt->size + t]&mask;
+        }
+     }
+    /* сложение выполняется всегда; для нулевого окна его результат отбрасывается с помощью маски */
+     ak_wpoint_set_wpoint( &R, &Q, ec );
+     ak_wpoint_add_complete( &R, &S, ec );
+     for( t = 0; t < wt->size; t++ ) {
+        R.x[t] ^= zmask&( R.x[t]^Q.x[t] );
+        R.y[t] ^= zmask&( R.y[t]^Q.y[t] );
+        R.z[t] ^= zmask&( R.z[t]^Q.z[t] );
+     }
+     ak_wpoint_set_wpoint( &Q, &R, ec );
+  }
+  ak_wpoint_set_wpoint( wq, &Q, ec );
+  memset( &Q, 0, sizeof( struct wpoint ));
+  memset( &R, 0, sizeof( struct wpoint ));
+  memset( &S, 0, sizeof( struct wpoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество кривых, для образующих точек которых хранятся таблицы. */
+ #define ak_wcurve_tables_count  ( 16 )
+
+/*! \brief Таблицы кратных точек, вычисленные для образующих точек эллиптических кривых. */
+ static struct wcurve_table {
+  /*! \brief Эллиптическая кривая. */
+   ak_wcurve wc;
+  /*! \brief Таблица кратных точек для образующей точки кривой. */
+   struct wpoint_table table;
+ } wcurve_tables[ak_wcurve_tables_count];
+
+/*! \brief Количество вычисленных таблиц. */
+ static size_t wcurve_tables_used = 0;
+#ifdef AK_HAVE_PTHREAD_H
+/*! \brief Мьютекс, защищающий массив таблиц. */
+ static pthread_mutex_t wcurve_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает таблицу кратных точек для образующей точки кривой, вычисляя ее
+    при первом обращении. Если таблицу вычислить не удалось, возвращается NULL.
+
+    \details Кривая определяется как адресом контекста, так и значениями модуля и образующей
+    точки, поэтому повторное использование памяти для другой кривой не приводит к ошибке.         */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_wpoint_table ak_wcurve_get_table( ak_wcurve ec )
+{
+  size_t i = 0;
+  ak_wpoint_table wt = NULL;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &wcurve_tables_mutex );
+#endif
+  for( i = 0; i < wcurve_tables_used; i++ ) {
+     if(( wcurve_tables[i].wc == ec ) && ( wcurve_tables[i].table.size == ec->size ) &&
+        ( ak_mpzn_cmp( wcurve_tables[i].table.point.x, ec->point.x, ec->size ) == 0 ) &&
+        ( ak_mpzn_cmp( wcurve_tables[i].table.point.y, ec->point.y, ec->size ) == 0 )) {
+       wt = &wcurve_tables[i].table;
+       break;
+     }
+  }
+  if(( wt == NULL ) && ( wcurve_tables_used < ak_wcurve_tables_count )) {
+    if( ak_wpoint_table_create( &wcurve_tables[wcurve_tables_used].table,
+                                                           &ec->point, ec ) == ak_error_ok ) {
+      wcurve_tables[wcurve_tables_used].wc = ec;
+      wt = &wcurve_tables[wcurve_tables_used++].table;
+    }
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &wcurve_tables_mutex );
+#endif
+
+ return wt;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удаляет все таблицы, вычисленные функцией ak_wpoint_pow_base(), и вызывается
+    при завершении работы с библиотекой.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_destroy_tables( void )
+{
+  size_t i = 0;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &wcurve_tables_mutex );
+#endif
+  for( i = 0; i < wcurve_tables_used; i++ ) {
+     ak_wpoint_table_destroy( &wcurve_tables[i].table );
+     wcurve_tables[i].wc = NULL;
+  }
+  wcurve_tables_used = 0;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &wcurve_tables_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет кратную точку \f$ Q = [k]P \f$, где \f$ P \f$ - образующая точка
+    эллиптической кривой. При первом вызове для заданной кривой вычисляется таблица кратных
+    точек (см. ak_wpoint_table_create()), которая используется всеми последующими вызовами.
+    Если таблицу вычислить невозможно, используется функция ak_wpoint_pow().
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ec Эллиптическая кривая, на которой происходят вычисления.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_base( ak_wpoint wq, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  ak_wpoint_table wt = ak_wcurve_get_table( ec );
+
+  if( wt == NULL ) ak_wpoint_pow( wq, &ec->point, k, size, ec );
+   else ak_wpoint_table_pow( wq, wt, k, size, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                  вычисления, время выполнения которых зависит от скаляра                        */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ширина окна w для представления скаляра в форме wNAF. */
+ #define ak_wpoint_wnaf_width  ( 5 )
+/*! \brief Количество нечетных кратных точек \f$ P, 3P, \ldots, (2^{w-1}-1)P \f$. */
+ #define ak_wpoint_wnaf_count  ( 1 << ( ak_wpoint_wnaf_width - 2 ))
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет представление скаляра в форме wNAF.
+
+    Каждая цифра представления либо равна нулю, либо нечетна и по абсолютной величине
+    меньше \f$ 2^{w-1} \f$, при этом среди любых \f$ w \f$ последовательных цифр не более одной
+    отлично от нуля.
+
+    @param naf Массив, куда помещаются цифры (младшая цифра - первая); длина массива должна
+    быть не менее \f$ 64 \cdot size + 1 \f$.
+    @param k Скаляр.
+    @param size Размер скаляра в машинных словах (не более \ref ak_mpzn512_size).
+    @return Количество цифр представления.                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_mpzn_to_wnaf( signed char *naf, ak_uint64 *k, const size_t size )
+{
+  size_t i = 0, len = 0;
+  ak_uint64 t[ak_mpzn512_size+1];
+
+  memcpy( t, k, size*sizeof( ak_uint64 ));
+  t[size] = 0;
+  while( ak_mpzn_cmp_ui( t, size+1, 0 ) != ak_true ) {
+    int d = 0;
+    if( t[0]&1 ) {
+      d = ( int )( t[0]&(( 1 << ak_wpoint_wnaf_width ) - 1 ));
+      if( d >= ( 1 << ( ak_wpoint_wnaf_width - 1 ))) d -= ( 1 << ak_wpoint_wnaf_width );
+     /* t <- t - d */
+      if( d > 0 ) {
+        ak_uint64 borrow = ( ak_uint64 )d;
+        for( i = 0; ( i <= size ) && borrow; i++ ) {
+           ak_uint64 old = t[i];
+           t[i] -= borrow;
+           borrow = ( t[i] > old );
+        }
+      } else {
+          ak_uint64 carry = ( ak_uint64 )( -d );
+          for( i = 0; ( i <= size ) && carry; i++ ) {
+             t[i] += carry;
+             carry = ( t[i] < carry );
+          }
+        }
+    }
+    naf[len++] = ( signed char )d;
+   /* t <- t/2 */
+    for( i = 0; i < size; i++ ) t[i] = ( t[i] >> 1 )|( t[i+1] << 63 );
+    t[size] >>= 1;
+  }
+
+ return len;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заменяет точку \f$ P = (x:y:z) \f$ на противоположную \f$ -P = (x:-y:z) \f$. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_negate( ak_wpoint wp, ak_wcurve ec )
+{
+  if( ak_mpzn_cmp_ui( wp->y, ec->size, 0 ) != ak_true ) ak_mpzn_sub( wp->y, ec->p, wp->y, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция прибавляет к точке \f$ Q \f$, заданной в координатах Якоби, точку \f$ [k]P \f$,
+    где \f$ P \f$ - точка, для которой вычислена таблица; окна скаляра с нулевыми значениями
+    пропускаются.                                                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_table_add_vartime( ak_wpoint wq, ak_wpoint_table wt,
+                                                   ak_uint64 *k, const size_t size, ak_wcurve ec )
+{
+  struct wpoint S;
+  size_t i = 0, stride = ak_wpoint_table_stride( ec );
+
+  ak_mpzn_set_ui( S.z, wt->size, 1 );
+  for( i = 0; i < wt->count; i++ ) {
+     const ak_uint64 *ptr = NULL;
+     ak_uint64 digit = (( i >> 4 ) < size ) ? ( k[i >> 4] >> (( i&0xf ) << 2 ))&0xf : 0;
+     if( !digit ) continue;
+     ptr = wt->data + ( i*ak_wpoint_table_width + digit - 1 )*stride;
+     memcpy( S.x, ptr, wt->size*sizeof( ak_uint64 ));
+     memcpy( S.y, ptr + wt->size, wt->size*sizeof( ak_uint64 ));
+     ak_wpoint_add_mixed( wq, &S, ec );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция прибавляет к точке \f$ Q \f$ кривой Эдвардса точку \f$ [k]P \f$, где \f$ P \f$ -
+    точка, для которой вычислена таблица; окна скаляра с нулевыми значениями пропускаются.        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_table_add_vartime( ak_epoint eq, ak_wpoint_table wt,
+                                                   ak_uint64 *k, const size_t size, ak_wcurve ec )
+{
+  struct epoint S;
+  size_t i = 0, stride = ak_wpoint_table_stride( ec );
+
+  for( i = 0; i < wt->count; i++ ) {
+     const ak_uint64 *ptr = NULL;
+     ak_uint64 digit = (( i >> 4 ) < size ) ? ( k[i >> 4] >> (( i&0xf ) << 2 ))&0xf : 0;
+     if( !digit ) continue;
+     ptr = wt->data + ( i*ak_wpoint_table_width + digit - 1 )*stride;
+     memcpy( S.x, ptr, wt->size*sizeof( ak_uint64 ));
+     memcpy( S.y, ptr + wt->size, wt->size*sizeof( ak_uint64 ));
+     memcpy( S.t, ptr + 2*wt->size, wt->size*sizeof( ak_uint64 ));
+     ak_epoint_add( eq, &S, ak_true, ec );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет точку \f$ Q = [k_1]P + [k_2]R \f$ на эквивалентной кривой Эдвардса
+    (см. описание функции ak_wpoint_double_pow()).
+
+    @return Функция возвращает \ref ak_false, если точку \f$ R \f$ невозможно отобразить
+    на кривую Эдвардса; в этом случае значение \f$ Q \f$ не изменяется.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_epoint_double_pow( ak_wpoint wq, ak_uint64 *k1, ak_wpoint wr, ak_uint64 *k2,
+                                                                  size_t size, ak_wcurve ec )
+{
+  size_t i = 0, len = 0;
+  ak_wpoint_table wt = NULL;
+  struct epoint Q, R2, pre[ak_wpoint_wnaf_count], neg[ak_wpoint_wnaf_count];
+  signed char naf[64*ak_mpzn512_size+1];
+
+ /* нечетные кратные точки R и противоположные к ним */
+  if( ak_wpoint_to_epoint( pre, wr, ec ) != ak_true ) return ak_false;
+  R2 = pre[0];
+  ak_epoint_double( &R2, ec );
+  for( i = 1; i < ak_wpoint_wnaf_count; i++ ) {
+     pre[i] = pre[i-1];
+     ak_epoint_add( pre+i, &R2, ak_false, ec );
+  }
+  for( i = 0; i < ak_wpoint_wnaf_count; i++ ) {
+     neg[i] = pre[i];
+     ak_epoint_negate( neg+i, ec );
+  }
+
+ /* вычисляем [k2]R */
+  ak_epoint_set_as_unit( &Q, ec );
+  len = ak_mpzn_to_wnaf( naf, k2, size );
+  while( len > 0 ) {
+    int d = naf[--len];
+    ak_epoint_double( &Q, ec );
+    if( d > 0 ) ak_epoint_add( &Q, pre + ( d >> 1 ), ak_false, ec );
+    if( d < 0 ) ak_epoint_add( &Q, neg + (( -d ) >> 1 ), ak_false, ec );
+  }
+
+ /* прибавляем [k1]P; кратные образующей точки всегда отображаются на кривую Эдвардса */
+  if(( wt = ak_wcurve_get_table( ec )) != NULL ) ak_epoint_table_add_vartime( &Q, wt, k1, size, ec );
+   else {
+     struct wpoint S;
+     ak_wpoint_pow( &S, &ec->point, k1, size, ec );
+     if( ak_wpoint_to_epoint( &R2, &S, ec )) ak_epoint_add( &Q, &R2, ak_false, ec );
+   }
+  ak_epoint_to_wpoint( wq, &Q, ec );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ Q = [k_1]P + [k_2]R \f$, где \f$ P \f$ - образующая точка
+    эллиптической кривой, а \f$ R \f$ - произвольная точка. Кратная образующей точки вычисляется
+    с помощью таблицы (см. ak_wpoint_pow_base()), кратная точки \f$ R \f$ - с помощью
+    представления скаляра \f$ k_2 \f$ в форме wNAF и заранее вычисленных нечетных кратных
+    точки \f$ R \f$. По сравнению с двумя вызовами функции ak_wpoint_pow() количество
+    операций с точками уменьшается примерно в три раза.
+
+    \warning Время выполнения функции зависит от значений скаляров, поэтому функция
+    предназначена только для операций с открытыми данными, например, для проверки
+    электронной подписи.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k1 Скаляр \f$ k_1 \f$.
+    @param wr Точка \f$ R \f$.
+    @param k2 Скаляр \f$ k_2 \f$.
+    @param size Размер скаляров в машинных словах (не более размера параметров кривой).
+    @param ec Эллиптическая кривая, на которой происходят вычисления.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_double_pow( ak_wpoint wq, ak_uint64 *k1, ak_wpoint wr, ak_uint64 *k2,
+                                                                  size_t size, ak_wcurve ec )
+{
+  size_t i = 0, len = 0;
+  ak_wpoint_table wt = NULL;
+  struct wpoint Q, R2, pre[ak_wpoint_wnaf_count], neg[ak_wpoint_wnaf_count];
+  signed char naf[64*ak_mpzn512_size+1];
+
+  if( size > ec->size ) size = ec->size;
+  if(( ec->ecurve != NULL ) && ak_epoint_double_pow( wq, k1, wr, k2, size, ec )) return;
+
+ /* нечетные кратные точки R и противоположные к ним (в координатах Якоби) */
+  ak_wpoint_to_jacobian( pre, wr, ec );
+  ak_wpoint_set_wpoint( &R2, pre, ec );
+  ak_wpoint_double_jacobian( &R2, ec );
+  for( i = 1; i < ak_wpoint_wnaf_count; i++ ) {
+     ak_wpoint_set_wpoint( pre+i, pre+i-1, ec );
+     ak_wpoint_add_jacobian( pre+i, &R2, ec );
+  }
+  for( i = 0; i < ak_wpoint_wnaf_count; i++ ) {
+     ak_wpoint_set_wpoint( neg+i, pre+i, ec );
+     ak_wpoint_negate( neg+i, ec );
+  }
+
+ /* вычисляем [k2]R */
+  ak_wpoint_set_as_unit( &Q, ec );
+  len = ak_mpzn_to_wnaf( naf, k2, size );
+  while( len > 0 ) {
+    int d = naf[--len];
+    ak_wpoint_double_jacobian( &Q, ec );
+    if( d > 0 ) ak_wpoint_add_jacobian( &Q, pre + ( d >> 1 ), ec );
+    if( d < 0 ) ak_wpoint_add_jacobian( &Q, neg + (( -d ) >> 1 ), ec );
+  }
+
+ /* прибавляем [k1]P */
+  if(( wt = ak_wcurve_get_table( ec )) != NULL ) ak_wpoint_table_add_vartime( &Q, wt, k1, size, ec );
+   else {
+     ak_wpoint_pow( &R2, &ec->point, k1, size, ec );
+     ak_wpoint_to_jacobian( &R2, &R2, ec );
+     ak_wpoint_add_jacobian( &Q, &R2, ec );
+   }
+  ak_wpoint_from_jacobian( wq, &Q, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ Q = [k_1]P + [k_2]R \f$, где \f$ P \f$ - образующая точка
+    эллиптической кривой, а для точки \f$ R \f$ заранее вычислена таблица кратных точек.
+    В этом случае обе кратные точки вычисляются только с помощью сложений, а окна скаляров
+    с нулевыми значениями пропускаются.
+
+    \warning Время выполнения функции зависит от значений скаляров, поэтому функция
+    предназначена только для операций с открытыми данными.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k1 Скаляр \f$ k_1 \f$.
+    @param wt Таблица кратных точек для точки \f$ R \f$.
+    @param k2 Скаляр \f$ k_2 \f$.
+    @param size Размер скаляров в машинных словах (не более размера параметров кривой).
+    @param ec Эллиптическая кривая, на которой происходят вычисления.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_double_pow_table( ak_wpoint wq, ak_uint64 *k1, ak_wpoint_table wt,
+                                                      ak_uint64 *k2, size_t size, ak_wcurve ec )
+{
+  struct wpoint Q;
+  ak_wpoint_table bt = ak_wcurve_get_table( ec );
+
+  if( size > ec->size ) size = ec->size;
+  if( ec->ecurve != NULL ) {
+    struct epoint E, S;
+    ak_epoint_set_as_unit( &E, ec );
+    ak_epoint_table_add_vartime( &E, wt, k2, size, ec );
+    if( bt != NULL ) ak_epoint_table_add_vartime( &E, bt, k1, size, ec );
+     else {
+       ak_wpoint_pow( &Q, &ec->point, k1, size, ec );
+       if( ak_wpoint_to_epoint( &S, &Q, ec )) ak_epoint_add( &E, &S, ak_false, ec );
+     }
+    ak_epoint_to_wpoint( wq, &E, ec );
+    return;
+  }
+  ak_wpoint_set_as_unit( &Q, ec );
+  ak_wpoint_table_add_vartime( &Q, wt, k2, size, ec );
+  if( bt != NULL ) ak_wpoint_table_add_vartime( &Q, bt, k1, size, ec );
+   else {
+     struct wpoint S;
+     ak_wpoint_pow( &S, &ec->point, k1, size, ec );
+     ak_wpoint_to_jacobian( &S, &S, ec );
+     ak_wpoint_add_jacobian( &Q, &S, ec );
+   }
+  ak_wpoint_from_jacobian( wq, &Q, ec );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                    ak_curves.c  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -268,6 +268,8 @@
 
  /* заполняем данные */
   file->size = ( ak_int64 )st.st_size;
+  file->mmaddr = NULL;
+  file->mmsize = 0;
  #ifdef AK_HAVE_WINDOWS_H
   if(( file->hFile = CreateFile( filename,   /* name of the write */
                      GENERIC_READ,           /* open for reading */
@@ -308,6 +310,8 @@
     return ak_error_message( ak_error_null_pointer, __func__, "using null pointer" );
 
   file->size = 0;
+  file->mmaddr = NULL;
+  file->mmsize = 0;
  #ifdef AK_HAVE_WINDOWS_H
   if(( file->hFile = CreateFile( filename,   /* name of the write */
                      GENERIC_WRITE,          /* open for writing */
@@ -338,6 +342,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_file_close( ak_file file )
 {
+   if( file->mmaddr != NULL ) ak_file_unmap( file, file->mmaddr );
    file->size = 0;
    file->blksize = 0;
   #ifdef AK_HAVE_WINDOWS_H
@@ -414,18 +419,118 @@
 /* ----------------------------------------------------------------------------------------------- */
                    /* Отображение файлов в память (обертка вокруг mmap) */
 /* ----------------------------------------------------------------------------------------------- */
- ak_pointer ak_file_mmap( ak_file file, const char *filename,
-                                                     const filestate_t state, const size_t offset )
+/*! Функция отображает в память фрагмент файла, открытого ранее с помощью функций
+    ak_file_open_to_read() или ak_file_create_to_write(). Одновременно может быть отображен только
+    один фрагмент файла; при повторном вызове ранее отображенный фрагмент освобождается.
+    Для отображаемой области устанавливается режим последовательного чтения,
+    что позволяет ядру выполнять упреждающее считывание страниц.
+
+    \note Функция изменила сигнатуру: прежний вариант
+    `ak_file_mmap( ak_file, const char *, const filestate_t, const size_t )` не был реализован
+    и всегда возвращал NULL. Теперь функция работает с уже открытым файлом, а вместо имени
+    файла принимает смещение и размер отображаемого фрагмента. Программы, вызывавшие прежний
+    вариант функции, должны быть изменены.
+
+    \param file Контекст открытого файла.
+    \param state Режим доступа к отображаемой области памяти.
+    \param offset Смещение фрагмента от начала файла; должно быть кратно размеру страницы.
+    \param size Размер фрагмента в октетах.
+    \return В случае успеха функция возвращает указатель на начало отображенного фрагмента.
+    В случае ошибки возвращается NULL, а код ошибки может быть получен с помощью вызова
+    функции ak_error_get_value().                                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_pointer ak_file_mmap( ak_file file, const filestate_t state,
+                                                       const ak_int64 offset, const size_t size )
 {
- /* в ситуациях, когда mmap не определена, сразу выходим */
-#ifndef AK_HAVE_WINDOWS_H
- #ifndef AK_HAVE_SYSMMAN_H
-   return ak_error_undefined_function;
+#ifdef AK_HAVE_SYSMMAN_H
+  int prot = PROT_READ;
+  ak_pointer addr = NULL;
+
+  if( file == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to file context" );
+    return NULL;
+  }
+  if(( !size ) || ( offset < 0 )) {
+    ak_error_message( ak_error_wrong_length, __func__, "using wrong fragment of file" );
+    return NULL;
+  }
+  if( file->mmaddr != NULL ) ak_file_unmap( file, file->mmaddr );
+
+  switch( state ) {
+    case readonly: prot = PROT_READ; break;
+    case writeonly: prot = PROT_WRITE; break;
+    case readwrite: prot = PROT_READ | PROT_WRITE; break;
+  }
+  if(( addr = mmap( NULL, size, prot, state == readonly ? MAP_PRIVATE : MAP_SHARED,
+                                        file->fd, ( off_t )offset )) == MAP_FAILED ) {
+    if( ak_log_get_level() >= ak_log_maximum )
+      ak_error_message_fmt( ak_error_mmap_file, __func__,
+                                          "wrong mapping of file fragment [%s]", strerror( errno ));
+    ak_error_set_value( ak_error_mmap_file );
+    return NULL;
+  }
+ #ifdef MADV_SEQUENTIAL
+  madvise( addr, size, MADV_SEQUENTIAL );
  #endif
-#endif
+  file->mmaddr = addr;
+  file->mmsize = size;
 
- ak_error_message( ak_error_undefined_function, __func__, "this function is'nt well developed" );
+ return addr;
+#else
+  ( void )file; ( void )state; ( void )offset; ( void )size;
+  ak_error_message( ak_error_undefined_function, __func__,
+                                             "memory mapping of files is not supported on this system" );
  return NULL;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param file Контекст открытого файла.
+    \param addr Указатель, возвращенный функцией ak_file_mmap().
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_unmap( ak_file file, ak_pointer addr )
+{
+  if(( file == NULL ) || ( addr == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__, "using null pointer" );
+  if( addr != file->mmaddr )
+    return ak_error_message( ak_error_mmap_file, __func__, "unmapping of unknown memory area" );
+#ifdef AK_HAVE_SYSMMAN_H
+  if( munmap( addr, file->mmsize ) != 0 )
+    return ak_error_message_fmt( ak_error_mmap_file, __func__,
+                                      "wrong unmapping of file fragment [%s]", strerror( errno ));
+#endif
+  file->mmaddr = NULL;
+  file->mmsize = 0;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция сообщает операционной системе, что заданный фрагмент файла вскоре будет прочитан.
+    Считывание данных с диска выполняется ядром асинхронно, поэтому вызывающая сторона может
+    в это время обрабатывать ранее считанные данные. Если система не поддерживает
+    соответствующий механизм, функция ничего не делает.
+
+    \param file Контекст открытого файла.
+    \param offset Смещение фрагмента от начала файла.
+    \param size Размер фрагмента в октетах.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_prefetch( ak_file file, const ak_int64 offset, const size_t size )
+{
+  if( file == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                             "using null pointer to file context" );
+#ifdef POSIX_FADV_WILLNEED
+  if( posix_fadvise( file->fd, ( off_t )offset, ( off_t )size, POSIX_FADV_WILLNEED ) != 0 )
+    return ak_error_message( ak_error_read_data, __func__, "incorrect prefetching of file data" );
+#else
+  ( void )offset; ( void )size;
+#endif
+
+ return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
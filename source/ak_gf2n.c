@@ -5,11 +5,19 @@
 /*  Файл ak_gf2n.c                                                                                 */
 /*  - содержит реализацию функций умножения элементов конечных полей характеристики 2.             */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
  #include <wmmintrin.h>
+ /* функции, использующие команду PCLMULQDQ, компилируются для расширенного набора инструкций
+    вне зависимости от флагов компиляции; их вызов производится только после проверки того,
+    что расширение поддерживается процессором */
+ #if defined( __GNUC__ ) || defined( __clang__ )
+  #define ak_target_clmul __attribute__(( target( "pclmul,sse2" )))
+ #else
+  #define ak_target_clmul
+ #endif
 #endif
 #ifdef _MSC_VER
  #include <stdlib.h>
@@ -288,7 +296,7 @@
     \f$ f(x) = x^{64} + x^4 + x^3 + x + 1 \in \mathbb F_2[x]\f$. Для умножения используется
     реализация с помощью команды PCLMULQDQ.                                                        */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_gf64_mul_pcmulqdq( ak_pointer z, ak_pointer x, ak_pointer y )
+ ak_target_clmul void ak_gf64_mul_pcmulqdq( ak_pointer z, ak_pointer x, ak_pointer y )
 {
 #ifdef _MSC_VER
 	 __m128i gm, xm, ym, cm, cx;
@@ -328,7 +336,7 @@
     \f$ f(x) = x^{128} + x^7 + x^2 + x + 1 \in \mathbb F_2[x]\f$. Для умножения используется
     реализация с помощью команды PCLMULQDQ.                                                        */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_gf128_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
+ ak_target_clmul void ak_gf128_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 {
 #ifdef _MSC_VER
 	 __m128i am, bm, cm, dm, em, fm;
@@ -380,7 +388,7 @@
     \f$ f(x) = x^{256} + x^10 + x^5 + x^2 + 1 \in \mathbb F_2[x]\f$. Для умножения используется
     реализация с помощью команды PCLMULQDQ.                                                        */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_gf256_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
+ ak_target_clmul void ak_gf256_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 {
 #ifdef _MSC_VER
      __m128i a1a0, a3a2, b1b0, b3b2;
@@ -497,7 +505,7 @@
     реализация с помощью команды PCLMULQDQ.
     \todo может быть имеет смысл разбить на 2 ifdef, а середину сделать общей?                     */
 /* ----------------------------------------------------------------------------------------------- */
-void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
+ ak_target_clmul void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 {
 #ifdef _MSC_VER
      __m128i a1a0, a3a2, a5a4, a7a6, b1b0, b3b2, b5b4, b7b6;
@@ -787,6 +795,323 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
 
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                         оконные (табличные) методы умножения                                    */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает младшие члены \f$ f(x) - x^n \f$ многочлена, порождающего поле,
+    по количеству 64-х битных слов в элементе поля. */
+ static inline ak_uint64 ak_gf2n_low_terms( const size_t n )
+{
+  switch( n ) {
+    case 1: return 0x1B;
+    case 2: return 0x87;
+    case 4: return 0x425;
+    default: return 0x125;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция копирует элемент поля, преобразуя порядок байт в машинных словах
+    на платформах с порядком big endian. */
+ static inline void ak_gf2n_copy( ak_uint64 *z, const ak_pointer x, const size_t n )
+{
+#ifdef AK_LITTLE_ENDIAN
+  memcpy( z, x, n*sizeof( ak_uint64 ));
+#else
+  size_t i = 0;
+  for( i = 0; i < n; i++ ) z[i] = bswap_64( ((ak_uint64 *)x)[i] );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет произведение многочлена \f$ b(x) \f$ на многочлен `low`, степень
+    которого меньше 16. Поскольку значение `low` является константой поля, при подстановке
+    функции компилятор оставляет только сдвиги, соответствующие ненулевым коэффициентам;
+    вычисления не содержат ветвлений, зависящих от значения \f$ b(x) \f$. */
+ static inline ak_uint64 ak_gf2n_reduce_word( const ak_uint64 b, const ak_uint64 low )
+{
+  size_t k = 0;
+  ak_uint64 r = 0;
+
+  for( k = 0; k < 16; k++ ) if(( low >> k )&1 ) r ^= ( b << k );
+ return r;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет таблицу значений \f$ t_i = i(x)y(x) \pmod{f(x)} \f$ для всех
+    многочленов \f$ i(x) \f$, степень которых меньше `w`. */
+ static inline void ak_gf2n_window_table( ak_uint64 *t, const ak_uint64 *y,
+                                              const size_t n, const ak_uint64 low, const size_t w )
+{
+  size_t j = 0, k = 0, m = 0;
+  ak_uint64 *prev = NULL, *cur = NULL, carry = 0;
+
+  memset( t, 0, n*sizeof( ak_uint64 ));
+  memcpy( t+n, y, n*sizeof( ak_uint64 ));
+  for( k = 2; k < ( (size_t)1 << w ); k <<= 1 ) {
+    /* t[k] = x*t[k/2] */
+     prev = t + ( k >> 1 )*n; cur = t + k*n;
+     carry = prev[n-1] >> 63;
+     for( j = n-1; j > 0; j-- ) cur[j] = ( prev[j] << 1 )^( prev[j-1] >> 63 );
+     cur[0] = ( prev[0] << 1 )^(( (ak_uint64)0 - carry )&low );
+    /* t[k+m] = t[k] + t[m] */
+     for( m = 1; m < k; m++ )
+        for( j = 0; j < n; j++ ) t[( k+m )*n+j] = cur[j]^t[m*n+j];
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет произведение \f$ z = xy \f$ по таблице значений \f$ t_i = i(x)y(x) \f$,
+    обрабатывая многочлен \f$ x \f$ блоками по `w` бит, начиная со старших. */
+ static inline void ak_gf2n_window_mul( ak_uint64 *z, const ak_uint64 *x, const ak_uint64 *t,
+                                              const size_t n, const ak_uint64 low, const size_t w )
+{
+  size_t i = 0, j = 0, s = 0;
+  ak_uint64 acc[8], top = 0;
+  const ak_uint64 *e = NULL, mask = ( (ak_uint64)1 << w ) - 1;
+
+  memset( acc, 0, sizeof( acc ));
+  for( i = n; i > 0; i-- ) {
+     for( s = 64; s > 0; s -= w ) {
+       /* acc = x^w*acc (mod f(x)) */
+        top = acc[n-1] >> ( 64 - w );
+        for( j = n-1; j > 0; j-- ) acc[j] = ( acc[j] << w )^( acc[j-1] >> ( 64 - w ));
+        acc[0] = ( acc[0] << w )^ak_gf2n_reduce_word( top, low );
+       /* acc = acc + b(x)y(x), где b(x) - очередные w бит множителя */
+        e = t + (( x[i-1] >> ( s - w ))&mask )*n;
+        for( j = 0; j < n; j++ ) acc[j] ^= e[j];
+     }
+  }
+  memcpy( z, acc, n*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение элементов поля из `n` слов оконным методом с шириной окна 4 бита. */
+ static inline void ak_gf2n_mul_window4( ak_pointer z, ak_pointer x, ak_pointer y, const size_t n )
+{
+  ak_uint64 xv[8], yv[8], t[16*8];
+  const ak_uint64 low = ak_gf2n_low_terms( n );
+
+  ak_gf2n_copy( xv, x, n );
+  ak_gf2n_copy( yv, y, n );
+  ak_gf2n_window_table( t, yv, n, low, 4 );
+  ak_gf2n_window_mul( xv, xv, t, n, low, 4 );
+  ak_gf2n_copy( z, xv, n );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует операцию умножения двух элементов конечного поля \f$ \mathbb F_{2^{64}}\f$,
+    порожденного неприводимым многочленом
+    \f$ f(x) = x^{64} + x^4 + x^3 + x + 1 \in \mathbb F_2[x]\f$. Для умножения используется
+    оконный метод с шириной окна 4 бита: вычисляются 16 кратных значений множителя `y`,
+    после чего множитель `x` обрабатывается блоками по 4 бита. Функция используется
+    в качестве переносимой реализации при отсутствии команды PCLMULQDQ.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf64_mul_window( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf2n_mul_window4( z, x, y, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует операцию умножения двух элементов конечного поля \f$ \mathbb F_{2^{128}}\f$
+    оконным методом (см. описание функции ak_gf64_mul_window()).                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf128_mul_window( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf2n_mul_window4( z, x, y, 2 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует операцию умножения двух элементов конечного поля \f$ \mathbb F_{2^{256}}\f$
+    оконным методом (см. описание функции ak_gf64_mul_window()).                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf256_mul_window( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf2n_mul_window4( z, x, y, 4 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует операцию умножения двух элементов конечного поля \f$ \mathbb F_{2^{512}}\f$
+    оконным методом (см. описание функции ak_gf64_mul_window()).                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf512_mul_window( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf2n_mul_window4( z, x, y, 8 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет таблицу кратных значений множителя `h` для последующего
+    многократного умножения на него с помощью функции ak_gf2n_table_mul().
+
+    Если ширина окна равна нулю, то она выбирается автоматически: при использовании
+    библиотекой команды PCLMULQDQ таблица не вычисляется, и умножение выполняется
+    функциями ak_gf64_mul(), ..., ak_gf512_mul(); в противном случае используется
+    окно шириной 8 бит.
+
+    \note Как и другие табличные реализации, обращения к памяти при умножении зависят от
+    значения множителя, передаваемого в функцию ak_gf2n_table_mul().
+
+    @param tab Контекст таблицы
+    @param h Фиксированный множитель
+    @param size Размер элемента поля в октетах (\ref ak_galois64_size, \ref ak_galois128_size,
+    \ref ak_galois256_size или \ref ak_galois512_size)
+    @param window Ширина окна в битах: 0, 4 или 8.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_gf2n_table_create( ak_gf2n_table tab, const ak_pointer h, const size_t size,
+                                                                              const size_t window )
+{
+  ak_uint64 yv[8];
+
+  if( tab == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                  "using null pointer to table" );
+  if( h == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                            "using null pointer to multiplier" );
+  if(( size != ak_galois64_size ) && ( size != ak_galois128_size ) &&
+     ( size != ak_galois256_size ) && ( size != ak_galois512_size ))
+    return ak_error_message( ak_error_wrong_length, __func__,
+                                                  "using unsupported size of finite field element" );
+  if(( window != 0 ) && ( window != 4 ) && ( window != 8 ))
+    return ak_error_message( ak_error_wrong_length, __func__, "using unsupported window width" );
+
+  memset( tab->h, 0, sizeof( tab->h ));
+  memcpy( tab->h, h, size );
+  tab->n = size >> 3;
+  tab->window = window;
+  if(( tab->window == 0 ) && !( ak_libakrypt_get_cpu_features()&ak_cpu_feature_clmul ))
+    tab->window = 8;
+
+  if( tab->window ) {
+    ak_gf2n_copy( yv, h, tab->n );
+    ak_gf2n_window_table( tab->t, yv, tab->n, ak_gf2n_low_terms( tab->n ), tab->window );
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение \f$ z = xh \f$, где \f$ h \f$ -- фиксированный множитель,
+    для которого ранее была вычислена таблица. Допускается совпадение указателей `z` и `x`.
+
+    @param tab Контекст таблицы, созданный функцией ak_gf2n_table_create()
+    @param z Указатель на результат умножения
+    @param x Указатель на множитель                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf2n_table_mul( ak_gf2n_table tab, ak_pointer z, const ak_pointer x )
+{
+  ak_uint64 xv[8];
+
+  if( tab->window == 0 ) {
+    switch( tab->n ) {
+      case 1: ak_gf64_mul( z, x, tab->h ); break;
+      case 2: ak_gf128_mul( z, x, tab->h ); break;
+      case 4: ak_gf256_mul( z, x, tab->h ); break;
+      default: ak_gf512_mul( z, x, tab->h ); break;
+    }
+    return;
+  }
+
+ /* вызовы с постоянными параметрами позволяют компилятору развернуть внутренние циклы */
+  ak_gf2n_copy( xv, x, tab->n );
+  if( tab->window == 8 ) {
+    switch( tab->n ) {
+      case 1: ak_gf2n_window_mul( xv, xv, tab->t, 1, 0x1B, 8 ); break;
+      case 2: ak_gf2n_window_mul( xv, xv, tab->t, 2, 0x87, 8 ); break;
+      case 4: ak_gf2n_window_mul( xv, xv, tab->t, 4, 0x425, 8 ); break;
+      default: ak_gf2n_window_mul( xv, xv, tab->t, 8, 0x125, 8 ); break;
+    }
+  } else {
+    switch( tab->n ) {
+      case 1: ak_gf2n_window_mul( xv, xv, tab->t, 1, 0x1B, 4 ); break;
+      case 2: ak_gf2n_window_mul( xv, xv, tab->t, 2, 0x87, 4 ); break;
+      case 4: ak_gf2n_window_mul( xv, xv, tab->t, 4, 0x425, 4 ); break;
+      default: ak_gf2n_window_mul( xv, xv, tab->t, 8, 0x125, 4 ); break;
+    }
+  }
+  ak_gf2n_copy( z, xv, tab->n );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Тип функции умножения двух элементов конечного поля. */
+ typedef void ( ak_function_gf_mul )( ak_pointer , ak_pointer , ak_pointer );
+
+/*! \brief Указатели на реализации умножения, выбранные при инициализации библиотеки
+    (по умолчанию используются переносимые реализации оконного метода). */
+ static ak_function_gf_mul *ak_gf64_mul_function = ak_gf64_mul_window;
+ static ak_function_gf_mul *ak_gf128_mul_function = ak_gf128_mul_window;
+ static ak_function_gf_mul *ak_gf256_mul_function = ak_gf256_mul_window;
+ static ak_function_gf_mul *ak_gf512_mul_function = ak_gf512_mul_window;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выбирает реализации умножения элементов конечных полей в соответствии
+    с набором доступных расширений процессора. Реализации, использующие команду PCLMULQDQ,
+    выбираются только в случае, если библиотека собрана с их поддержкой и
+    в маске `features` установлен флаг \ref ak_cpu_feature_clmul; в противном случае
+    используются переносимые реализации оконного метода.
+
+    @param features Маска расширений процессора, которые разрешено использовать.
+    @return Функция возвращает маску реально используемых расширений.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint32 ak_gf2n_set_functions( const ak_uint32 features )
+{
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+  if( features&ak_cpu_feature_clmul ) {
+    ak_gf64_mul_function = ak_gf64_mul_pcmulqdq;
+    ak_gf128_mul_function = ak_gf128_mul_pcmulqdq;
+    ak_gf256_mul_function = ak_gf256_mul_pcmulqdq;
+    ak_gf512_mul_function = ak_gf512_mul_pcmulqdq;
+    return ak_cpu_feature_clmul;
+  }
+#else
+  (void) features;
+#endif
+  ak_gf64_mul_function = ak_gf64_mul_window;
+  ak_gf128_mul_function = ak_gf128_mul_window;
+  ak_gf256_mul_function = ak_gf256_mul_window;
+  ak_gf512_mul_function = ak_gf512_mul_window;
+ return 0;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывает реализацию умножения в поле \f$ \mathbb F_{2^{64}}\f$, выбранную
+    при инициализации библиотеки: ak_gf64_mul_pcmulqdq() или ak_gf64_mul_window().
+
+    @param z Указатель на результат умножения
+    @param x Указатель на левый множитель
+    @param y Указатель на правый множитель                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf64_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf64_mul_function( z, x, y );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывает реализацию умножения в поле \f$ \mathbb F_{2^{128}}\f$, выбранную
+    при инициализации библиотеки. Параметры аналогичны параметрам функции ak_gf64_mul().           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf128_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf128_mul_function( z, x, y );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывает реализацию умножения в поле \f$ \mathbb F_{2^{256}}\f$, выбранную
+    при инициализации библиотеки. Параметры аналогичны параметрам функции ak_gf64_mul().           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf256_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf256_mul_function( z, x, y );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывает реализацию умножения в поле \f$ \mathbb F_{2^{512}}\f$, выбранную
+    при инициализации библиотеки. Параметры аналогичны параметрам функции ak_gf64_mul().           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf512_mul( ak_pointer z, ak_pointer x, ak_pointer y )
+{
+  ak_gf512_mul_function( z, x, y );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Тестирование операции умножения в поле \f$ \mathbb F_{2^{64}}\f$. */
  static bool_t ak_gf64_multiplication_test( void )
@@ -841,6 +1166,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
   }
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( !( ak_libakrypt_get_cpu_features()&ak_cpu_feature_clmul )) return ak_true;
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
@@ -930,6 +1256,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
  if( !ak_ptr_is_equal_with_log( result, m8, 16 )) goto lexit;
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( !( ak_libakrypt_get_cpu_features()&ak_cpu_feature_clmul )) return ak_true;
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
@@ -1004,6 +1331,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
   }
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( !( ak_libakrypt_get_cpu_features()&ak_cpu_feature_clmul )) return ak_true;
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
@@ -1088,6 +1416,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
   }
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ if( !( ak_libakrypt_get_cpu_features()&ak_cpu_feature_clmul )) return ak_true;
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "comparison between two implementations included");
 
@@ -1136,6 +1465,56 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сравнение оконных и табличных реализаций умножения с простейшей реализацией. */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_gf2n_window_multiplication_test( void )
+{
+  size_t i = 0, j = 0, f = 0;
+  struct gf2n_table tab4, tab8, tab0;
+  ak_uint64 x[8], h[8], z1[8], z2[8], z3[8], z4[8], z5[8];
+  const size_t sizes[4] = { ak_galois64_size, ak_galois128_size,
+                                                             ak_galois256_size, ak_galois512_size };
+  ak_function_gf_mul *uint64[4] = { ak_gf64_mul_uint64, ak_gf128_mul_uint64,
+                                                         ak_gf256_mul_uint64, ak_gf512_mul_uint64 };
+  ak_function_gf_mul *window[4] = { ak_gf64_mul_window, ak_gf128_mul_window,
+                                                         ak_gf256_mul_window, ak_gf512_mul_window };
+
+  for( f = 0; f < 4; f++ ) {
+    /* множитель, для которого вычисляются таблицы */
+     for( j = 0; j < 8; j++ ) {
+        h[j] = 0xa5c3e1f00f1e3c5aLL*( j+1 ) ^ ( 0x1234567LL << j );
+        x[j] = 0x0123456789abcdefLL ^ ( 0xfedcbaLL*( j+3 ));
+     }
+     ak_gf2n_table_create( &tab4, h, sizes[f], 4 );
+     ak_gf2n_table_create( &tab8, h, sizes[f], 8 );
+     ak_gf2n_table_create( &tab0, h, sizes[f], 0 );
+
+     for( i = 0; i < 256; i++ ) {
+        uint64[f]( z1, x, h );
+        window[f]( z2, x, h );
+        ak_gf2n_table_mul( &tab4, z3, x );
+        ak_gf2n_table_mul( &tab8, z4, x );
+        ak_gf2n_table_mul( &tab0, z5, x );
+        if( !ak_ptr_is_equal( z1, z2, sizes[f] ) || !ak_ptr_is_equal( z1, z3, sizes[f] ) ||
+            !ak_ptr_is_equal( z1, z4, sizes[f] ) || !ak_ptr_is_equal( z1, z5, sizes[f] )) {
+          ak_error_message_fmt( ak_error_not_equal_data, __func__,
+                    "window multiplication differs from standard method in GF(2^%u) on iteration %u",
+                                                    (unsigned int)( sizes[f] << 3 ), (unsigned int)i );
+          return ak_false;
+        }
+       /* следующий множитель получается из результата умножения,
+          поэтому в вычислениях участвуют все старшие биты */
+        memcpy( x, z1, sizes[f] );
+        x[0] ^= (ak_uint64) i;
+     }
+  }
+  if( ak_log_get_level() >= ak_log_maximum )
+    ak_error_message( ak_error_ok, __func__,
+                                     "comparison of window and table multiplications is Ok");
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_libakrypt_test_gfn_multiplication( void )
 {
@@ -1145,7 +1524,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
    ak_error_message( ak_error_ok, __func__ , "testing the Galois fileds arithmetic started");
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
- if( audit >= ak_log_maximum )
+ if(( audit >= ak_log_maximum ) && ( ak_libakrypt_get_cpu_features()&ak_cpu_feature_clmul ))
    ak_error_message( ak_error_ok, __func__ ,
                                       "using pcmulqdq for multiplication in finite Galois fields");
 #endif
@@ -1182,6 +1561,14 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
       ak_error_message( ak_error_get_value(), __func__ , "multiplication test in GF(2^512) is OK");
 
 
+ if( ak_gf2n_window_multiplication_test( ) != ak_true ) {
+   ak_error_message( ak_error_get_value(), __func__ , "incorrect window multiplication test");
+   return ak_false;
+ } else
+    if( audit >= ak_log_maximum )
+      ak_error_message( ak_error_get_value(), __func__ , "window multiplication test is OK");
+
+
  if( audit >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__ ,
                                         "testing the Galois fileds arithmetic ended successfully");
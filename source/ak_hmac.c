@@ -18,6 +18,15 @@
  #error Library cannot be compiled without string.h header
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Состояния функции хеширования после обработки маскированных значений ключа. */
+ typedef struct hmac_midstates {
+  /*! \brief Состояние после обработки блока, содержащего ключ, сложенный с ipad */
+   struct streebog ipad;
+  /*! \brief Состояние после обработки блока, содержащего ключ, сложенный с opad */
+   struct streebog opad;
+ } *ak_hmac_midstates;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Очистка контекста алгоритма hmac.
     \param ctx Контекст алгоритма HMAC выработки имитовставки.
@@ -488,11 +497,327 @@
  return hctx->mctx.bsize;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                 вычисление hmac с использованием предвычисленных состояний                      */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет состояния функции хеширования, возникающие после обработки
+    блоков, содержащих значения ключа, сложенные с константами ipad и opad.
+
+    Предвычисленные состояния позволяют многократно вычислять значение имитовставки
+    для коротких сообщений без повторной обработки блоков, зависящих от ключа.
+    При вызове функции ресурс ключа уменьшается на единицу.
+
+    \param hctx Контекст алгоритма HMAC с установленным значением ключа.
+    \param ms Структура, в которую помещаются вычисленные состояния.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_midstates_create( ak_hmac hctx, ak_hmac_midstates ms )
+{
+  int error = ak_error_ok;
+  size_t idx = 0, jdx = 0, len = 0;
+  ak_uint8 buffer[64]; /* буффер для хранения маскированного значения ключа */
+
+  if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                      "using a null pointer to hmac key context" );
+  if( ms == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                     "using a null pointer to hmac midstates" );
+  if( !((hctx->key.flags)&ak_key_flag_set_key )) return ak_error_message( ak_error_key_value,
+                                               __func__ , "using hmac key with unassigned value" );
+  if( hctx->key.resource.value.counter <= 0 ) return ak_error_message( ak_error_low_key_resource,
+                                            __func__, "using hmac key context with low resource" );
+  if( hctx->mctx.bsize != sizeof( buffer )) return ak_error_message( ak_error_wrong_length,
+                                       __func__, "using hash function with unexpected block size" );
+
+ /* состояние после обработки ключа, сложенного с ipad */
+  len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
+  for( idx = 0; idx < len; idx++, jdx++ ) {
+     buffer[idx] = hctx->key.key[idx] ^ 0x36;
+     buffer[idx] ^= hctx->key.key[jdx];
+  }
+  for( ; idx < hctx->mctx.bsize; idx++ ) buffer[idx] = 0x36;
+
+  if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong cleaning of hash function context" );
+    goto labex;
+  }
+  if(( error = ak_hash_update( &hctx->ctx, buffer, hctx->mctx.bsize )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "invalid processing of ipad block" );
+    goto labex;
+  }
+  memcpy( &ms->ipad, &hctx->ctx.data.sctx, sizeof( struct streebog ));
+
+ /* состояние после обработки ключа, сложенного с opad */
+  len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
+  for( idx = 0; idx < len; idx++, jdx++ ) {
+     buffer[idx] = hctx->key.key[idx] ^ 0x5C;
+     buffer[idx] ^= hctx->key.key[jdx];
+  }
+  for( ; idx < hctx->mctx.bsize; idx++ ) buffer[idx] = 0x5C;
+
+  if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong cleaning of hash function context" );
+    goto labex;
+  }
+  if(( error = ak_hash_update( &hctx->ctx, buffer, hctx->mctx.bsize )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "invalid processing of opad block" );
+    goto labex;
+  }
+  memcpy( &ms->opad, &hctx->ctx.data.sctx, sizeof( struct streebog ));
+
+ /* перемаскируем ключ и меняем его ресурс */
+  hctx->key.set_mask( &hctx->key );
+  hctx->key.resource.value.counter--;
+
+  labex:
+   ak_ptr_wipe( buffer, sizeof( buffer ), &hctx->key.generator );
+   ak_hash_clean( &hctx->ctx );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция устанавливает контекст функции хеширования в состояние, возникающее после
+    обработки блока ipad. После вызова функции данные могут обрабатываться с помощью
+    функции ak_hash_update().
+
+    \param hctx Контекст алгоритма HMAC.
+    \param ms Предвычисленные состояния функции хеширования.                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_hmac_midstates_clean( ak_hmac hctx, ak_hmac_midstates ms )
+{
+  hctx->ctx.mctx.length = 0;
+  memcpy( &hctx->ctx.data.sctx, &ms->ipad, sizeof( struct streebog ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция завершает вычисление имитовставки, начатое вызовом функции
+    ak_hmac_midstates_clean().
+
+    \param hctx Контекст алгоритма HMAC.
+    \param ms Предвычисленные состояния функции хеширования.
+    \param in Последний фрагмент обрабатываемых данных.
+    \param size Размер фрагмента в октетах.
+    \param out Область памяти, куда помещается результат.
+    \param out_size Размер области памяти в октетах.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_midstates_finalize( ak_hmac hctx, ak_hmac_midstates ms,
+                    const ak_pointer in, const size_t size, ak_pointer out, const size_t out_size )
+{
+  int error = ak_error_ok;
+  ak_uint8 temporary[64];
+
+  if(( error = ak_hash_finalize( &hctx->ctx, in, size,
+                                              temporary, sizeof( temporary ))) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong updating of finalized data" );
+
+  hctx->ctx.mctx.length = 0;
+  memcpy( &hctx->ctx.data.sctx, &ms->opad, sizeof( struct streebog ));
+  error = ak_hash_finalize( &hctx->ctx, temporary, hctx->ctx.data.sctx.hsize, out, out_size );
+  memset( temporary, 0, sizeof( temporary ));
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                   выработка ключевой информации из пароля (Р 50.1.111-2016)                     */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет один 64-х октетный блок \f$ T_i \f$ алгоритма PBKDF2.
+
+    \param hctx Контекст алгоритма hmac-streebog512, ключом которого является пароль.
+    \param ms Предвычисленные состояния функции хеширования.
+    \param salt Инициализационный вектор.
+    \param salt_size Размер инициализационного вектора в октетах.
+    \param cnt Количество итераций.
+    \param index Номер вычисляемого блока (начиная с единицы).
+    \param out Массив, куда помещается вычисленный блок.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_block( ak_hmac hctx, ak_hmac_midstates ms,
+                                const ak_pointer salt, const size_t salt_size, const size_t cnt,
+                                                         const ak_uint32 index, ak_uint64 *out )
+{
+  size_t idx = 0;
+  ak_uint64 result[8];
+  int error = ak_error_ok;
+  ak_uint8 number[4] = { ( ak_uint8 )( index >> 24 ), ( ak_uint8 )( index >> 16 ),
+                                             ( ak_uint8 )( index >> 8 ), ( ak_uint8 )index };
+
+ /* вычисляем значение первой строки U1 = HMAC( salt || INT(i) ) */
+  ak_hmac_midstates_clean( hctx, ms );
+  if(( error = ak_hash_update( &hctx->ctx, salt, salt_size )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect updating of internal hmac context");
+  if(( error = ak_hmac_midstates_finalize( hctx, ms, number, 4,
+                                                        result, sizeof( result ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect finalizing of internal hmac context");
+  memcpy( out, result, sizeof( result ));
+
+ /* теперь основной цикл по значению аргумента c */
+  for( idx = 1; idx < cnt; idx++ ) {
+     ak_hmac_midstates_clean( hctx, ms );
+     ak_hmac_midstates_finalize( hctx, ms, result, sizeof( result ), result, sizeof( result ));
+     out[0] ^= result[0]; out[1] ^= result[1]; out[2] ^= result[2]; out[3] ^= result[3];
+     out[4] ^= result[4]; out[5] ^= result[5]; out[6] ^= result[6]; out[7] ^= result[7];
+  }
+  memset( result, 0, sizeof( result ));
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет блоки \f$ T_{first+1}, T_{first+step+1}, \ldots \f$
+    ключевого вектора, определяемого заданием task.
+
+    Для длин ключевого вектора от 32-х до 64-х октетов сохраняется принятый в библиотеке
+    формат: в качестве результата берутся последние dklen октетов блока \f$ T_1 \f$.
+    Для больших длин результат есть конкатенация \f$ T_1 || T_2 || \ldots \f$, последний блок
+    которой усекается до нужной длины.
+
+    \param task Задание для выработки ключевого вектора.
+    \param first Номер первого вычисляемого блока (начиная с нуля).
+    \param step Шаг, с которым перебираются вычисляемые блоки.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_blocks( ak_pbkdf2_task task,
+                                                          const size_t first, const size_t step )
+{
+  struct hmac hctx;
+  ak_uint64 block[8];
+  int error = ak_error_ok;
+  struct hmac_midstates ms;
+  size_t idx = 0, count = ( task->dklen + 63 ) >> 6;
+
+  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
+  if(( error = ak_hmac_set_key( &hctx, task->pass, task->pass_size )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
+    goto lab_exit;
+  }
+  if(( error = ak_hmac_midstates_create( &hctx, &ms )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong precomputation of hmac-streebog512 states" );
+    goto lab_exit;
+  }
+
+  for( idx = first; idx < count; idx += step ) {
+     if(( error = ak_hmac_pbkdf2_streebog512_block( &hctx, &ms, task->salt, task->salt_size,
+                                   task->cnt, ( ak_uint32 )( idx+1 ), block )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect calculation of pbkdf2 block" );
+       break;
+     }
+     if( task->dklen <= 64 )
+       memcpy( task->out, ( ak_uint8 *)block + 64 - task->dklen, task->dklen );
+      else memcpy( ( ak_uint8 *)task->out + ( idx << 6 ), block,
+                                                       ak_min( 64, task->dklen - ( idx << 6 )));
+  }
+  memset( block, 0, sizeof( block ));
+  memset( &ms, 0, sizeof( struct hmac_midstates ));
+
+  lab_exit: ak_hmac_destroy( &hctx );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Структура, определяющая часть работы, выполняемую одним потоком. */
+ typedef struct pbkdf2_thread {
+  /*! \brief Массив заданий */
+   ak_pbkdf2_task tasks;
+  /*! \brief Количество заданий */
+   size_t count;
+  /*! \brief Номер первого обрабатываемого задания (или блока, если задание одно) */
+   size_t first;
+  /*! \brief Шаг перебора заданий (блоков) */
+   size_t step;
+  /*! \brief Код ошибки */
+   int error;
+ } *ak_pbkdf2_thread;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выполняет часть работы, определенную структурой pbkdf2_thread.
+    Если задание одно, то поток вычисляет часть блоков ключевого вектора; в противном случае
+    поток полностью вычисляет ключевые векторы для части заданий.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hmac_pbkdf2_streebog512_thread( void *ptr )
+{
+  size_t idx = 0;
+  ak_pbkdf2_thread th = ( ak_pbkdf2_thread ) ptr;
+
+  if( th->count == 1 ) /* код ошибки задания устанавливается после завершения всех потоков */
+    th->error = ak_hmac_pbkdf2_streebog512_blocks( th->tasks, th->first, th->step );
+   else
+    for( idx = th->first; idx < th->count; idx += th->step )
+       if(( th->tasks[idx].error =
+                     ak_hmac_pbkdf2_streebog512_blocks( th->tasks+idx, 0, 1 )) != ak_error_ok )
+         th->error = th->tasks[idx].error;
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция распределяет вычисления по потокам, количество которых определяется
+    опцией библиотеки `threads_count`.
+
+    \param tasks Массив заданий, параметры которых уже проверены.
+    \param count Количество заданий.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки, возникшей при обработке одного из заданий.                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_run( ak_pbkdf2_task tasks, const size_t count )
+{
+  size_t idx = 0, threads = 1;
+  int error = ak_error_ok;
+  struct pbkdf2_thread th[ak_libakrypt_threads_max];
+
+  threads = ak_libakrypt_get_threads_count(
+                                      ( count == 1 ) ? ( tasks[0].dklen + 63 ) >> 6 : count );
+  for( idx = 0; idx < threads; idx++ ) {
+     th[idx].tasks = tasks;
+     th[idx].count = count;
+     th[idx].first = idx;
+     th[idx].step = threads;
+     th[idx].error = ak_error_ok;
+  }
+ /* нулевая порция работы выполняется в текущем потоке */
+  ak_libakrypt_run_threads( ak_hmac_pbkdf2_streebog512_thread, th,
+                                                         sizeof( struct pbkdf2_thread ), threads );
+
+  for( idx = 0; idx < threads; idx++ )
+     if( th[idx].error != ak_error_ok ) { error = th[idx].error; break; }
+  if( count == 1 ) tasks[0].error = error;
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка параметров одного задания для алгоритма PBKDF2. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_check_task( ak_pbkdf2_task task )
+{
+  if( task->pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                 "using null pointer to password" );
+  if( !task->pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                   "using a zero length password" );
+  if( task->salt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                     "using null pointer to salt" );
+  if(( task->dklen < 32 ) || ((( task->dklen - 1 ) >> 6 ) >= 0xffffffff ))
+    return ak_error_message( ak_error_wrong_length,
+                                       __func__ , "using a wrong length for resulting key vector" );
+  if( task->out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to resulting key vector" );
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Пароль должен представлять собой ненулевую строку символов в utf8
-    кодировке. Размер вырабатываемого ключевого вектора может колебаться от 32-х до 64-х байт.
+    кодировке. Размер вырабатываемого ключевого вектора должен быть не менее 32-х байт.
     При выработке используется алгоритм hmac-streebog512.
 
+    Если размер ключевого вектора не превосходит 64-х байт, то в качестве результата берутся
+    последние dklen байт блока \f$ T_1 \f$. Для больших длин ключевой вектор образуется
+    конкатенацией независимых блоков \f$ T_1 || T_2 || \ldots \f$, которые (при сборке библиотеки
+    с поддержкой pthreads) вычисляются параллельно; количество используемых потоков
+    ограничивается опцией библиотеки `threads_count`.
+
     @param pass Пароль, строка символов в utf8 кодировке.
     @param pass_size Размер пароля в байтах, должен быть отличен от нуля.
     @param salt Строка с инициализационным вектором (произвольная область памяти). Данное значение
@@ -501,8 +826,8 @@
     @param cnt Параметр, определяющий количество однотипных итераций для выработки ключа; данный
     параметр определяет время работы алгоритма; параметр не является секретным и может храниться или
     передаваться в открытом виде.
-    @param dklen Длина вырабатываемого ключевого вектора в байтах, величина должна принимать
-    значение от 32-х до 64-х.
+    @param dklen Длина вырабатываемого ключевого вектора в байтах, величина должна быть
+    не менее 32-х.
     @param out Указатель на массив, куда будет помещен результат; под данный массив должна быть
     заранее выделена память не менее, чем dklen байт.
 
@@ -513,60 +838,281 @@
          const size_t pass_size, const ak_pointer salt, const size_t salt_size, const size_t cnt,
                                                                const size_t dklen, ak_pointer out )
 {
-  struct hmac hctx;
-  ak_uint8 result[64];
   int error = ak_error_ok;
-  size_t idx = 0, jdx = 0;
+  struct pbkdf2_task task;
 
- /* в начале, многочисленные проверки входных параметров */
-  if( pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                                 "using null pointer to password" );
-  if( !pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
-                                                                   "using a zero length password" );
-  if( salt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                                     "using null pointer to salt" );
-  if(( dklen < 32 ) || ( dklen > 64 )) return ak_error_message( ak_error_wrong_length,
-                                       __func__ , "using a wrong length for resulting key vector" );
-  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                     "using null pointer to resulting key vector" );
- /* создаем контекст алгоритма hmac и определяем его ключ */
-  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
-  if(( error = ak_hmac_set_key( &hctx, pass, pass_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
-    goto lab_exit;
-  }
+  task.pass = pass;
+  task.pass_size = pass_size;
+  task.salt = salt;
+  task.salt_size = salt_size;
+  task.cnt = cnt;
+  task.dklen = dklen;
+  task.out = out;
+  task.error = ak_error_ok;
 
- /* начальная инициализация промежуточного вектора */
-  memset( result, 0, 64 );
-  result[3] = 1;
+  if(( error = ak_hmac_pbkdf2_streebog512_check_task( &task )) != ak_error_ok )
+    return ak_error_message( error, __func__, "using wrong parameters of pbkdf2 algorithm" );
 
- /* вычисляем значение первой строки U1  */
-  if(( error = ak_hmac_clean( &hctx )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect cleaning of internal hmac context");
-    goto lab_exit;
-  }
-  if(( error = ak_hmac_update( &hctx, salt, salt_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect updating of internal hmac context");
-    goto lab_exit;
-  }
-  if(( error = ak_hmac_finalize( &hctx, result, 4, result, sizeof( result ))) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect finalizing of internal mac context");
-    goto lab_exit;
-  }
-  memcpy( out, result+64-dklen, dklen );
+ return ak_hmac_pbkdf2_streebog512_run( &task, 1 );
+}
 
- /* теперь основной цикл по значению аргумента c */
-  for( idx = 1; idx < cnt; idx++ ) {
-     ak_hmac_ptr( &hctx, result, 64, result, sizeof( result ));
-     for( jdx = 0; jdx < dklen; jdx++ ) ((ak_uint8 *)out)[jdx] ^= result[64-dklen+jdx];
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключевые векторы для массива заданий, каждое из которых
+    содержит собственные пароль, инициализационный вектор, количество итераций и длину
+    ключевого вектора. Задания распределяются между потоками, количество которых ограничивается
+    опцией библиотеки `threads_count`. Результат обработки каждого задания помещается в его
+    поле `error`.
+
+    @param tasks Массив заданий.
+    @param count Количество заданий в массиве.
+
+    @return В случае успешной обработки всех заданий функция возвращает \ref ak_error_ok.
+    В противном случае возвращается код ошибки, возникшей при обработке одного из заданий.        */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_pbkdf2_streebog512_batch( ak_pbkdf2_task tasks, const size_t count )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to task array" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "using empty array of tasks" );
+  for( idx = 0; idx < count; idx++ )
+     if(( tasks[idx].error = ak_hmac_pbkdf2_streebog512_check_task( tasks+idx )) != ak_error_ok )
+       error = tasks[idx].error;
+  if( error != ak_error_ok )
+    return ak_error_message( error, __func__, "using wrong parameters of pbkdf2 algorithm" );
+
+ return ak_hmac_pbkdf2_streebog512_run( tasks, count );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*               выработка производной ключевой информации (Р 50.1.113-2016)                       */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет фрагмент выхода алгоритма KDF_TREE, используя предвычисленные
+    состояния функции хеширования.
+
+    Вычисляется последовательность \f$ K(first) || K(first+1) || \ldots \f$, где
+    \f$ K(i) = HMAC( K, [i]_b || label || 0x00 || seed || [L]_b ) \f$, а величина L
+    равна общей длине выхода алгоритма в битах.
+
+    \param hctx Контекст родительского ключа алгоритма HMAC.
+    \param ms Предвычисленные состояния функции хеширования.
+    \param label Метка (используемое значение label).
+    \param label_size Длина метки в октетах.
+    \param seed Инициализационный вектор (используемое значение seed).
+    \param seed_size Длина инициализационного вектора в октетах.
+    \param R Количество октетов, используемых для представления номера i (от 1 до 4).
+    \param length Общая длина выхода алгоритма в октетах.
+    \param first Номер первого вычисляемого блока K(i) (начиная с единицы).
+    \param out Область памяти, куда помещается результат.
+    \param out_size Количество вычисляемых октетов.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_kdf_tree_midstates( ak_hmac hctx, ak_hmac_midstates ms,
+                                  const ak_pointer label, const size_t label_size,
+                                  const ak_pointer seed, const size_t seed_size, const size_t R,
+                  const size_t length, const size_t first, ak_uint8 *out, const size_t out_size )
+{
+  ak_uint8 block[64], number[4], lbits[8], zero = 0;
+  int error = ak_error_ok;
+  size_t idx = 0, lsize = 0, offset = 0, tsize = hctx->ctx.data.sctx.hsize;
+  ak_uint64 index = first, bits = ( ak_uint64 )length << 3;
+
+ /* двоичное представление длины L без лидирующих нулей */
+  do{ lbits[7-lsize] = ( ak_uint8 )bits; bits >>= 8; lsize++; } while( bits );
+
+  while( offset < out_size ) {
+    /* проверяем, что номер блока помещается в R октетов */
+     if(( R < 4 ) && ( index >> ( R << 3 ))) {
+       error = ak_error_message( ak_error_wrong_length,
+                                        __func__, "the index of block exceeds the range of R" );
+       goto lab_exit;
+     }
+     for( idx = 0; idx < R; idx++ ) number[idx] = ( ak_uint8 )( index >> (( R-1-idx ) << 3 ));
+
+     ak_hmac_midstates_clean( hctx, ms );
+     if(( error = ak_hash_update( &hctx->ctx, number, R )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect hashing of block number" );
+       goto lab_exit;
+     }
+     if( label_size &&
+        (( error = ak_hash_update( &hctx->ctx, label, label_size )) != ak_error_ok )) {
+       ak_error_message( error, __func__, "incorrect hashing of label" );
+       goto lab_exit;
+     }
+     if(( error = ak_hash_update( &hctx->ctx, &zero, 1 )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect hashing of zero separator" );
+       goto lab_exit;
+     }
+     if( seed_size &&
+        (( error = ak_hash_update( &hctx->ctx, seed, seed_size )) != ak_error_ok )) {
+       ak_error_message( error, __func__, "incorrect hashing of seed" );
+       goto lab_exit;
+     }
+     if(( error = ak_hmac_midstates_finalize( hctx, ms, lbits+8-lsize, lsize,
+                                                        block, sizeof( block ))) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect calculation of kdf_tree block" );
+       goto lab_exit;
+     }
+
+     memcpy( out+offset, block, ak_min( tsize, out_size - offset ));
+     offset += tsize;
+     index++;
   }
-  memset( result, 0, 64 );
 
-  lab_exit: ak_hmac_destroy( &hctx );
+ lab_exit:
+  memset( block, 0, sizeof( block ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка параметров алгоритма KDF_TREE. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_kdf_tree_check( const ak_pointer label, const size_t label_size,
+                                      const ak_pointer seed, const size_t seed_size, const size_t R )
+{
+  if(( label == NULL ) && ( label_size != 0 )) return ak_error_message( ak_error_null_pointer,
+                                                          __func__, "using null pointer to label" );
+  if(( seed == NULL ) && ( seed_size != 0 )) return ak_error_message( ak_error_null_pointer,
+                                                           __func__, "using null pointer to seed" );
+  if(( R < 1 ) || ( R > 4 )) return ak_error_message( ak_error_wrong_length, __func__,
+                                                       "using wrong length of block index (R)" );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует алгоритм KDF_TREE_GOSTR3411_2012_256, описанный в рекомендациях
+    по стандартизации Р 50.1.113-2016 (раздел 4.5), и вырабатывает out_size октетов
+    производной ключевой информации. Длина выхода алгоритма L полагается равной 8*out_size бит.
+
+    В качестве родительского ключа используется ключ алгоритма HMAC; согласно рекомендациям
+    должен использоваться алгоритм hmac-streebog256.
+
+    @param hctx Контекст родительского ключа алгоритма HMAC (ключ должен быть установлен).
+    @param label Метка, определяющая назначение вырабатываемого ключа.
+    @param label_size Длина метки в октетах.
+    @param seed Инициализационный вектор.
+    @param seed_size Длина инициализационного вектора в октетах.
+    @param R Количество октетов, используемых для представления номера блока (от 1 до 4).
+    @param out Область памяти, куда помещается результат.
+    @param out_size Количество вырабатываемых октетов.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_kdf_tree( ak_hmac hctx, const ak_pointer label, const size_t label_size,
+                                  const ak_pointer seed, const size_t seed_size, const size_t R,
+                                                            ak_pointer out, const size_t out_size )
+{
+  int error = ak_error_ok;
+  struct hmac_midstates ms;
+
+  if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                         "using null pointer to parent hmac key" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                            "using null pointer to output buffer" );
+  if( !out_size ) return ak_error_message( ak_error_zero_length, __func__,
+                                                               "using zero length of output key" );
+  if(( error = ak_hmac_kdf_tree_check( label, label_size, seed, seed_size, R )) != ak_error_ok )
+    return ak_error_message( error, __func__, "using wrong parameters of kdf_tree algorithm" );
+
+  if(( error = ak_hmac_midstates_create( hctx, &ms )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong precomputation of hmac states" );
+  error = ak_hmac_kdf_tree_midstates( hctx, &ms,
+                                     label, label_size, seed, seed_size, R, out_size, 1, out, out_size );
+  memset( &ms, 0, sizeof( struct hmac_midstates ));
+
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает производные ключи для массива заданий, используя один родительский
+    ключ. Состояния функции хеширования, зависящие от родительского ключа, вычисляются один раз
+    для всего массива, поэтому выработка каждого производного ключа требует только вычисления
+    блоков \f$ K(i) \f$ алгоритма KDF_TREE.
+
+    Каждое задание определяет метку, инициализационный вектор, длину производного ключа `size`,
+    общую длину выхода алгоритма `length`, номер первого используемого блока `first`
+    и созданный заранее объект `key` (ключ блочного шифра \ref bckey или ключ
+    алгоритма \ref hmac), которому присваивается выработанное значение. Таким образом, последовательность производных ключей
+    может быть получена из одного выхода алгоритма KDF_TREE, если задания отличаются только
+    значением поля `first`.
+
+    @param hctx Контекст родительского ключа алгоритма HMAC (ключ должен быть установлен).
+    @param R Количество октетов, используемых для представления номера блока (от 1 до 4).
+    @param tasks Массив заданий.
+    @param count Количество заданий.
+
+    @return В случае успешной обработки всех заданий функция возвращает \ref ak_error_ok.
+    В противном случае возвращается код ошибки, возникшей при обработке одного из заданий;
+    результат обработки каждого задания помещается в его поле `error`.                            */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_kdf_tree_batch( ak_hmac hctx, const size_t R,
+                                                    ak_kdf_tree_task tasks, const size_t count )
+{
+  size_t idx = 0;
+  ak_skey skey = NULL;
+  ak_uint8 buffer[128];
+  struct hmac_midstates ms;
+  int error = ak_error_ok, result = ak_error_ok;
+
+  if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                         "using null pointer to parent hmac key" );
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                             "using null pointer to task array" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                  "using empty array of tasks" );
+  if(( error = ak_hmac_midstates_create( hctx, &ms )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong precomputation of hmac states" );
+
+  for( idx = 0; idx < count; idx++ ) {
+     ak_kdf_tree_task task = tasks+idx;
+     size_t first = task->first ? task->first : 1, ksize = 0;
+
+     if(( skey = ( ak_skey )task->key ) == NULL ) {
+       task->error = ak_error_message( ak_error_null_pointer, __func__,
+                                                          "using null pointer to derived key" );
+       goto lab_next;
+     }
+     if(( skey->oid == NULL ) || ( skey->oid->func.first.set_key == NULL )) {
+       task->error = ak_error_message( ak_error_undefined_function, __func__,
+                                            "using derived key without assigning function" );
+       goto lab_next;
+     }
+     ksize = task->size ? task->size : skey->key_size;
+     if(( !ksize ) || ( ksize > sizeof( buffer ))) {
+       task->error = ak_error_message( ak_error_wrong_length, __func__,
+                                                       "using derived key with wrong length" );
+       goto lab_next;
+     }
+     if(( task->error = ak_hmac_kdf_tree_check( task->label, task->label_size,
+                                        task->seed, task->seed_size, R )) != ak_error_ok ) {
+       ak_error_message( task->error, __func__, "using wrong parameters of kdf_tree algorithm" );
+       goto lab_next;
+     }
+     if(( task->error = ak_hmac_kdf_tree_midstates( hctx, &ms,
+            task->label, task->label_size, task->seed, task->seed_size, R,
+                           task->length ? task->length : ksize, first,
+                                                           buffer, ksize )) != ak_error_ok ) {
+       ak_error_message( task->error, __func__, "incorrect calculation of derived key" );
+       goto lab_next;
+     }
+     if(( task->error =
+                skey->oid->func.first.set_key( task->key, buffer, ksize )) != ak_error_ok )
+       ak_error_message( task->error, __func__, "incorrect assigning of derived key value" );
+
+     lab_next:
+      if( task->error != ak_error_ok ) result = task->error;
+  }
+  ak_ptr_wipe( buffer, sizeof( buffer ), &hctx->key.generator );
+  memset( &ms, 0, sizeof( struct hmac_midstates ));
+
+ return result;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                            функции для тестирования алгоритма hmac                              */
 /* ----------------------------------------------------------------------------------------------- */
@@ -777,12 +1323,26 @@
    0x78, 0xcc, 0xb8, 0x79, 0xf6, 0x70, 0x68, 0xcd, 0xac, 0x19, 0x10, 0x74, 0x08, 0x44, 0xe8, 0x30
   };
 
+  ak_uint8 R5[100] = {
+   0xb2, 0xd8, 0xf1, 0x24, 0x5f, 0xc4, 0xd2, 0x92, 0x74, 0x80, 0x20, 0x57, 0xe4, 0xb5, 0x4e, 0x0a,
+   0x07, 0x53, 0xaa, 0x22, 0xfc, 0x53, 0x76, 0x0b, 0x30, 0x1c, 0xf0, 0x08, 0x67, 0x9e, 0x58, 0xfe,
+   0x4b, 0xee, 0x9a, 0xdd, 0xca, 0xe9, 0x9b, 0xa2, 0xb0, 0xb2, 0x0f, 0x43, 0x1a, 0x9c, 0x5e, 0x50,
+   0xf3, 0x95, 0xc8, 0x93, 0x87, 0xd0, 0x94, 0x5a, 0xed, 0xec, 0xa6, 0xeb, 0x40, 0x15, 0xdf, 0xc2,
+   0xbd, 0x24, 0x21, 0xee, 0x9b, 0xb7, 0x11, 0x83, 0xba, 0x88, 0x2c, 0xee, 0xbf, 0xef, 0x25, 0x9f,
+   0x33, 0xf9, 0xe2, 0x7d, 0xc6, 0x17, 0x8c, 0xb8, 0x9d, 0xc3, 0x74, 0x28, 0xcf, 0x9c, 0xc5, 0x2a,
+   0x2b, 0xaa, 0x2d, 0x3a
+  };
+
   ak_uint8 password_one[8] = "password",
            password_two[9] = { 'p', 'a', 's', 's', 0, 'w', 'o', 'r', 'd' },
            salt_one[4]     = "salt",
-           salt_two[5]     = { 's', 'a', 0, 'l', 't' };
+           salt_two[5]     = { 's', 'a', 0, 'l', 't' },
+           password_three[24] = "passwordPASSWORDpassword",
+           salt_three[36] = "saltSALTsaltSALTsaltSALTsaltSALTsalt";
 
-  ak_uint8 out[64];
+  size_t idx = 0;
+  struct pbkdf2_task tasks[4];
+  ak_uint8 out[64], long_out[100], batch_out[4][64];
   int error = ak_error_ok;
   int audit = ak_log_get_level();
 
@@ -841,9 +1401,170 @@
   }
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                                              "the 4th test for pbkdf2 from R 50.1.111-2016 is Ok" );
+
+ /* пятый тест из Р 50.1.111-2016: ключевой вектор длины 100 октетов, т.е. два блока */
+  if(( error = ak_hmac_pbkdf2_streebog512( password_three, 24,
+                                            salt_three, 36, 4096, 100, long_out )) != ak_error_ok ) {
+    ak_error_message( error,__func__, "incorrect transformation password to long key");
+    return ak_false;
+  }
+  if( !ak_ptr_is_equal_with_log( long_out, R5, 100 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                                 "wrong 5th test for pbkdf2 from R 50.1.111-2016" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                             "the 5th test for pbkdf2 from R 50.1.111-2016 is Ok" );
+
+ /* пакетная обработка всех предыдущих примеров */
+  memset( tasks, 0, sizeof( tasks ));
+  for( idx = 0; idx < 4; idx++ ) {
+     tasks[idx].pass = ( idx < 3 ) ? password_one : password_two;
+     tasks[idx].pass_size = ( idx < 3 ) ? 8 : 9;
+     tasks[idx].salt = ( idx < 3 ) ? salt_one : salt_two;
+     tasks[idx].salt_size = ( idx < 3 ) ? 4 : 5;
+     tasks[idx].cnt = ( idx < 2 ) ? idx+1 : 4096;
+     tasks[idx].dklen = 64;
+     tasks[idx].out = batch_out[idx];
+  }
+  if(( error = ak_hmac_pbkdf2_streebog512_batch( tasks, 4 )) != ak_error_ok ) {
+    ak_error_message( error,__func__, "incorrect batch transformation passwords to keys");
+    return ak_false;
+  }
+  if( !ak_ptr_is_equal_with_log( batch_out[0], R1, 64 ) ||
+      !ak_ptr_is_equal_with_log( batch_out[1], R2, 64 ) ||
+      !ak_ptr_is_equal_with_log( batch_out[2], R3, 64 ) ||
+      !ak_ptr_is_equal_with_log( batch_out[3], R4, 64 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ , "wrong batch test for pbkdf2" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                                               "the batch test for pbkdf2 is Ok" );
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Тестовые значения взяты из рекомендаций Р 50.1.113-2016 (см. также RFC 7836, приложение А).    */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_test_kdf_tree( void )
+{
+  ak_uint8 key[32] = {
+   0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+   0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f };
+  ak_uint8 label[4] = { 0x26, 0xbd, 0xb8, 0x78 };
+  ak_uint8 seed[8] = { 0xaf, 0x21, 0x43, 0x41, 0x45, 0x65, 0x63, 0x78 };
+
+ /* KDF_GOSTR3411_2012_256 (совпадает с KDF_TREE при L = 256 и R = 1) */
+  ak_uint8 R256[32] = {
+   0xa1, 0xaa, 0x5f, 0x7d, 0xe4, 0x02, 0xd7, 0xb3, 0xd3, 0x23, 0xf2, 0x99, 0x1c, 0x8d, 0x45, 0x34,
+   0x01, 0x31, 0x37, 0x01, 0x0a, 0x83, 0x75, 0x4f, 0xd0, 0xaf, 0x6d, 0x7c, 0xd4, 0x92, 0x2e, 0xd9 };
+ /* KDF_TREE_GOSTR3411_2012_256 при L = 512 и R = 1 */
+  ak_uint8 R512[64] = {
+   0x22, 0xb6, 0x83, 0x78, 0x45, 0xc6, 0xbe, 0xf6, 0x5e, 0xa7, 0x16, 0x72, 0xb2, 0x65, 0x83, 0x10,
+   0x86, 0xd3, 0xc7, 0x6a, 0xeb, 0xe6, 0xda, 0xe9, 0x1c, 0xad, 0x51, 0xd8, 0x3f, 0x79, 0xd1, 0x6b,
+   0x07, 0x4c, 0x93, 0x30, 0x59, 0x9d, 0x7f, 0x8d, 0x71, 0x2f, 0xca, 0x54, 0x39, 0x2f, 0x4d, 0xdd,
+   0xe9, 0x37, 0x51, 0x20, 0x6b, 0x35, 0x84, 0xc8, 0xf4, 0x3f, 0x9e, 0x6d, 0xc5, 0x15, 0x31, 0xf9 };
+
+  size_t idx = 0;
+  struct hmac hkey, hchild, hcheck;
+  struct bckey bchild[2], bcheck;
+  struct kdf_tree_task tasks[3];
+  ak_uint8 out[64], in[16], out2[32];
+  int error = ak_error_ok, audit = ak_log_get_level();
+  bool_t result = ak_false;
+
+  if(( error = ak_hmac_create_streebog256( &hkey )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong creation of hmac-streebog256 key context" );
+    return ak_false;
+  }
+  if(( error = ak_hmac_set_key( &hkey, key, sizeof( key ))) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "wrong assigning a constant hmac key value" );
+    goto lab_exit;
+  }
+
+ /* 1. вырабатываем ключи фиксированной длины */
+  if(( error = ak_hmac_kdf_tree( &hkey, label, sizeof( label ),
+                                       seed, sizeof( seed ), 1, out, 32 )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect calculation of derived key" );
+    goto lab_exit;
+  }
+  if( !ak_ptr_is_equal_with_log( out, R256, 32 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                  "wrong test for kdf_gostr3411_2012_256 from R 50.1.113-2016" );
+    goto lab_exit;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                "the test for kdf_gostr3411_2012_256 from R 50.1.113-2016 is Ok" );
+
+  if(( error = ak_hmac_kdf_tree( &hkey, label, sizeof( label ),
+                                       seed, sizeof( seed ), 1, out, 64 )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect calculation of derived key" );
+    goto lab_exit;
+  }
+  if( !ak_ptr_is_equal_with_log( out, R512, 64 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                             "wrong test for kdf_tree_gostr3411_2012_256 from R 50.1.113-2016" );
+    goto lab_exit;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                           "the test for kdf_tree_gostr3411_2012_256 from R 50.1.113-2016 is Ok" );
+
+ /* 2. пакетная выработка: два ключа блочного шифра и ключ hmac из одного выхода KDF_TREE */
+  ak_bckey_create_kuznechik( &bchild[0] );
+  ak_bckey_create_kuznechik( &bchild[1] );
+  ak_bckey_create_kuznechik( &bcheck );
+  ak_hmac_create_streebog256( &hchild );
+  ak_hmac_create_streebog256( &hcheck );
+
+  memset( tasks, 0, sizeof( tasks ));
+  for( idx = 0; idx < 3; idx++ ) {
+     tasks[idx].label = label; tasks[idx].label_size = sizeof( label );
+     tasks[idx].seed = seed; tasks[idx].seed_size = sizeof( seed );
+     tasks[idx].size = 32; tasks[idx].length = 64;
+     tasks[idx].first = ( idx == 1 ) ? 2 : 1;
+  }
+  tasks[0].key = &bchild[0];
+  tasks[1].key = &bchild[1];
+  tasks[2].key = &hchild;
+  if(( error = ak_hmac_kdf_tree_batch( &hkey, 1, tasks, 3 )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect batch derivation of keys" );
+    goto lab_exit2;
+  }
+
+ /* проверяем, что производные ключи блочного шифра совпадают с фрагментами выхода KDF_TREE */
+  memset( in, 0x5a, sizeof( in ));
+  for( idx = 0; idx < 2; idx++ ) {
+     ak_bckey_set_key( &bcheck, R512 + 32*idx, 32 );
+     bcheck.encrypt( &bcheck.key, in, out );
+     bchild[idx].encrypt( &bchild[idx].key, in, out+16 );
+     if( !ak_ptr_is_equal_with_log( out, out+16, 16 )) {
+       ak_error_message( ak_error_not_equal_data, __func__ ,
+                                                "wrong batch derivation of block cipher key" );
+       goto lab_exit2;
+     }
+  }
+  ak_hmac_set_key( &hcheck, R512, 32 );
+  ak_hmac_ptr( &hcheck, in, sizeof( in ), out, 32 );
+  ak_hmac_ptr( &hchild, in, sizeof( in ), out2, 32 );
+  if( !ak_ptr_is_equal_with_log( out, out2, 32 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ , "wrong batch derivation of hmac key" );
+    goto lab_exit2;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                                      "the batch test for kdf_tree is Ok" );
+  result = ak_true;
+
+  lab_exit2:
+   ak_hmac_destroy( &hcheck );
+   ak_hmac_destroy( &hchild );
+   ak_bckey_destroy( &bcheck );
+   ak_bckey_destroy( &bchild[1] );
+   ak_bckey_destroy( &bchild[0] );
+  lab_exit:
+   ak_hmac_destroy( &hkey );
+ return result;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                      ak_hmac.c  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -13,10 +13,148 @@
 #ifdef AK_HAVE_WINDOWS_H
  #include <windows.h>
 #endif
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+ #define LIBAKRYPT_HAVE_CPUID
+ #ifdef _MSC_VER
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Маска расширений процессора, используемых библиотекой. */
+ static ak_uint32 ak_cpu_features = 0;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция определяет, какие расширения набора команд поддерживаются процессором,
+    на котором выполняется программа.
+    \return Маска, составленная из флагов \ref ak_cpu_feature_clmul и \ref ak_cpu_feature_mulx.  */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint32 ak_libakrypt_detect_cpu_features( void )
+{
+  ak_uint32 features = 0;
+#ifdef LIBAKRYPT_HAVE_CPUID
+  unsigned int max = 0, ecx1 = 0, ebx7 = 0;
+ #ifdef _MSC_VER
+  int regs[4];
+
+  __cpuid( regs, 0 );
+  max = ( unsigned int )regs[0];
+  if( max >= 1 ) { __cpuid( regs, 1 ); ecx1 = ( unsigned int )regs[2]; }
+  if( max >= 7 ) { __cpuidex( regs, 7, 0 ); ebx7 = ( unsigned int )regs[1]; }
+ #else
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+  max = __get_cpuid_max( 0, NULL );
+  if( max >= 1 ) { __cpuid( 1, eax, ebx, ecx, edx ); ecx1 = ecx; }
+  if( max >= 7 ) { __cpuid_count( 7, 0, eax, ebx, ecx, edx ); ebx7 = ebx; }
+ #endif
+ /* CPUID.01H:ECX, бит 1 - команда pclmulqdq */
+  if( ecx1&0x2 ) features |= ak_cpu_feature_clmul;
+ /* CPUID.(EAX=07H, ECX=0):EBX, бит 8 - расширение BMI2 (mulx), бит 19 - расширение ADX */
+  if(( ebx7&0x100 ) && ( ebx7&0x80000 )) features |= ak_cpu_feature_mulx;
+#endif
+ return features;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция определяет набор расширений процессора, ограничивает его значением
+    опции `cpu_features` и выбирает реализации вычислительных функций: умножения в
+    конечных полях характеристики два (используемого алгоритмами MGM, CMAC и схемой Блома)
+    и умножения вычетов в представлении Монтгомери (используемого в арифметике
+    эллиптических кривых). Выбор реализаций фиксируется в журнале аудита.
+
+    \return Функция возвращает \ref ak_error_ok.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_init_cpu_features( void )
+{
+  ak_uint32 detected = ak_libakrypt_detect_cpu_features(),
+            allowed = detected&( ak_uint32 )ak_libakrypt_get_option_by_name( "cpu_features" );
+#ifdef AK_HAVE_BUILTIN_MULQ_GCC
+  const char *montgomery = "mulq";
+#else
+  const char *montgomery = "portable";
+#endif
+
+  ak_cpu_features = ak_gf2n_set_functions( allowed ) | ak_mpzn_set_functions( allowed );
+  if( ak_cpu_features&ak_cpu_feature_mulx ) montgomery = "mulx/adx";
+
+  ak_error_message_fmt( ak_error_ok, __func__, "processor supports pclmulqdq: %s, mulx/adx: %s",
+                                 ( detected&ak_cpu_feature_clmul ) ? "yes" : "no",
+                                                   ( detected&ak_cpu_feature_mulx ) ? "yes" : "no" );
+  ak_error_message_fmt( ak_error_ok, __func__,
+                        "multiplication in Galois fields uses %s implementation",
+                               ( ak_cpu_features&ak_cpu_feature_clmul ) ? "pclmulqdq" : "window" );
+  ak_error_message_fmt( ak_error_ok, __func__,
+                               "montgomery multiplication uses %s implementation", montgomery );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \return Маска, составленная из флагов \ref ak_cpu_feature_clmul и \ref ak_cpu_feature_mulx,
+    соответствующих расширениям процессора, которые поддерживаются процессором, разрешены
+    опцией `cpu_features` и реально используются библиотекой.                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint32 ak_libakrypt_get_cpu_features( void )
+{
+  return ak_cpu_features;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Количество потоков определяется опцией библиотеки `threads_count` и не превышает
+    количества порций работы и значения \ref ak_libakrypt_threads_max. Если библиотека собрана
+    без поддержки pthreads, функция возвращает единицу.
+
+    @param count Количество независимых порций работы.
+    @return Количество потоков (не менее одного).                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_libakrypt_get_threads_count( const size_t count )
+{
+  size_t threads = 1;
+ #ifdef AK_HAVE_PTHREAD_H
+  threads = ( size_t ) ak_libakrypt_get_option_by_name( "threads_count" );
+ #endif
+ return ak_max( 1, ak_min( ak_min( threads, count ), ak_libakrypt_threads_max ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывает `func` для каждого из `threads` последовательно расположенных в памяти
+    аргументов. Первая порция работы выполняется в вызывающем потоке, остальные - в отдельных
+    потоках. Если поток создать не удалось, то соответствующая порция работы выполняется
+    в вызывающем потоке после завершения первой. Если библиотека собрана без поддержки pthreads,
+    все порции выполняются последовательно.
+
+    @param func Функция, выполняющая одну порцию работы.
+    @param args Массив аргументов функции.
+    @param elem_size Размер одного элемента массива аргументов (в октетах).
+    @param threads Количество порций работы (не более \ref ak_libakrypt_threads_max).            */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_libakrypt_run_threads( void *( *func )( void * ), ak_pointer args,
+                                                  const size_t elem_size, const size_t threads )
+{
+  size_t idx = 0;
+  ak_uint8 *ptr = ( ak_uint8 * )args;
+ #ifdef AK_HAVE_PTHREAD_H
+  pthread_t id[ak_libakrypt_threads_max];
+  bool_t created[ak_libakrypt_threads_max];
+  size_t count = ak_min( threads, ak_libakrypt_threads_max );
+
+  for( idx = 1; idx < count; idx++ )
+     created[idx] = ( pthread_create( id+idx, NULL, func, ptr + idx*elem_size ) == 0 );
+  if( count ) func( ptr );
+  for( idx = 1; idx < count; idx++ ) {
+     if( created[idx] ) pthread_join( id[idx], NULL );
+      else func( ptr + idx*elem_size );
+  }
+ #else
+  for( idx = 0; idx < threads; idx++ ) func( ptr + idx*elem_size );
+ #endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция проверяет корректность определения базовых типов данных
     \return В случе успешного тестирования возвращает \ref ak_true (истина).
@@ -76,12 +214,6 @@
   #ifdef AK_HAVE_BUILTIN_XOR_SI128
    ak_error_message( ak_error_ok, __func__ , "library applies __m128i base type" );
   #endif
-  #ifdef AK_HAVE_BUILTIN_CLMULEPI64
-   ak_error_message( ak_error_ok, __func__ , "library applies clmulepi64 instruction" );
-  #endif
-  #ifdef AK_HAVE_BUILTIN_MULQ_GCC
-   ak_error_message( ak_error_ok, __func__ , "library applies assembler code for mulq command" );
-  #endif
   #ifdef AK_HAVE_PTHREAD_H
    ak_error_message( ak_error_ok, __func__ , "library runs with pthreads support" );
   #endif
@@ -172,6 +304,12 @@
     return ak_false;
   }
 
+  if( ak_libakrypt_test_tlsrecord()  != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__ ,
+                                           "incorrect testing of tls 1.3 record protection" );
+    return ak_false;
+  }
+
   if( audit >= ak_log_maximum )
     ak_error_message( ak_error_ok, __func__ , "testing block ciphers ended successfully" );
 
@@ -199,6 +337,10 @@
     ak_error_message( ak_error_get_value(), __func__, "incorrect testing of pbkdf2 function" );
     return ak_false;
   }
+  if( ak_libakrypt_test_kdf_tree() != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__, "incorrect testing of kdf_tree function" );
+    return ak_false;
+  }
  /* тестирование различых реализаци cmac на совпадение */
   if( ak_libakrypt_test_cmac() != ak_true ) {
     ak_error_message( ak_error_get_value(), __func__, "incorrect testing different kinds of cmac" );
@@ -234,6 +376,12 @@
     return ak_false;
   }
 
+ /* тестируем корректность реализации алгоритма выработки общего ключа */
+  if( ak_libakrypt_test_vko() != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__ , "incorrect testing of key agreement" );
+    return ak_false;
+  }
+
   if( audit >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__ , "testing asymmetric mechanisms ended successfully" );
 
@@ -351,6 +499,12 @@
      return ak_false;
    }
 
+ /* выбираем реализации вычислительных функций в соответствии с возможностями процессора */
+   if(( error = ak_libakrypt_init_cpu_features()) != ak_error_ok ) {
+     ak_error_message( error, __func__ , "wrong selection of processor specific functions" );
+     return ak_false;
+   }
+
  /* инициализируем константные таблицы для алгоритма Кузнечик */
    if(( error = ak_bckey_kuznechik_init_gost_tables()) != ak_error_ok ) {
     ak_error_message( error, __func__, "initialization of context manager is wrong" );
@@ -408,6 +562,10 @@
   #endif
 #endif
 
+ /* удаляем таблицы кратных точек эллиптических кривых */
+  ak_verifykey_destroy_tables();
+  ak_wcurve_destroy_tables();
+
   if( ak_log_get_level() != ak_log_none )
     ak_error_message( ak_error_ok, __func__ , "all crypto mechanisms successfully destroyed" );
 
@@ -6,6 +6,14 @@
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+#ifdef AK_HAVE_SYSSTAT_H
+ #include <sys/stat.h>
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
  int ak_mac_create( ak_mac mctx, const size_t size, ak_pointer ictx,
                             ak_function_clean *clean, ak_function_update *update,
@@ -186,6 +194,245 @@
  return error;
 }
 
+#ifdef AK_HAVE_SYSMMAN_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер фрагмента файла, одновременно отображаемого в память (в октетах).
+    \details Величина кратна размеру большой страницы (2 Мб) и длинам входных блоков всех
+    алгоритмов итерационного сжатия, поэтому при обработке отображенных фрагментов данные
+    не копируются во временный буффер. Ограничение размера фрагмента позволяет обрабатывать
+    файлы, длина которых превышает размер адресного пространства процесса.                       */
+ #define ak_mac_file_mmap_window  ( (size_t) 64*1024*1024 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сжимает открытый файл, последовательно отображая его фрагменты в память
+    и передавая их непосредственно функции сжатия.
+
+    \warning Файл не должен изменяться во время обработки. Перед отображением каждого
+    фрагмента функция проверяет, что файл не был усечен, и в этом случае возвращает ошибку,
+    однако усечение файла во время сжатия уже отображенного фрагмента приводит
+    к получению процессом сигнала SIGBUS.
+
+    \return В случае успеха функция возвращает \ref ak_error_ok. Если отобразить в память
+    первый фрагмент файла не удалось, то возвращается \ref ak_error_mmap_file; в этом случае
+    контекст не изменяется и файл может быть обработан с помощью чтения.                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_mac_file_mapped( ak_mac mctx, ak_file file, ak_pointer out, const size_t out_size )
+{
+  ak_int64 offset = 0;
+  ak_uint8 *ptr = NULL;
+  int error = ak_error_ok;
+#ifdef AK_HAVE_SYSSTAT_H
+  struct stat st;
+#endif
+
+  while( offset < file->size ) {
+    size_t len = ( size_t )ak_min( file->size - offset, ( ak_int64 )ak_mac_file_mmap_window );
+#ifdef AK_HAVE_SYSSTAT_H
+   /* обращение к отображенным страницам за концом усеченного файла вызывает SIGBUS */
+    if(( fstat( file->fd, &st ) < 0 ) || (( ak_int64 )st.st_size < offset + ( ak_int64 )len ))
+      return ak_error_message_fmt( ak_error_read_data, __func__,
+                        "file size changed while processing at offset %lld", (long long)offset );
+#endif
+    if(( ptr = ak_file_mmap( file, readonly, offset, len )) == NULL ) {
+      if( offset == 0 ) return ak_error_mmap_file;
+      return ak_error_message_fmt( ak_error_read_data, __func__,
+                             "incorrect mapping of file fragment at offset %lld", (long long)offset );
+    }
+    offset += len;
+   /* пока обрабатывается текущий фрагмент, ядро считывает следующий */
+    if( offset < file->size ) ak_file_prefetch( file, offset,
+                         ( size_t )ak_min( file->size - offset, ( ak_int64 )ak_mac_file_mmap_window ));
+    if( offset < file->size ) error = ak_mac_update( mctx, ptr, len );
+      else error = ak_mac_finalize( mctx, ptr, len, out, out_size );
+    ak_file_unmap( file, ptr );
+    if( error != ak_error_ok ) break;
+  }
+
+ return error;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сжимает открытый файл, последовательно считывая его в локальный буффер.
+    \details Буффер заполняется полностью, пока не будет достигнут конец файла, поэтому
+    короткое чтение (например, из канала) не приводит к преждевременному завершению.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_mac_file_read( ak_mac mctx, ak_file file, ak_pointer out, const size_t out_size )
+{
+  size_t len = 0;
+  ssize_t res = 0;
+  int error = ak_error_ok;
+  ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+ /* готовим область для хранения данных */
+  size_t block_size = ak_max( ( size_t )file->blksize, mctx->bsize );
+
+ /* здесь мы выделяем локальный буффер для считывания/обработки данных */
+  if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                      "memory allocation error for local buffer" );
+ /* теперь обрабатываем файл с данными */
+  read_label: len = 0;
+  while( len < block_size ) {
+    if(( res = ak_file_read( file, localbuffer + len, block_size - len )) <= 0 ) break;
+    len += ( size_t )res;
+  }
+  if( res < 0 ) error = ak_error_message( ak_error_read_data, __func__, "incorrect reading of file" );
+   else if( len == block_size ) {
+    ak_mac_update( mctx, localbuffer, block_size ); /* добавляем считанные данные */
+    goto read_label;
+  } else {
+           size_t qcnt = len / mctx->bsize,
+                  tail = len - qcnt*mctx->bsize;
+           if( qcnt ) ak_mac_update( mctx, localbuffer, qcnt*mctx->bsize );
+           error = ak_mac_finalize( mctx,
+                                             localbuffer + qcnt*mctx->bsize, tail, out, out_size );
+         }
+  free( localbuffer );
+ return error;
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество буфферов, одновременно находящихся в обработке при чтении файла. */
+ #define ak_mac_file_read_buffers  ( 4 )
+/*! \brief Размер одного буффера при чтении файла (в октетах). */
+ #define ak_mac_file_read_buffer_size  ( (size_t) 1024*1024 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Кольцевая очередь буфферов, разделяемая потоком чтения и потоком сжатия. */
+ struct mac_file_pipeline {
+  /*! \brief Контекст файла. */
+   ak_file file;
+  /*! \brief Буфферы для считываемых данных. */
+   ak_uint8 *buffer[ak_mac_file_read_buffers];
+  /*! \brief Количество октетов, считанных в каждый из буфферов. */
+   size_t length[ak_mac_file_read_buffers];
+  /*! \brief Индекс первого заполненного буффера. */
+   size_t head;
+  /*! \brief Количество заполненных буфферов. */
+   size_t count;
+  /*! \brief Флаг завершения чтения (достигнут конец файла или возникла ошибка). */
+   bool_t done;
+  /*! \brief Флаг досрочной остановки потока чтения. */
+   bool_t stop;
+  /*! \brief Код ошибки чтения. */
+   int error;
+  /*! \brief Мьютекс, защищающий поля очереди. */
+   pthread_mutex_t mutex;
+  /*! \brief Условная переменная для ожидания изменения состояния очереди. */
+   pthread_cond_t cond;
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Поток чтения: заполняет свободные буфферы очереди данными из файла.
+    \details Буффер заполняется полностью, пока не будет достигнут конец файла, поэтому
+    короткое чтение (например, из канала) не приводит к преждевременному завершению.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_mac_file_pipeline_reader( void *ptr )
+{
+  struct mac_file_pipeline *pl = ( struct mac_file_pipeline * )ptr;
+
+  for( ;; ) {
+    size_t tail, len = 0;
+    ssize_t res = 0;
+
+    pthread_mutex_lock( &pl->mutex );
+    while(( pl->count == ak_mac_file_read_buffers ) && !pl->stop )
+      pthread_cond_wait( &pl->cond, &pl->mutex );
+    tail = ( pl->head + pl->count )%ak_mac_file_read_buffers;
+    if( pl->stop ) {
+      pthread_mutex_unlock( &pl->mutex );
+      break;
+    }
+    pthread_mutex_unlock( &pl->mutex );
+
+   /* чтение выполняется без блокировки, параллельно со сжатием других буфферов */
+    while( len < ak_mac_file_read_buffer_size ) {
+      if(( res = ak_file_read( pl->file, pl->buffer[tail] + len,
+                                               ak_mac_file_read_buffer_size - len )) <= 0 ) break;
+      len += ( size_t )res;
+    }
+
+    pthread_mutex_lock( &pl->mutex );
+    pl->length[tail] = len;
+    pl->count++;
+    if( res < 0 ) pl->error = ak_error_read_data;
+    if( len < ak_mac_file_read_buffer_size ) pl->done = ak_true;
+    pthread_cond_broadcast( &pl->cond );
+    pthread_mutex_unlock( &pl->mutex );
+    if( len < ak_mac_file_read_buffer_size ) break;
+  }
+
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сжимает открытый файл, совмещая чтение данных с их обработкой.
+
+    Отдельный поток считывает файл в кольцевую очередь буфферов, в то время как вызывающий
+    поток сжимает уже считанные данные. Таким образом, устройство хранения и процессор
+    работают одновременно. Если создать поток не удалось, файл обрабатывается последовательно.   */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_mac_file_pipeline( ak_mac mctx, ak_file file, ak_pointer out, const size_t out_size )
+{
+  size_t idx = 0;
+  pthread_t reader;
+  int error = ak_error_ok;
+  struct mac_file_pipeline pl;
+
+  memset( &pl, 0, sizeof( struct mac_file_pipeline ));
+  pl.file = file;
+  for( idx = 0; idx < ak_mac_file_read_buffers; idx++ )
+     if(( pl.buffer[idx] = ak_aligned_malloc( ak_mac_file_read_buffer_size )) == NULL ) {
+       while( idx > 0 ) free( pl.buffer[--idx] );
+       return ak_mac_file_read( mctx, file, out, out_size );
+     }
+  pthread_mutex_init( &pl.mutex, NULL );
+  pthread_cond_init( &pl.cond, NULL );
+
+  if( pthread_create( &reader, NULL, ak_mac_file_pipeline_reader, &pl ) != 0 )
+    error = ak_mac_file_read( mctx, file, out, out_size );
+   else {
+     for( ;; ) {
+       size_t len = 0;
+       bool_t last = ak_false;
+
+       pthread_mutex_lock( &pl.mutex );
+       while( !pl.count ) pthread_cond_wait( &pl.cond, &pl.mutex );
+       len = pl.length[pl.head];
+       last = ( pl.count == 1 ) && pl.done;
+       if( last && ( pl.error != ak_error_ok )) error = pl.error;
+       pthread_mutex_unlock( &pl.mutex );
+
+       if( error != ak_error_ok ) break;
+      /* полные буфферы имеют длину, кратную длине блока, и сжимаются без копирования */
+       if( last ) error = ak_mac_finalize( mctx, pl.buffer[pl.head], len, out, out_size );
+         else error = ak_mac_update( mctx, pl.buffer[pl.head], len );
+
+       pthread_mutex_lock( &pl.mutex );
+       pl.head = ( pl.head + 1 )%ak_mac_file_read_buffers;
+       pl.count--;
+       if( error != ak_error_ok ) pl.stop = ak_true;
+       pthread_cond_broadcast( &pl.cond );
+       pthread_mutex_unlock( &pl.mutex );
+       if( last || ( error != ak_error_ok )) break;
+     }
+     pthread_mutex_lock( &pl.mutex );
+     pl.stop = ak_true;
+     pthread_cond_broadcast( &pl.cond );
+     pthread_mutex_unlock( &pl.mutex );
+     pthread_join( reader, NULL );
+   }
+
+  pthread_cond_destroy( &pl.cond );
+  pthread_mutex_destroy( &pl.mutex );
+  for( idx = 0; idx < ak_mac_file_read_buffers; idx++ ) free( pl.buffer[idx] );
+  if( error != ak_error_ok ) ak_error_message( error, __func__, "incorrect processing of file data" );
+
+ return error;
+}
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет результат сжимающего отображения для заданного файла и помещает
     его в область памяти, на которую указывает out.
@@ -197,16 +444,20 @@
     быть определен с помощью вызова соответствующей функции, например, ak_hash_context_get_tag_size().
     @param out_size Размер области памяти (в октетах), в которую будет помещен результат.
 
+    \warning Файл отображается в память, поэтому он не должен изменяться другими процессами
+    во время вычисления результата.
+
     @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
     возвращается код ошибки.                                                                       */
 /* ----------------------------------------------------------------------------------------------- */
  int ak_mac_file( ak_mac mctx, const char* filename, ak_pointer out, const size_t out_size )
 {
-  size_t len = 0;
   struct file file;
   int error = ak_error_ok;
-  size_t block_size = 4096; /* оптимальная длина блока для Windows пока не ясна */
-  ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+  bool_t regular = ak_true;
+#if defined( AK_HAVE_SYSSTAT_H ) && !defined( AK_HAVE_WINDOWS_H )
+  struct stat st;
+#endif
 
  /* выполняем необходимые проверки */
   if( mctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
@@ -219,37 +470,39 @@
   if(( error = ak_file_open_to_read( &file, filename )) != ak_error_ok )
     return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
 
+#if defined( AK_HAVE_SYSSTAT_H ) && !defined( AK_HAVE_WINDOWS_H )
+ /* размер каналов и символьных устройств заранее неизвестен, они могут быть только считаны */
+  if(( fstat( file.fd, &st ) == 0 ) && !S_ISREG( st.st_mode )) regular = ak_false;
+#endif
+
  /* для файла нулевой длины результатом будет хеш от нулевого вектора */
-  if( !file.size ) {
+  if( !file.size && regular ) {
     ak_file_close( &file );
     return ak_mac_finalize( mctx, "", 0, out, out_size );
   }
 
- /* готовим область для хранения данных */
-  block_size = ak_max( ( size_t )file.blksize, mctx->bsize );
- /* здесь мы выделяем локальный буффер для считывания/обработки данных */
-  if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
-    ak_file_close( &file );
-    return ak_error_message( ak_error_out_of_memory, __func__ ,
-                                                      "memory allocation error for local buffer" );
+#ifdef AK_HAVE_SYSMMAN_H
+ /* сначала пытаемся обработать файл без копирования данных, отображая его в память;
+    если это невозможно (например, для специальных файлов), то используем чтение */
+  if( regular ) {
+    if(( error = ak_mac_file_mapped( mctx, &file, out, out_size )) != ak_error_mmap_file ) {
+      ak_mac_clean( mctx );
+      ak_file_close( &file );
+      return error;
+    }
+    ak_error_set_value( error = ak_error_ok );
   }
- /* теперь обрабатываем файл с данными */
-  read_label: len = ( size_t ) ak_file_read( &file, localbuffer, block_size );
-  if( len == block_size ) {
-    ak_mac_update( mctx, localbuffer, block_size ); /* добавляем считанные данные */
-    goto read_label;
-  } else {
-           size_t qcnt = len / mctx->bsize,
-                  tail = len - qcnt*mctx->bsize;
-           if( qcnt ) ak_mac_update( mctx, localbuffer, qcnt*mctx->bsize );
-           error = ak_mac_finalize( mctx,
-                                             localbuffer + qcnt*mctx->bsize, tail, out, out_size );
-         }
+#endif
+
+#ifdef AK_HAVE_PTHREAD_H
+  error = ak_mac_file_pipeline( mctx, &file, out, out_size );
+#else
+  error = ak_mac_file_read( mctx, &file, out, out_size );
+#endif
  /* очищаем за собой данные, содержащиеся в контексте */
   ak_mac_clean( mctx );
  /* закрываем данные */
   ak_file_close( &file );
-  free( localbuffer );
  return error;
 }
 
@@ -4,7 +4,7 @@
 /*  Файл ak_mpzn.c                                                                                 */
 /*  - содержит реализации функций для вычислений с большими целыми числами                         */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup math-doc Математические функции
@@ -660,29 +660,64 @@
                                                                 ak_uint64 *p, const size_t size )
 {
   size_t i = 0;
-  ak_uint64 av = 0, bv = 0, cy = 0;
-  ak_mpznmax t = ak_mpznmax_zero;
+  ak_uint64 av = 0, bv = 0, cy = 0, br = 0, mask = 0, t[ak_mpznmax_size];
 
- // сначала складываем: (x + y) -> t
-  for( i = 0; i < size; i++, x++, y++ ) {
-     av = *x; bv = *y;
+ // складываем (x + y) -> t и одновременно вычитаем (t - p) -> z
+  for( i = 0; i < size; i++ ) {
+     av = x[i]; bv = y[i];
      bv += cy;
      cy = bv < cy;
      bv += av;
      cy += bv < av;
      t[i] = bv;
+     av = bv - br;
+     br = av > bv;
+     bv = av - p[i];
+     br += bv > av;
+     z[i] = bv;
   }
-  t[size] = cy; cy = 0;
- // потом вычитаем: (t - p) -> z
-  for( i = 0; i < size; i++, p++ ) {
-     av = t[i];
+ // если сумма оказалась меньше модуля, то возвращаем ее
+  mask = 0 - ( br&( cy^1 ));
+  for( i = 0; i < size; i++ ) z[i] ^= mask&( z[i]^t[i] );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычитает из вычета x вычет y и приводит полученную разность по модулю p, то есть
+    вычисляет значение сравнения \f$ z \equiv x - y \pmod{p}\f$. Если разность отрицательна,
+    то к ней прибавляется модуль; выбор выполняется с помощью маски.
+    Указатель на z может совпадать с одним из указателей на аргументы.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Уменьшаемое
+    @param y Вычитаемое
+    @param p Модуль, по которому производится операция вычитания
+    @param size Размер модуля в словах (значение константы ak_mpzn256_size или ak_mpzn512_size )   */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_mpzn_sub_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 av = 0, bv = 0, cy = 0, mask = 0;
+
+ // сначала вычитаем: (x - y) -> z
+  for( i = 0; i < size; i++ ) {
+     av = x[i];
      bv = av - cy;
      cy = bv > av;
-     av = bv - *p;
+     av = bv - y[i];
      cy += av > bv;
      z[i] = av;
   }
-  if( t[size] != cy ) memcpy( z, t, size*sizeof( ak_uint64 ));
+ // потом, если был заем, прибавляем модуль
+  mask = 0 - cy; cy = 0;
+  for( i = 0; i < size; i++ ) {
+     av = p[i]&mask;
+     bv = z[i] + cy;
+     cy = bv < cy;
+     bv += av;
+     cy += bv < av;
+     z[i] = bv;
+  }
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -702,21 +737,20 @@
  void ak_mpzn_lshift_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
 {
   size_t i;
-  ak_uint64 av = 0, bv = 0, cy = 0;
-  ak_mpznmax t = ak_mpznmax_zero;
+  ak_uint64 av = 0, bv = 0, cy = 0, hi = 0, mask = 0, t[ak_mpznmax_size];
 
-  t[size] = 0;
-  for( i = 0; i < size; i++, p++ ) {
-    t[i+1] =  (( x[i]&0x8000000000000000LL ) > 0 );
-    t[i] |= x[i] << 1; // сначала сдвигаем на один разряд влево
-    av = t[i];         // потом вычитаем модуль
+  for( i = 0; i < size; i++ ) {
+    t[i] = ( x[i] << 1 )|hi; // сначала сдвигаем на один разряд влево
+    hi = x[i] >> 63;
+    av = t[i];               // потом вычитаем модуль
     bv = av - cy;
     cy = bv > av;
-    av = bv - *p;
+    av = bv - p[i];
     cy += av > bv;
     z[i] = av;
-   }
-   if( t[size] != cy ) memcpy( z, t, size*sizeof( ak_uint64 ));
+  }
+  mask = 0 - ( cy&( hi^1 ));
+  for( i = 0; i < size; i++ ) z[i] ^= mask&( z[i]^t[i] );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -795,6 +829,635 @@
   if( cy != t[2*size] ) memcpy( z, t+size, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                 умножение в представлении Монтгомери для вычетов фиксированной длины            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Финальное вычитание: \f$ z = t - p \f$, если \f$ t \geq p \f$, иначе \f$ z = t \f$.
+    Значение t занимает size+1 слово; выбор выполняется с помощью маски.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_select_fixed( ak_uint64 *z, ak_uint64 *t, ak_uint64 *p,
+                                                                                const size_t size )
+{
+  size_t j = 0;
+  ak_uint64 w0, w1, b, mask, u[ak_mpzn512_size];
+
+  for( j = 0, b = 0; j < size; j++ ) {
+     w0 = t[j] - p[j]; w1 = w0 - b;
+     b = ( w0 > t[j] ) | ( w1 > w0 );
+     u[j] = w1;
+  }
+  mask = 0 - ( b&( t[size]^1 ));
+  for( j = 0; j < size; j++ ) z[j] = u[j]^( mask&( u[j]^t[j] ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение в представлении Монтгомери для вычетов фиксированной длины.
+
+    Функция реализует метод CIOS (coarsely integrated operand scanning), в котором умножение
+    на очередное слово множителя чередуется с шагом редукции. Функция вызывается
+    с константным значением size, поэтому компилятор полностью разворачивает все циклы.
+    В отличие от функции ak_mpzn_mul_montgomery(), финальное вычитание модуля выполняется
+    с помощью маски и не содержит ветвлений.                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_montgomery_fixed( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 w0, w1, c, m, t[ak_mpzn512_size+2];
+
+  for( j = 0; j < size+2; j++ ) t[j] = 0;
+  for( i = 0; i < size; i++ ) {
+    /* t <- t + x[i]*y */
+     c = 0;
+     for( j = 0; j < size; j++ ) {
+        umul_ppmm( w1, w0, x[i], y[j] );
+        w0 += c; w1 += w0 < c;
+        t[j] += w0; w1 += t[j] < w0;
+        c = w1;
+     }
+     t[size] += c; t[size+1] = t[size] < c;
+
+    /* t <- (t + m*p)/2^64 */
+     m = t[0]*n0;
+     umul_ppmm( w1, w0, m, p[0] );
+     w0 += t[0]; c = w1 + ( w0 < t[0] );
+     for( j = 1; j < size; j++ ) {
+        umul_ppmm( w1, w0, m, p[j] );
+        w0 += c; w1 += w0 < c;
+        w0 += t[j]; w1 += w0 < t[j];
+        t[j-1] = w0; c = w1;
+     }
+     t[size-1] = t[size] + c; t[size] = t[size+1] + ( t[size-1] < c );
+  }
+
+ /* z <- t - p, если t >= p, иначе z <- t */
+  ak_mpzn_select_fixed( z, t, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление произведения \f$ t = xy \f$ длины 2*size слов для вычетов фиксированной длины. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_fixed( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y,
+                                                                                const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 w0, w1, c;
+
+  for( j = 0; j < size; j++ ) t[j] = 0;
+  for( i = 0; i < size; i++ ) {
+     c = 0;
+     for( j = 0; j < size; j++ ) {
+        umul_ppmm( w1, w0, x[i], y[j] );
+        w0 += c; w1 += w0 < c;
+        t[i+j] += w0; w1 += t[i+j] < w0;
+        c = w1;
+     }
+     t[i+size] = c;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление квадрата \f$ t = x^2 \f$ длины 2*size слов для вычетов фиксированной длины.
+
+    Каждое из произведений \f$ x_ix_j, i < j \f$ вычисляется один раз и удваивается сдвигом,
+    что экономит \f$ \frac{size(size-1)}{2} \f$ умножений машинных слов.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_sqr_fixed( ak_uint64 *t, ak_uint64 *x, const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 w0, w1, c;
+
+  for( j = 0; j < 2*size; j++ ) t[j] = 0;
+ /* попарные произведения x[i]*x[j], i < j */
+  for( i = 0; i < size-1; i++ ) {
+     c = 0;
+     for( j = i+1; j < size; j++ ) {
+        umul_ppmm( w1, w0, x[i], x[j] );
+        w0 += c; w1 += w0 < c;
+        t[i+j] += w0; w1 += t[i+j] < w0;
+        c = w1;
+     }
+     t[i+size] = c;
+  }
+ /* удваиваем и добавляем квадраты x[i]^2 */
+  for( j = 2*size-1; j > 0; j-- ) t[j] = ( t[j] << 1 )^( t[j-1] >> 63 );
+  for( i = 0, c = 0; i < size; i++ ) {
+     umul_ppmm( w1, w0, x[i], x[i] );
+     w0 += c; w1 += w0 < c;
+     t[2*i] += w0; w1 += t[2*i] < w0;
+     t[2*i+1] += w1; c = t[2*i+1] < w1;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Редукция Монтгомери \f$ z = tr^{-1} \pmod{p} \f$ для значения t длины 2*size слов. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_redc_fixed( ak_uint64 *z, ak_uint64 *t,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 w0, w1, c, m;
+
+  t[2*size] = 0;
+  for( i = 0; i < size; i++ ) {
+     m = t[i]*n0; c = 0;
+     for( j = 0; j < size; j++ ) {
+        umul_ppmm( w1, w0, m, p[j] );
+        w0 += c; w1 += w0 < c;
+        t[i+j] += w0; w1 += t[i+j] < w0;
+        c = w1;
+     }
+     for( j = i+size; j < 2*size+1; j++ ) {
+        t[j] += c; c = t[j] < c;
+     }
+  }
+  ak_mpzn_select_fixed( z, t+size, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Редукция Монтгомери по модулю вида \f$ p = 2^{64 \cdot size} - c \f$.
+
+    Для такого модуля слагаемое \f$ mp = m2^{64 \cdot size} - mc \f$, добавляемое на i-м шаге
+    редукции, вычисляется с помощью одного умножения машинных слов. Поскольку
+    \f$ mc \equiv t_i \pmod{2^{64}} \f$, младшее слово произведения обнуляет \f$ t_i \f$, а старшее
+    вычитается из \f$ t_{i+1} \f$; заем переносится на следующий шаг. Слагаемые
+    \f$ m2^{64 \cdot (size+i)} \f$ не влияют на последующие шаги и добавляются к результату
+    одним сложением после завершения цикла.                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_redc_pseudo_mersenne_fixed( ak_uint64 *z, ak_uint64 *t,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 w0, w1, b = 0, c = 0, m[ak_mpzn512_size], cp = 0 - p[0];
+
+  for( i = 0; i < size; i++ ) {
+     m[i] = t[i]*n0;
+     umul_ppmm( w1, w0, m[i], cp );
+     w1 += b; w0 = t[i+1] - w1;
+     b = w0 > t[i+1];
+     t[i+1] = w0;
+  }
+ /* t <- t/2^{64*size} + m - b*2^64 */
+  for( i = 0; i < size; i++ ) {
+     w0 = t[size+i] + c; c = w0 < c;
+     w0 += m[i]; c += w0 < m[i];
+     t[size+i] = w0;
+  }
+  for( i = 1; i < size; i++ ) {
+     w0 = t[size+i] - b; b = w0 > t[size+i];
+     t[size+i] = w0;
+  }
+  t[2*size] = c - b;
+  ak_mpzn_select_fixed( z, t+size, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Флаг использования реализации умножения на основе инструкций mulx, adcx и adox.
+    Значение устанавливается при инициализации библиотеки функцией ak_mpzn_set_functions(). */
+ static bool_t ak_mpzn_use_mulx = ak_false;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выбирает реализацию умножения вычетов в представлении Монтгомери
+    в соответствии с набором доступных расширений процессора. Инструкции mulx, adcx и adox
+    (расширения BMI2 и ADX) используются только в случае, если они поддерживаются
+    процессором, на котором выполняется программа, вне зависимости от флагов компиляции.
+
+    @param features Маска расширений процессора, которые разрешено использовать.
+    @return Функция возвращает маску реально используемых расширений.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint32 ak_mpzn_set_functions( const ak_uint32 features )
+{
+#ifdef LIBAKRYPT_HAVE_ASM_CODE
+  ak_mpzn_use_mulx = ( features&ak_cpu_feature_mulx ) ? ak_true : ak_false;
+#else
+  (void) features;
+  ak_mpzn_use_mulx = ak_false;
+#endif
+ return ak_mpzn_use_mulx ? ak_cpu_feature_mulx : 0;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef LIBAKRYPT_HAVE_ASM_CODE
+ #define LIBAKRYPT_HAVE_MULX_CODE
+
+/* Реализация метода CIOS с помощью инструкций mulx, adcx и adox, позволяющих вести две
+   независимые цепочки переносов. Все данные размещаются в одном буфере, адрес которого
+   передается в регистре rsi: x (смещение 0), y (8*size), p (16*size), n0 (24*size)
+   и результат (24*size + 8). Промежуточное значение t занимает size+2 регистра, которые
+   после каждого шага редукции циклически переименовываются, поэтому сдвиг t не требует
+   пересылок. */
+
+/*! \brief Шаг t[j] += lo(m*v[j]), t[j+1] += hi(m*v[j]), где m находится в регистре rdx. */
+ #define ak_mulx_mac( base, j, tj, tj1 ) \
+  "mulxq " #base "+8*" #j "(%%rsi), %%rax, %%rbx\n\t" \
+  "adcxq %%rax, %%" #tj "\n\t" \
+  "adoxq %%rbx, %%" #tj1 "\n\t"
+
+/*! \brief Добавление переносов из цепочек CF и OF в старшие слова t. */
+ #define ak_mulx_fold( tn, tn1 ) \
+  "movl $0, %%eax\n\t" \
+  "adoxq %%rax, %%" #tn1 "\n\t" \
+  "adcxq %%rax, %%" #tn "\n\t" \
+  "adcxq %%rax, %%" #tn1 "\n\t"
+
+/*! \brief Шаг t <- t + x[i]*y для вычетов длины 4. */
+ #define ak_mulx_mul4( i, t0, t1, t2, t3, t4, t5 ) \
+  "movq 8*" #i "(%%rsi), %%rdx\n\t" \
+  "xorl %%eax, %%eax\n\t" \
+  ak_mulx_mac( 32, 0, t0, t1 ) \
+  ak_mulx_mac( 32, 1, t1, t2 ) \
+  ak_mulx_mac( 32, 2, t2, t3 ) \
+  ak_mulx_mac( 32, 3, t3, t4 ) \
+  ak_mulx_fold( t4, t5 )
+/*! \brief Шаг редукции t <- t + (t[0]*n0 mod 2^64)*p для вычетов длины 4. */
+ #define ak_mulx_red4( t0, t1, t2, t3, t4, t5 ) \
+  "movq %%" #t0 ", %%rdx\n\t" \
+  "imulq 96(%%rsi), %%rdx\n\t" \
+  "xorl %%eax, %%eax\n\t" \
+  ak_mulx_mac( 64, 0, t0, t1 ) \
+  ak_mulx_mac( 64, 1, t1, t2 ) \
+  ak_mulx_mac( 64, 2, t2, t3 ) \
+  ak_mulx_mac( 64, 3, t3, t4 ) \
+  ak_mulx_fold( t4, t5 )
+
+/*! \brief Шаг t <- t + x[i]*y для вычетов длины 8. */
+ #define ak_mulx_mul8( i, t0, t1, t2, t3, t4, t5, t6, t7, t8, t9 ) \
+  "movq 8*" #i "(%%rsi), %%rdx\n\t" \
+  "xorl %%eax, %%eax\n\t" \
+  ak_mulx_mac( 64, 0, t0, t1 ) \
+  ak_mulx_mac( 64, 1, t1, t2 ) \
+  ak_mulx_mac( 64, 2, t2, t3 ) \
+  ak_mulx_mac( 64, 3, t3, t4 ) \
+  ak_mulx_mac( 64, 4, t4, t5 ) \
+  ak_mulx_mac( 64, 5, t5, t6 ) \
+  ak_mulx_mac( 64, 6, t6, t7 ) \
+  ak_mulx_mac( 64, 7, t7, t8 ) \
+  ak_mulx_fold( t8, t9 )
+/*! \brief Шаг редукции t <- t + (t[0]*n0 mod 2^64)*p для вычетов длины 8. */
+ #define ak_mulx_red8( t0, t1, t2, t3, t4, t5, t6, t7, t8, t9 ) \
+  "movq %%" #t0 ", %%rdx\n\t" \
+  "imulq 192(%%rsi), %%rdx\n\t" \
+  "xorl %%eax, %%eax\n\t" \
+  ak_mulx_mac( 128, 0, t0, t1 ) \
+  ak_mulx_mac( 128, 1, t1, t2 ) \
+  ak_mulx_mac( 128, 2, t2, t3 ) \
+  ak_mulx_mac( 128, 3, t3, t4 ) \
+  ak_mulx_mac( 128, 4, t4, t5 ) \
+  ak_mulx_mac( 128, 5, t5, t6 ) \
+  ak_mulx_mac( 128, 6, t6, t7 ) \
+  ak_mulx_mac( 128, 7, t7, t8 ) \
+  ak_mulx_fold( t8, t9 )
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_mul_montgomery_mulx4( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                       ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 buf[4*ak_mpzn256_size+1];
+
+  memcpy( buf, x, sizeof( ak_mpzn256 ));
+  memcpy( buf+ak_mpzn256_size, y, sizeof( ak_mpzn256 ));
+  memcpy( buf+2*ak_mpzn256_size, p, sizeof( ak_mpzn256 ));
+  buf[3*ak_mpzn256_size] = n0;
+
+  __asm__ __volatile__ (
+  "xorl %%ecx, %%ecx\n\t"
+  "xorl %%edi, %%edi\n\t"
+  "xorl %%r8d, %%r8d\n\t"
+  "xorl %%r9d, %%r9d\n\t"
+  "xorl %%r10d, %%r10d\n\t"
+  "xorl %%r11d, %%r11d\n\t"
+  ak_mulx_mul4( 0, rcx, rdi, r8, r9, r10, r11 )
+  ak_mulx_red4( rcx, rdi, r8, r9, r10, r11 )
+  ak_mulx_mul4( 1, rdi, r8, r9, r10, r11, rcx )
+  ak_mulx_red4( rdi, r8, r9, r10, r11, rcx )
+  ak_mulx_mul4( 2, r8, r9, r10, r11, rcx, rdi )
+  ak_mulx_red4( r8, r9, r10, r11, rcx, rdi )
+  ak_mulx_mul4( 3, r9, r10, r11, rcx, rdi, r8 )
+  ak_mulx_red4( r9, r10, r11, rcx, rdi, r8 )
+  "movq %%r10, 104+8*0(%%rsi)\n\t"
+  "movq %%r11, 104+8*1(%%rsi)\n\t"
+  "movq %%rcx, 104+8*2(%%rsi)\n\t"
+  "movq %%rdi, 104+8*3(%%rsi)\n\t"
+  "subq 64(%%rsi), %%r10\n\t"
+  "sbbq 64+8*1(%%rsi), %%r11\n\t"
+  "sbbq 64+8*2(%%rsi), %%rcx\n\t"
+  "sbbq 64+8*3(%%rsi), %%rdi\n\t"
+  "sbbq $0, %%r8\n\t"
+  "cmovcq 104+8*0(%%rsi), %%r10\n\t"
+  "movq %%r10, 104+8*0(%%rsi)\n\t"
+  "cmovcq 104+8*1(%%rsi), %%r11\n\t"
+  "movq %%r11, 104+8*1(%%rsi)\n\t"
+  "cmovcq 104+8*2(%%rsi), %%rcx\n\t"
+  "movq %%rcx, 104+8*2(%%rsi)\n\t"
+  "cmovcq 104+8*3(%%rsi), %%rdi\n\t"
+  "movq %%rdi, 104+8*3(%%rsi)\n\t"
+  :
+  : "S" ( buf )
+  : "rax", "rbx", "rdx", "rcx", "rdi", "r8", "r9", "r10", "r11", "cc", "memory" );
+
+  memcpy( z, buf+3*ak_mpzn256_size+1, sizeof( ak_mpzn256 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_mul_montgomery_mulx8( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                       ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 buf[4*ak_mpzn512_size+1];
+
+  memcpy( buf, x, sizeof( ak_mpzn512 ));
+  memcpy( buf+ak_mpzn512_size, y, sizeof( ak_mpzn512 ));
+  memcpy( buf+2*ak_mpzn512_size, p, sizeof( ak_mpzn512 ));
+  buf[3*ak_mpzn512_size] = n0;
+
+  __asm__ __volatile__ (
+  "xorl %%ecx, %%ecx\n\t"
+  "xorl %%edi, %%edi\n\t"
+  "xorl %%r8d, %%r8d\n\t"
+  "xorl %%r9d, %%r9d\n\t"
+  "xorl %%r10d, %%r10d\n\t"
+  "xorl %%r11d, %%r11d\n\t"
+  "xorl %%r12d, %%r12d\n\t"
+  "xorl %%r13d, %%r13d\n\t"
+  "xorl %%r14d, %%r14d\n\t"
+  "xorl %%r15d, %%r15d\n\t"
+  ak_mulx_mul8( 0, rcx, rdi, r8, r9, r10, r11, r12, r13, r14, r15 )
+  ak_mulx_red8( rcx, rdi, r8, r9, r10, r11, r12, r13, r14, r15 )
+  ak_mulx_mul8( 1, rdi, r8, r9, r10, r11, r12, r13, r14, r15, rcx )
+  ak_mulx_red8( rdi, r8, r9, r10, r11, r12, r13, r14, r15, rcx )
+  ak_mulx_mul8( 2, r8, r9, r10, r11, r12, r13, r14, r15, rcx, rdi )
+  ak_mulx_red8( r8, r9, r10, r11, r12, r13, r14, r15, rcx, rdi )
+  ak_mulx_mul8( 3, r9, r10, r11, r12, r13, r14, r15, rcx, rdi, r8 )
+  ak_mulx_red8( r9, r10, r11, r12, r13, r14, r15, rcx, rdi, r8 )
+  ak_mulx_mul8( 4, r10, r11, r12, r13, r14, r15, rcx, rdi, r8, r9 )
+  ak_mulx_red8( r10, r11, r12, r13, r14, r15, rcx, rdi, r8, r9 )
+  ak_mulx_mul8( 5, r11, r12, r13, r14, r15, rcx, rdi, r8, r9, r10 )
+  ak_mulx_red8( r11, r12, r13, r14, r15, rcx, rdi, r8, r9, r10 )
+  ak_mulx_mul8( 6, r12, r13, r14, r15, rcx, rdi, r8, r9, r10, r11 )
+  ak_mulx_red8( r12, r13, r14, r15, rcx, rdi, r8, r9, r10, r11 )
+  ak_mulx_mul8( 7, r13, r14, r15, rcx, rdi, r8, r9, r10, r11, r12 )
+  ak_mulx_red8( r13, r14, r15, rcx, rdi, r8, r9, r10, r11, r12 )
+  "movq %%r14, 200+8*0(%%rsi)\n\t"
+  "movq %%r15, 200+8*1(%%rsi)\n\t"
+  "movq %%rcx, 200+8*2(%%rsi)\n\t"
+  "movq %%rdi, 200+8*3(%%rsi)\n\t"
+  "movq %%r8, 200+8*4(%%rsi)\n\t"
+  "movq %%r9, 200+8*5(%%rsi)\n\t"
+  "movq %%r10, 200+8*6(%%rsi)\n\t"
+  "movq %%r11, 200+8*7(%%rsi)\n\t"
+  "subq 128(%%rsi), %%r14\n\t"
+  "sbbq 128+8*1(%%rsi), %%r15\n\t"
+  "sbbq 128+8*2(%%rsi), %%rcx\n\t"
+  "sbbq 128+8*3(%%rsi), %%rdi\n\t"
+  "sbbq 128+8*4(%%rsi), %%r8\n\t"
+  "sbbq 128+8*5(%%rsi), %%r9\n\t"
+  "sbbq 128+8*6(%%rsi), %%r10\n\t"
+  "sbbq 128+8*7(%%rsi), %%r11\n\t"
+  "sbbq $0, %%r12\n\t"
+  "cmovcq 200+8*0(%%rsi), %%r14\n\t"
+  "movq %%r14, 200+8*0(%%rsi)\n\t"
+  "cmovcq 200+8*1(%%rsi), %%r15\n\t"
+  "movq %%r15, 200+8*1(%%rsi)\n\t"
+  "cmovcq 200+8*2(%%rsi), %%rcx\n\t"
+  "movq %%rcx, 200+8*2(%%rsi)\n\t"
+  "cmovcq 200+8*3(%%rsi), %%rdi\n\t"
+  "movq %%rdi, 200+8*3(%%rsi)\n\t"
+  "cmovcq 200+8*4(%%rsi), %%r8\n\t"
+  "movq %%r8, 200+8*4(%%rsi)\n\t"
+  "cmovcq 200+8*5(%%rsi), %%r9\n\t"
+  "movq %%r9, 200+8*5(%%rsi)\n\t"
+  "cmovcq 200+8*6(%%rsi), %%r10\n\t"
+  "movq %%r10, 200+8*6(%%rsi)\n\t"
+  "cmovcq 200+8*7(%%rsi), %%r11\n\t"
+  "movq %%r11, 200+8*7(%%rsi)\n\t"
+  :
+  : "S" ( buf )
+  : "rax", "rbx", "rdx", "rcx", "rdi", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "cc", "memory" );
+
+  memcpy( z, buf+3*ak_mpzn512_size+1, sizeof( ak_mpzn512 ));
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция является специализацией функции ak_mpzn_mul_montgomery() для вычетов
+    длины \ref ak_mpzn256_size. Если процессор поддерживает инструкции BMI2 и ADX,
+    то используется реализация на языке ассемблера. Параметр size сохранен для совместимости
+    с типом \ref ak_function_mpzn_mul_montgomery и не используется.
+
+    @param z Вычет, в который помещается результат
+    @param x Левый множитель
+    @param y Правый множитель
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях.
+    @param size Размер модуля в словах (игнорируется)                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_montgomery_256( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx4( z, x, y, p, n0 );
+    return;
+  }
+#endif
+  ak_mpzn_mul_montgomery_fixed( z, x, y, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция является специализацией функции ak_mpzn_mul_montgomery() для вычетов
+    длины \ref ak_mpzn512_size. Параметры функции аналогичны параметрам
+    функции ak_mpzn_mul_montgomery_256().                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_montgomery_512( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx8( z, x, y, p, n0 );
+    return;
+  }
+#endif
+  ak_mpzn_mul_montgomery_fixed( z, x, y, p, n0, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение \f$ z \equiv x^2r^{-1} \pmod{p} \f$ для вычетов
+    длины \ref ak_mpzn256_size.
+
+    @param z Вычет, в который помещается результат
+    @param x Вычет, который возводится в квадрат
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях.
+    @param size Размер модуля в словах (игнорируется)                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_montgomery_256( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx4( z, x, x, p, n0 );
+    return;
+  }
+#endif
+ /* для четырех слов отдельная процедура возведения в квадрат не дает выигрыша */
+  ak_mpzn_mul_montgomery_fixed( z, x, x, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение \f$ z \equiv x^2r^{-1} \pmod{p} \f$ для вычетов
+    длины \ref ak_mpzn512_size. Параметры функции аналогичны параметрам
+    функции ak_mpzn_sqr_montgomery_256().                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_montgomery_512( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn512_size+1];
+
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx8( z, x, x, p, n0 );
+    return;
+  }
+#endif
+  ak_mpzn_sqr_fixed( t, x, ak_mpzn512_size );
+  ak_mpzn_redc_fixed( z, t, p, n0, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция является специализацией функции ak_mpzn_mul_montgomery_256() для модулей
+    вида \f$ p = 2^{256} - c \f$, где \f$ c < 2^{64} \f$, т.е. модулей, у которых все слова, кроме
+    младшего, равны \f$ 2^{64} - 1 \f$. Таким модулем обладают, например, кривые
+    `id-tc26-gost-3410-2012-256-paramSetA` и `id-rfc4357-gost-3410-2001-paramSetA`,
+    для которых \f$ p = 2^{256} - 617 \f$. Результат совпадает с результатом функции
+    ak_mpzn_mul_montgomery_256(), однако каждый шаг редукции Монтгомери требует
+    одного умножения машинных слов вместо четырех. При наличии инструкций mulx/adx
+    используется реализация метода CIOS на ассемблере, которая для таких модулей
+    оказывается не медленнее специализированной редукции.
+
+    @param z Вычет, в который помещается результат
+    @param x Левый множитель
+    @param y Правый множитель
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях.
+    @param size Размер модуля в словах (игнорируется)                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_pseudo_mersenne_256( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn256_size+1];
+
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx4( z, x, y, p, n0 );
+    return;
+  }
+#endif
+  ak_mpzn_mul_fixed( t, x, y, ak_mpzn256_size );
+  ak_mpzn_redc_pseudo_mersenne_fixed( z, t, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция является специализацией функции ak_mpzn_mul_montgomery_512() для модулей
+    вида \f$ p = 2^{512} - c \f$, например, для кривых `id-tc26-gost-3410-2012-512-paramSetA`
+    и `id-tc26-gost-3410-2012-512-paramSetC` с модулем \f$ p = 2^{512} - 569 \f$.
+    Параметры функции аналогичны параметрам функции ak_mpzn_mul_pseudo_mersenne_256().            */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_pseudo_mersenne_512( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn512_size+1];
+
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx8( z, x, y, p, n0 );
+    return;
+  }
+#endif
+  ak_mpzn_mul_fixed( t, x, y, ak_mpzn512_size );
+  ak_mpzn_redc_pseudo_mersenne_fixed( z, t, p, n0, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение \f$ z \equiv x^2r^{-1} \pmod{p} \f$ для модулей
+    вида \f$ p = 2^{256} - c \f$ (см. описание функции ak_mpzn_mul_pseudo_mersenne_256()).
+
+    @param z Вычет, в который помещается результат
+    @param x Вычет, который возводится в квадрат
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях.
+    @param size Размер модуля в словах (игнорируется)                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_pseudo_mersenne_256( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn256_size+1];
+
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx4( z, x, x, p, n0 );
+    return;
+  }
+#endif
+  ak_mpzn_mul_fixed( t, x, x, ak_mpzn256_size );
+  ak_mpzn_redc_pseudo_mersenne_fixed( z, t, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет значение \f$ z \equiv x^2r^{-1} \pmod{p} \f$ для модулей
+    вида \f$ p = 2^{512} - c \f$ (см. описание функции ak_mpzn_mul_pseudo_mersenne_512()).       */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_pseudo_mersenne_512( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn512_size+1];
+
+  (void) size;
+#ifdef LIBAKRYPT_HAVE_MULX_CODE
+  if( ak_mpzn_use_mulx ) {
+    ak_mpzn_mul_montgomery_mulx8( z, x, x, p, n0 );
+    return;
+  }
+#endif
+  ak_mpzn_sqr_fixed( t, x, ak_mpzn512_size );
+  ak_mpzn_redc_pseudo_mersenne_fixed( z, t, p, n0, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выбирает реализацию умножения в представлении Монтгомери,
+    специализированную для заданной длины модуля.                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_function_mpzn_mul_montgomery *ak_mpzn_modpow_get_mul( const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: return ak_mpzn_mul_montgomery_256;
+    case ak_mpzn512_size: return ak_mpzn_mul_montgomery_512;
+    default: return ak_mpzn_mul_montgomery;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение \f$ r \pmod{p} \f$, т.е. единицу в представлении Монтгомери.
+    @return Функция возвращает ложь, если модуль не может использоваться в вычислениях.           */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_mpzn_modpow_set_one( ak_uint64 *one, ak_uint64 *p, const size_t size )
+{
+  ak_mpznmax t;
+
+  memset( one, 0, size*sizeof( ak_uint64 ));
+  if( ak_mpzn_sub( one, one, p, size ) == 0 ) return ak_false; /* one <- 2^n - p */
+  while( ak_mpzn_cmp( one, p, size ) >= 0 ) { /* модуль открыт, поэтому ветвление допустимо */
+    ak_mpzn_sub( t, one, p, size );
+    memcpy( one, t, size*sizeof( ak_uint64 ));
+  }
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ xr \f$, где \f$ r \f$
     заданная степень двойки, вычисляется вычет \f$ z \f$,
@@ -802,6 +1465,12 @@
     Результат \f$ z \f$  является значением вычета \f$ x^k \pmod{p}\f$ в представлении Монтгомери.
     Величины \f$ k \f$  и \f$ p \f$ задаются как обычные вычеты и \f$ p \f$  отлично от нуля.
 
+    Используется метод фиксированного окна ширины 4 бита: заранее вычисляются степени
+    \f$ x^j \f$, \f$ 0 \leq j \leq 15 \f$, после чего для каждого окна показателя выполняется
+    четыре возведения в квадрат и одно умножение. Обрабатываются все \f$ 64\cdot size \f$ бит
+    показателя, а значение из таблицы выбирается с помощью масок, поэтому время работы функции
+    не зависит от значений \f$ x \f$ и \f$ k \f$ и функция может применяться к секретным данным.
+
     @param z Вычет, в который помещается результат
     @param x Вычет, который возводится в степень \f$ k \f$
     @param k Степень, в которую возводится вычет \f$ x \f$
@@ -814,33 +1483,212 @@
  void ak_mpzn_modpow_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
                                                    ak_uint64 *p, ak_uint64 n0, const size_t size )
 {
-  ak_uint64 uk = 0;
-  size_t s = size-1;
-  long long int i, j;
-  ak_mpznmax res = ak_mpznmax_zero; // это константа r (mod p) = r-p
-  if( ak_mpzn_sub( res, res, p, size ) == 0 ) {
-    ak_error_message( ak_error_undefined_value,
-                                          "using an unexpected value of prime modulo", __func__ );
+  size_t i = 0, j = 0, l = 0;
+  ak_uint64 w = 0, mask = 0;
+  ak_mpzn512 table[16], res, t;
+  ak_function_mpzn_mul_montgomery *mul = ak_mpzn_modpow_get_mul( size );
+
+  if(( size > ak_mpzn512_size ) || !ak_mpzn_modpow_set_one( table[0], p, size )) {
+    ak_error_message( ak_error_undefined_value, __func__,
+                                                      "using an unexpected value of prime modulo" );
     return;
   }
-  while( k[s] == 0 ) {
-     if( s > 0 ) --s;
-      else {
-             ak_mpzn_set( z, res, size );
-             return;
-           }
-  }
-  for( i = s; i >= 0; i-- ) {
-     uk = k[i];
-     for( j = 0; j < 64; j++ ) {
-        ak_mpzn_mul_montgomery( res, res, res, p, n0, size );
-        if( uk&0x8000000000000000LL ) ak_mpzn_mul_montgomery( res, res, x, p, n0, size );
-        uk <<= 1;
+  memcpy( table[1], x, size*sizeof( ak_uint64 ));
+  for( j = 2; j < 16; j++ ) mul( table[j], table[j-1], x, p, n0, size );
+  memcpy( res, table[0], size*sizeof( ak_uint64 ));
+
+  for( i = 16*size; i > 0; i-- ) {
+     mul( res, res, res, p, n0, size );
+     mul( res, res, res, p, n0, size );
+     mul( res, res, res, p, n0, size );
+     mul( res, res, res, p, n0, size );
+
+    /* t <- table[w], где w - очередное окно показателя */
+     w = ( k[(i-1) >> 4] >> ( 4*(( i-1 )&0xF )))&0xF;
+     memset( t, 0, size*sizeof( ak_uint64 ));
+     for( j = 0; j < 16; j++ ) {
+        mask = ( ak_uint64 )j ^ w;
+        mask = (( mask | ( 0 - mask )) >> 63 ) - 1; /* mask = -1, если j = w, и 0 иначе */
+        for( l = 0; l < size; l++ ) t[l] |= mask&table[j][l];
+     }
+     mul( res, res, t, p, n0, size );
+  }
+  memcpy( z, res, size*sizeof( ak_uint64 ));
+  memset( table, 0, sizeof( table ));
+  memset( t, 0, sizeof( t ));
+  memset( res, 0, sizeof( res ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет то же значение, что и функция ak_mpzn_modpow_montgomery(), с помощью
+    метода скользящего окна ширины не более 4 бит: заранее вычисляются нечетные степени
+    \f$ x, x^3, \ldots, x^{15} \f$, нулевые биты показателя обрабатываются одним возведением
+    в квадрат, а каждое окно, начинающееся и заканчивающееся единичным битом, - одним умножением.
+    По сравнению с методом фиксированного окна количество умножений уменьшается примерно на треть.
+
+    \warning Время работы функции зависит от значения показателя \f$ k \f$, поэтому функция
+    должна применяться только к открытым данным, например, для проверки параметров
+    или при обращении элементов по простому модулю с помощью малой теоремы Ферма.
+
+    Параметры функции аналогичны параметрам функции ak_mpzn_modpow_montgomery().                  */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_modpow_montgomery_vartime( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
+                                                   ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  long long int i = 0, l = 0;
+  size_t j = 0, w = 0;
+  bool_t started = ak_false;
+  ak_mpzn512 table[8], res;
+  ak_function_mpzn_mul_montgomery *mul = ak_mpzn_modpow_get_mul( size );
+
+  if(( size > ak_mpzn512_size ) || !ak_mpzn_modpow_set_one( res, p, size )) {
+    ak_error_message( ak_error_undefined_value, __func__,
+                                                      "using an unexpected value of prime modulo" );
+    return;
+  }
+ /* table[j] <- x^{2j+1} */
+  memcpy( table[0], x, size*sizeof( ak_uint64 ));
+  mul( table[7], x, x, p, n0, size );
+  for( j = 1; j < 8; j++ ) mul( table[j], table[j-1], table[7], p, n0, size );
+
+  #define ak_mpzn_bit( k, i ) (( k[(i) >> 6] >> ((i)&0x3F ))&1 )
+  for( i = 64*size - 1; i >= 0; ) {
+     if( !ak_mpzn_bit( k, i )) {
+       if( started ) mul( res, res, res, p, n0, size );
+       i--; continue;
      }
+    /* окно [i, l] максимальной ширины, заканчивающееся единичным битом */
+     l = ( i >= 3 ) ? i - 3 : 0;
+     while( !ak_mpzn_bit( k, l )) l++;
+     for( w = 0; i >= l; i-- ) {
+        w = ( w << 1 ) | ak_mpzn_bit( k, i );
+        if( started ) mul( res, res, res, p, n0, size );
+     }
+     if( started ) mul( res, res, table[w >> 1], p, n0, size );
+      else {
+        memcpy( res, table[w >> 1], size*sizeof( ak_uint64 ));
+        started = ak_true;
+      }
   }
+  #undef ak_mpzn_bit
   memcpy( z, res, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \f$, удовлетворяющий сравнению \f$ xz \equiv 1 \pmod{p} \f$,
+    с помощью бинарного расширенного алгоритма Евклида. Вычисления проводятся над обычными
+    вычетами: если \f$ x \f$ задан в представлении Монтгомери в виде \f$ xr \f$, то результатом
+    будет \f$ x^{-1}r^{-1} \pmod{p}\f$ и для возврата в представление Монтгомери результат
+    следует дважды умножить на \f$ r^2 \pmod{p}\f$.
+
+    Алгоритм поддерживает пару вычетов \f$ a \equiv ux, b \equiv vx \pmod{p} \f$, начиная
+    с \f$ a = x, b = p \f$. На каждом шаге из нечетного значения \f$ a \f$ вычитается \f$ b \f$
+    (если \f$ a < b \f$, то значения предварительно меняются местами), после чего \f$ a \f$
+    делится на два. Сумма битовых длин \f$ a \f$ и \f$ b \f$ уменьшается на каждом шаге,
+    поэтому после \f$ 2 \cdot 64 \cdot size \f$ шагов выполняется равенство \f$ a = 0 \f$,
+    а \f$ b = 1 \f$.
+
+    Функция выполняет фиксированное количество шагов, а все ветвления заменены
+    операциями с масками, поэтому время ее работы не зависит от значения \f$ x \f$;
+    функция может применяться к секретным данным.
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет, \f$ 0 < x < p \f$. Для \f$ x = 0 \f$ результат равен нулю.
+    @param p Нечетный модуль, по которому производятся вычисления
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_modinv( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 odd, lt, mu, mv, mh, ba, bu, bv, cn, cu, cv, ch, t, s;
+  ak_mpznmax a, b, d, w1, w2, u = ak_mpznmax_one, v = ak_mpznmax_zero;
+
+  ak_mpzn_set( a, x, size );
+  ak_mpzn_set( b, p, size );
+
+  for( j = 0; j < 128*size; j++ ) {
+     odd = 0 - ( a[0]&1 );
+
+    /* d <- a - b, w1 <- u - v, w2 <- v - u */
+     ba = bu = bv = 0;
+     for( i = 0; i < size; i++ ) {
+        t = a[i] - b[i]; s = t - ba; ba = ( t > a[i] ) | ( s > t ); d[i] = s;
+        t = u[i] - v[i]; s = t - bu; bu = ( t > u[i] ) | ( s > t ); w1[i] = s;
+        t = v[i] - u[i]; s = t - bv; bv = ( t > v[i] ) | ( s > t ); w2[i] = s;
+     }
+     lt = odd & ( 0 - ba ); /* признак того, что значения меняются местами */
+     mu = 0 - bu; mv = 0 - bv;
+
+    /* a <- |a - b|, b <- min(a,b), u <- (u - v) или (v - u) (mod p), v <- u, если a < b
+       одновременно вычисляем u + p, если значение u нечетно, и сдвигаем a и u на один разряд */
+     cn = lt&1; cu = cv = ch = mh = 0;
+     for( i = 0; i < size; i++ ) {
+        t = ( d[i]^lt ) + cn; cn = t < cn; d[i] = t;
+        t = w1[i] + cu; cu = t < cu; s = t + ( p[i]&mu ); cu += s < t; w1[i] = s;
+        t = w2[i] + cv; cv = t < cv; s = t + ( p[i]&mv ); cv += s < t; w2[i] = s;
+
+        b[i] ^= lt & ( a[i]^b[i] );
+        v[i] ^= lt & ( u[i]^v[i] );
+        a[i] ^= odd & ( a[i]^d[i] );
+        u[i] ^= odd & ( u[i]^w1[i]^( lt & ( w1[i]^w2[i] )));
+
+        if( !i ) mh = 0 - ( u[0]&1 );
+        t = u[i] + ch; ch = t < ch; s = t + ( p[i]&mh ); ch += s < t; u[i] = s;
+        if( i ) {
+          a[i-1] = ( a[i-1] >> 1 )^( a[i] << 63 );
+          u[i-1] = ( u[i-1] >> 1 )^( u[i] << 63 );
+        }
+     }
+     a[size-1] >>= 1;
+     u[size-1] = ( u[size-1] >> 1 )^( ch << 63 );
+  }
+  ak_mpzn_set( z, v, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \f$, удовлетворяющий сравнению \f$ xz \equiv 1 \pmod{p} \f$,
+    с помощью того же бинарного алгоритма, что и функция ak_mpzn_modinv(), однако
+    количество шагов алгоритма и выполняемые на каждом шаге действия зависят от значения
+    \f$ x \f$. Поэтому функция работает быстрее, но должна применяться только
+    к открытым данным, например, при проверке электронной подписи.
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет, \f$ 0 < x < p \f$. Для \f$ x = 0 \f$ результат равен нулю.
+    @param p Нечетный модуль, по которому производятся вычисления
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_modinv_vartime( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 cy = 0, *tmp = NULL;
+  ak_mpznmax ma, mb, mu = ak_mpznmax_one, mv = ak_mpznmax_zero;
+  ak_uint64 *a = ma, *b = mb, *u = mu, *v = mv;
+
+  ak_mpzn_set( a, x, size );
+  ak_mpzn_set( b, p, size );
+
+  while( !ak_mpzn_cmp_ui( a, size, 0 )) {
+    /* a <- a/2, u <- u/2 (mod p) */
+     while( !( a[0]&1 )) {
+       for( i = 0; i < size-1; i++ ) a[i] = ( a[i] >> 1 )^( a[i+1] << 63 );
+       a[size-1] >>= 1;
+       cy = ( u[0]&1 ) ? ak_mpzn_add( u, u, p, size ) : 0;
+       for( i = 0; i < size-1; i++ ) u[i] = ( u[i] >> 1 )^( u[i+1] << 63 );
+       u[size-1] = ( u[size-1] >> 1 )^( cy << 63 );
+     }
+    /* a <- a - b, u <- u - v (mod p), при необходимости меняя значения местами */
+     if( ak_mpzn_cmp( a, b, size ) < 0 ) {
+       tmp = a; a = b; b = tmp;
+       tmp = u; u = v; v = tmp;
+     }
+     ak_mpzn_sub( a, a, b, size );
+     if( ak_mpzn_sub( u, u, v, size )) ak_mpzn_add( u, u, p, size );
+  }
+  ak_mpzn_set( z, v, size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_GMP_H
 /* преобразование "туда и обратно" */
@@ -52,6 +52,15 @@
      { "openssl_compability", 0, 0, 1 },
   /* флаг использования цвета при выводе сообщений библиотеки */
      { "use_color_output", 1, 0, 1 },
+  /* максимальное количество потоков, используемых для параллельной обработки данных */
+     { "threads_count", 4, 1, 256 },
+  /* максимальное количество неиспользуемых таблиц кратных точек открытых ключей,
+     хранящихся в кеше */
+     { "verifykey_tables_count", 16, 0, 4096 },
+  /* маска расширений процессора, которые разрешено использовать при выборе реализаций
+     вычислительных функций (младший бит - команда pclmulqdq, следующий - команды mulx/adx);
+     нулевое значение оставляет только переносимые реализации */
+     { "cpu_features", 3, 0, 3 },
      { NULL, 0, 0, 0 } /* завершающая константа, должна всегда принимать нулевые значения */
  };
 
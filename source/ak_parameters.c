@@ -33,7 +33,28 @@
   },
   0xdbf951d5883b2b2fLL, /* n */
   0x66ff43a234713e85LL, /* nq */
-  "8000000000000000000000000000000000000000000000000000000000000431"
+  "8000000000000000000000000000000000000000000000000000000000000431",
+  ak_mpzn_mul_montgomery_256,
+  ak_mpzn_sqr_montgomery_256,
+  ak_false,
+  NULL,
+  ak_mpzn_mul_montgomery_256
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Параметры кривой в форме Эдвардса, эквивалентной кривой
+    `id-tc26-gost-3410-2012-256-paramSetA` (Р 1323565.1.024-2019). */
+/*! \code
+      e = 1,
+      d = "0605F6B7C183FA81578BC39CFAD518132B9DF62897009AF7E522C32D6DC7BFFB",
+      u = "0D",
+      v = "60CA1E32AA475B348488C38FAB07649CE7EF8DBE87F22E81F92B2592DBA300E7"
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static const struct ecurve id_tc26_gost_3410_2012_256_paramSetA_ecurve = {
+  { 0x40c8687d966dd5b1LL, 0x1fb647d3f0757f77LL, 0xffda75588b970634LL, 0x845fa0e16716c1bbLL }, /* d */
+  { 0x2fcde5e09a6488c5LL, 0xf8126e0b03e2a022LL, 0x000962a9dd1a3e72LL, 0xdee817c7a63a4f91LL }, /* s */
+  { 0x8acc116a43bcf88cLL, 0x05490bf8a813953eLL, 0xaaa468e41743d65eLL, 0x6b65457ae683caf4LL }  /* t */
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -63,7 +84,12 @@
   },
   0x46f3234475d5add9LL, /* n */
   0x035bdd1aeafdb0a9LL, /* nq */
-  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffd97"
+  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffd97",
+  ak_mpzn_mul_pseudo_mersenne_256,
+  ak_mpzn_sqr_pseudo_mersenne_256,
+  ak_false,
+  &id_tc26_gost_3410_2012_256_paramSetA_ecurve,
+  ak_mpzn_mul_montgomery_256
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -93,7 +119,12 @@
   },
   0x46f3234475d5add9LL, /* n */
   0x9ee6ea0b57c7da65LL, /* nq */
-  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffd97"
+  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffd97",
+  ak_mpzn_mul_pseudo_mersenne_256,
+  ak_mpzn_sqr_pseudo_mersenne_256,
+  ak_true,
+  NULL,
+  ak_mpzn_mul_montgomery_256
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -123,7 +154,12 @@
   },
   0xbd667ab8a3347857LL, /* n */
   0xca89614990611a91LL, /* nq */
-  "8000000000000000000000000000000000000000000000000000000000000c99"
+  "8000000000000000000000000000000000000000000000000000000000000c99",
+  ak_mpzn_mul_montgomery_256,
+  ak_mpzn_sqr_montgomery_256,
+  ak_true,
+  NULL,
+  ak_mpzn_mul_montgomery_256
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -153,7 +189,12 @@
   },
   0xdf6e6c2c727c176dLL, /* n */
   0xa1c6af0a552f7577LL, /* nq */
-  "9b9f605f5a858107ab1ec85e6b41c8aacf846e86789051d37998f7b9022d759b"
+  "9b9f605f5a858107ab1ec85e6b41c8aacf846e86789051d37998f7b9022d759b",
+  ak_mpzn_mul_montgomery_256,
+  ak_mpzn_sqr_montgomery_256,
+  ak_true,
+  NULL,
+  ak_mpzn_mul_montgomery_256
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -192,7 +233,12 @@
   },
   0x71A1662E6FA1D92DLL, /* n */
   0x40BB2313A95302ADLL, /* nq */
-  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffd215b"
+  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffd215b",
+  ak_mpzn_mul_pseudo_mersenne_256,
+  ak_mpzn_sqr_pseudo_mersenne_256,
+  ak_true,
+  NULL,
+  ak_mpzn_mul_montgomery_256
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -222,7 +268,12 @@
   },
   0xd6412ff7c29b8645LL, /* n */
   0x50bc7d084a21aae1LL, /* nq */
-  "4531acd1fe0023c7550d267b6b2fee80922b14b2ffb90f04d4eb7c09b5d2d15df1d852741af4704a0458047e80e4546d35b8336fac224dd81664bbf528be6373"
+  "4531acd1fe0023c7550d267b6b2fee80922b14b2ffb90f04d4eb7c09b5d2d15df1d852741af4704a0458047e80e4546d35b8336fac224dd81664bbf528be6373",
+  ak_mpzn_mul_montgomery_512,
+  ak_mpzn_sqr_montgomery_512,
+  ak_false,
+  NULL,
+  ak_mpzn_mul_montgomery_512
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -252,7 +303,12 @@
   },
   0x58a1f7e6ce0f4c09LL, /* n */
   0x02ccc1665d51f223LL, /* nq */
-  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffdc7"
+  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffdc7",
+  ak_mpzn_mul_pseudo_mersenne_512,
+  ak_mpzn_sqr_pseudo_mersenne_512,
+  ak_true,
+  NULL,
+  ak_mpzn_mul_montgomery_512
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -283,6 +339,27 @@
   0x4e6a171024e6a171LL, /* n */
   0xc07d62492cbac26bLL, /* nq */
   "8000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000006f",
+  ak_mpzn_mul_montgomery_512,
+  ak_mpzn_sqr_montgomery_512,
+  ak_true,
+  NULL,
+  ak_mpzn_mul_montgomery_512
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Параметры кривой в форме Эдвардса, эквивалентной кривой
+    `id-tc26-gost-3410-2012-512-paramSetC` (Р 1323565.1.024-2019). */
+/*! \code
+      e = 1,
+      d = "9E4F5D8C017D8D9F13A5CF3CDF5BFE4DAB402D54198E31EBDE28A0621050439CA6B39E0A515C06B304E2CE43E79E369E91A0CFC2BC2A22B4CA302DBB33EE7550",
+      u = "12",
+      v = "469AF79D1FB1F5E16B99592B77A01E2A0FDFB0D01794368D9A56117F7B38669522DD4B650CF789EEBF068C5D139732F0905622C04B2BAAE7600303EE73001A3D"
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static const struct ecurve id_tc26_gost_3410_2012_512_paramSetC_ecurve = {
+  { 0x6515a5166d05caf7LL, 0xae6dc7d439a723d5LL, 0xdc1c74edcea76671LL, 0x853a44eed58ae3e5LL, 0xc84c79f64266472eLL, 0xa1a4bfeccd0cf540LL, 0xab899e4c73783aa1LL, 0xde66ec2f500fc692LL }, /* d */
+  { 0xa6ba96ba64be8cb4LL, 0x94648e0af196370aLL, 0x88f8e2c48c562663LL, 0x5eb16ec44a9d4706LL, 0xcdece1826f666e34LL, 0x9796d004ccbcc2afLL, 0x551d986ce321f157LL, 0x486644f42bfc0e5bLL }, /* s */
+  { 0xe62e462e6780f788LL, 0x9d124bf8b44685f8LL, 0xfa04be27a2713bbdLL, 0x163460d278ec7b50LL, 0x76b769a90b110bddLL, 0xf0461ffcccd77e35LL, 0x71ec450cbde95f1aLL, 0x2511275d3802a118LL }  /* t */
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -312,7 +389,12 @@
   },
   0x58a1f7e6ce0f4c09LL, /* n */
   0x0ed9d8e0b6624e1bLL, /* nq */
-  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffdc7"
+  "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffdc7",
+  ak_mpzn_mul_pseudo_mersenne_512,
+  ak_mpzn_sqr_pseudo_mersenne_512,
+  ak_false,
+  &id_tc26_gost_3410_2012_512_paramSetC_ecurve,
+  ak_mpzn_mul_montgomery_512
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -16,6 +16,9 @@
 #ifdef AK_HAVE_FCNTL_H
  #include <fcntl.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Инициализация генератора псевдо-случайных чисел.
@@ -160,6 +163,9 @@
 
 /* ----------------------------------------------------------------------------------------------- */
   static ak_uint64 shift_value = 0; // Внутренняя статическая переменная (счетчик вызовов)
+#ifdef AK_HAVE_PTHREAD_H
+  static pthread_mutex_t shift_value_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция использует для генерации случайного значения текущее время, номер процесса и
@@ -190,7 +196,14 @@
   clk = ( ak_uint64 ) clock();
 #endif
 
-  value = ( shift_value += 11 )*125643267795740073ULL + pval;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &shift_value_mutex );
+#endif
+  value = ( shift_value += 11 );
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &shift_value_mutex );
+#endif
+  value = value*125643267795740073ULL + pval;
   value = ( value * 506098983240188723ULL ) + 71331*uval + vtme;
  return value ^ clk;
 }
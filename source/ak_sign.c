@@ -9,6 +9,47 @@
 #ifdef AK_HAVE_TIME_H
  #include <time.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет обратный элемент \f$ z \equiv x^{-1} \pmod{q} \f$ для секретного
+    значения \f$ x \f$ с помощью ослепления.
+
+    Для случайного \f$ b \f$ обращается произведение \f$ xb \f$, после чего результат
+    домножается на \f$ b \f$. Значение \f$ xb \f$ не зависит от \f$ x \f$, поэтому для
+    обращения можно использовать функцию ak_mpzn_modinv_vartime(), которая работает примерно
+    втрое быстрее функции ak_mpzn_modinv(). Результат совпадает с результатом функции
+    ak_mpzn_modinv().
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет, \f$ 0 \leq x < q \f$.
+    @param skey Контекст секретного ключа, генератор которого используется для выработки \f$ b \f$.
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_modinv_blinded( ak_uint64 *z, ak_uint64 *x, ak_skey skey )
+{
+  ak_mpzn512 b, u;
+  int error = ak_error_ok;
+  ak_wcurve wc = ( ak_wcurve ) skey->data;
+
+  do{
+     if(( error = ak_random_ptr( &skey->generator, b,
+                                     (ssize_t)( wc->size*sizeof( ak_uint64 )))) != ak_error_ok )
+       return ak_error_message( error, __func__ , "wrong generation of blinding value" );
+     ak_wcurve_rem_q_montgomery( b, b, wc );
+  } while( ak_mpzn_cmp_ui( b, wc->size, 0 ));
+
+  wc->mulq( u, x, b, wc->q, wc->nq, wc->size );  /* u <- xbr^{-1} */
+  ak_mpzn_modinv_vartime( u, u, wc->q, wc->size ); /* u <- x^{-1}b^{-1}r */
+  wc->mulq( z, u, b, wc->q, wc->nq, wc->size );  /* z <- x^{-1} */
+
+  memset( b, 0, sizeof( ak_mpzn512 ));
+  memset( u, 0, sizeof( ak_mpzn512 ));
+ return ak_error_ok;
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Установление или изменение маски секретного ключа ассиметричного криптографического
@@ -37,7 +78,7 @@
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpznmax u, zeta;
+  ak_mpznmax zeta;
   ak_wcurve wc = NULL;
   int error = ak_error_ok;
   ak_uint64 *key = NULL, *mask = NULL;
@@ -71,19 +112,19 @@
 #endif
 
     /* приводим случайное число по модулю q и сразу считаем, что это число в представлении Монтгомери */
-     ak_mpzn_rem( mask, mask, wc->q, wc->size );
+     ak_wcurve_rem_q_montgomery( mask, mask, wc );
 
-    /* приводим значение ключа по модулю q, а потом переводим в представление Монтгомери
+    /* приводим значение ключа по модулю q и переводим в представление Монтгомери
        при этом мы предполагаем, что значение ключа установлено в естественном представлении */
-     ak_mpzn_rem( key, key, wc->q, wc->size );
-     ak_mpzn_mul_montgomery( key, key, wc->r2q, wc->q, wc->nq, wc->size);
-     ak_mpzn_mul_montgomery( key, key, mask, wc->q, wc->nq, wc->size);
-
-    /* вычисляем обратное значение для маски */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( mask, // m <- m^{q-2} (mod q)
-                                    mask, u, wc->q, wc->nq, wc->size );
+     ak_wcurve_rem_q_montgomery( key, key, wc );
+     wc->mulq( key, key, mask, wc->q, wc->nq, wc->size );
+
+    /* вычисляем обратное значение для маски (в представлении Монтгомери),
+       m <- m^{-1}r^{-1} (mod q) */
+     if(( error = ak_signkey_modinv_blinded( mask, mask, skey )) != ak_error_ok )
+       return ak_error_message( error, __func__ , "wrong inversion of mask value" );
+     wc->mulq( mask, mask, wc->r2q, wc->q, wc->nq, wc->size );
+     wc->mulq( mask, mask, wc->r2q, wc->q, wc->nq, wc->size );
     /* меняем значение флага */
      skey->flags |= ak_key_flag_set_mask;
 
@@ -95,17 +136,18 @@
        return ak_error_message( error, __func__ , "wrong mask generation for key buffer" );
 
     /* приводим случайное число по модулю q и сразу считаем, что это число в представлении Монтгомери */
-     ak_mpzn_rem( zeta, zeta, wc->q, wc->size );
+     ak_wcurve_rem_q_montgomery( zeta, zeta, wc );
 
     /* домножаем ключ на случайное число */
-     ak_mpzn_mul_montgomery( key, key, zeta, wc->q, wc->nq, wc->size );
-    /* вычисляем обратное значение zeta */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( zeta, zeta, u, wc->q, wc->nq, wc->size ); // z <- z^{q-2} (mod q)
+     wc->mulq( key, key, zeta, wc->q, wc->nq, wc->size );
+    /* вычисляем обратное значение zeta (в представлении Монтгомери), z <- z^{-1}r^{-1} (mod q) */
+     if(( error = ak_signkey_modinv_blinded( zeta, zeta, skey )) != ak_error_ok )
+       return ak_error_message( error, __func__ , "wrong inversion of mask value" );
+     wc->mulq( zeta, zeta, wc->r2q, wc->q, wc->nq, wc->size );
+     wc->mulq( zeta, zeta, wc->r2q, wc->q, wc->nq, wc->size );
 
     /* домножаем маску на обратное значение zeta */
-     ak_mpzn_mul_montgomery( mask, mask, zeta, wc->q, wc->nq, wc->size );
+     wc->mulq( mask, mask, zeta, wc->q, wc->nq, wc->size );
     }
 
  return ak_error_ok;
@@ -146,9 +188,9 @@
   mask = ( ak_uint64 *)( skey->key + skey->key_size );
 
  /* снимаем маску с ключа */
-  ak_mpzn_mul_montgomery( key, key, mask, wc->q, wc->nq, wc->size );
+  wc->mulq( key, key, mask, wc->q, wc->nq, wc->size );
  /* приводим ключ из представления Монтгомери в естественное состояние */
-  ak_mpzn_mul_montgomery( key, key, u, wc->q, wc->nq, wc->size );
+  wc->mulq( key, key, u, wc->q, wc->nq, wc->size );
 #ifndef AK_LITTLE_ENDIAN
   for( i = 0; i < wc->size; i++ ) key[i] = bswap_64( key[i] );
 #endif
@@ -343,7 +385,9 @@
     return ak_error_message_fmt( ak_error_curve_not_supported, __func__ ,
                               "%u bits elliptic curve is not applicable for algorithm %s",
                                                            wc->size << 6, sctx->key.oid->name[0] );
-    else sctx->key.data = wc;
+   if( sctx->pool != NULL ) return ak_error_message( ak_error_key_usage, __func__ ,
+                                "changing elliptic curve of secret key with presignature pool" );
+   sctx->key.data = wc;
  return ak_error_ok;
 }
 
@@ -407,10 +451,13 @@
   int error = ak_error_ok;
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                            "destroying a null pointer to digital signature secret key context" );
+  if(( error = ak_signkey_pool_destroy( sctx )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect destroying of presignature pool" );
   if(( error = ak_skey_destroy( &sctx->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "incorrect destroying of digital signature secret key" );
   if(( error = ak_hash_destroy( &sctx->ctx )) != ak_error_ok )
     ak_error_message( error, __func__ , "incorrect destroying hash function context" );
+  memset( sctx->nonce_entropy, 0, sizeof( sctx->nonce_entropy ));
 
  return error;
 }
@@ -552,6 +599,52 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет вторую половинку подписи \f$ s \equiv rd + ke \pmod{q}\f$ для
+    заданных значений \f$ r \f$ и \f$ k \f$ и экспортирует подпись в заданный буффер.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param r значение \f$ r \f$ в обычной форме.
+    @param rm значение \f$ r \f$ в форме Монтгомери по модулю \f$ q \f$.
+    @param km значение \f$ k \f$ в форме Монтгомери по модулю \f$ q \f$.
+    @param e целое число, соотвествующее хеш-коду подписываемого сообщения.
+    @param out массив, куда помещается результат.                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_sign_values( ak_signkey sctx, ak_uint64 *r, ak_uint64 *rm,
+                                                   ak_uint64 *km, ak_uint64 *e, ak_pointer out )
+{
+  ak_mpzn512 s, t;
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+
+ /* вычисляем значение s <- r*d (mod q) (сначала домножаем на ключ, потом на его маску) */
+  wc->mulq( s, rm, (ak_uint64 *)sctx->key.key, wc->q, wc->nq, wc->size );
+  wc->mulq( s, s,
+              (ak_uint64 *)(sctx->key.key+sctx->key.key_size), wc->q, wc->nq, wc->size );
+
+ /* приводим e к виду Монтгомери и помещаем во временную переменную t <- e */
+  ak_wcurve_rem_q_montgomery( t, e, wc );
+  if( ak_mpzn_cmp_ui( t, wc->size, 0 )) {
+    ak_mpzn_set_ui( t, wc->size, 1 );
+    wc->mulq( t, t, wc->r2q, wc->q, wc->nq, wc->size );
+  }
+
+ /* вычисляем k*e (mod q) и вычисляем s = r*d + k*e (mod q) (в форме Монтгомери) */
+  wc->mulq( t, km, t, wc->q, wc->nq, wc->size ); /* t <- k*e */
+  ak_mpzn_add_montgomery( s, s, t, wc->q, wc->size );
+
+ /* приводим s к обычной форме */
+  wc->mulq( s, s,  wc->point.z, /* для экономии памяти пользуемся равенством z = 1 */
+                                 wc->q, wc->nq, wc->size );
+ /* экспортируем результат */
+  ak_mpzn_to_little_endian( s, wc->size, out, sizeof(ak_uint64)*wc->size, ak_true );
+  ak_mpzn_to_little_endian( r, wc->size, (ak_uint64 *)out + wc->size,
+                                                             sizeof(ak_uint64)*wc->size, ak_true );
+ /* завершаемся */
+  sctx->key.set_mask( &sctx->key );
+  memset( s, 0, sizeof( ak_mpzn512 ));
+  memset( t, 0, sizeof( ak_mpzn512 ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вырабатывает электронную подпись для \f$ e \f$ - вычисленного хеш-кода подписываемого
     сообщения и заданного случайного числа \f$ k \f$. Для этого
@@ -588,54 +681,514 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_signkey_sign_const_values( ak_signkey sctx, ak_uint64 *k, ak_uint64 *e, ak_pointer out )
 {
-  ak_mpzn512 r, s;
+  ak_mpzn512 r;
   struct wpoint wr;
   ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
 
  /* поскольку функция не экспортируется, мы оставляем все проверки функциям верхнего уровня */
  /* вычисляем r */
-  ak_wpoint_pow( &wr, &wc->point, k, wc->size, wc );
+  ak_wpoint_pow_base( &wr, k, wc->size, wc );
   ak_wpoint_reduce( &wr, wc );
-  ak_mpzn_rem( r, wr.x, wc->q, wc->size );
-
- /* приводим r к виду Монтгомери и помещаем во временную переменную wr.x <- r */
-  ak_mpzn_mul_montgomery( wr.x, r, wc->r2q, wc->q, wc->nq, wc->size );
 
- /* вычисляем значение s <- r*d (mod q) (сначала домножаем на ключ, потом на его маску) */
-  ak_mpzn_mul_montgomery( s, wr.x, (ak_uint64 *)sctx->key.key, wc->q, wc->nq, wc->size );
-  ak_mpzn_mul_montgomery( s, s,
-              (ak_uint64 *)(sctx->key.key+sctx->key.key_size), wc->q, wc->nq, wc->size );
+ /* приводим r и k к виду Монтгомери и помещаем во временные переменные wr.z <- r, wr.y <- k,
+    после чего возвращаем r к обычной форме (для экономии памяти пользуемся равенством z = 1) */
+  ak_wcurve_rem_q_montgomery( wr.z, wr.x, wc );
+  wc->mulq( r, wr.z, wc->point.z, wc->q, wc->nq, wc->size );
+  wc->mulq( wr.y, k, wc->r2q, wc->q, wc->nq, wc->size );
 
- /* приводим k к виду Монтгомери и помещаем во временную переменную wr.y <- k */
-  ak_mpzn_mul_montgomery( wr.y, k, wc->r2q, wc->q, wc->nq, wc->size );
+ /* вычисляем s и экспортируем результат */
+  ak_signkey_sign_values( sctx, r, wr.z, wr.y, e, out );
+  memset( &wr, 0, sizeof( struct wpoint ));
+  memset( r, 0, sizeof( ak_mpzn512 ));
+}
 
- /* приводим e к виду Монтгомери и помещаем во временную переменную wr.z <- e */
-  ak_mpzn_rem( wr.z, e, wc->q, wc->size );
-  if( ak_mpzn_cmp_ui( wr.z, wc->size, 0 )) ak_mpzn_set_ui( wr.z, wc->size, 1 );
-  ak_mpzn_mul_montgomery( wr.z, wr.z, wc->r2q, wc->q, wc->nq, wc->size );
+/* ----------------------------------------------------------------------------------------------- */
+/*                          пул заранее вычисленных значений (k, r)                                */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пара значений \f$ (k, r) \f$, вычисленная заранее для выработки электронной подписи,
+    где \f$ r \equiv x_C \pmod{q} \f$, \f$ C = [k]P \f$. */
+ typedef struct presignature {
+  /*! \brief Случайное число \f$ k \f$ в форме Монтгомери по модулю \f$ q \f$. */
+   ak_mpzn512 km;
+  /*! \brief Значение \f$ r \f$ в форме Монтгомери по модулю \f$ q \f$. */
+   ak_mpzn512 rm;
+  /*! \brief Значение \f$ r \f$ в обычной форме. */
+   ak_mpzn512 r;
+ } *ak_presignature;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул заранее вычисленных значений \f$ (k, r) \f$ секретного ключа электронной подписи. */
+ struct signkey_pool {
+  /*! \brief Секретный ключ, которому принадлежит пул. */
+   ak_signkey sctx;
+  /*! \brief Генератор, используемый только для выработки значений пула. */
+   ak_random generator;
+  /*! \brief Массив пар значений. */
+   ak_presignature pairs;
+  /*! \brief Максимальное количество пар в пуле. */
+   size_t size;
+  /*! \brief Текущее количество пар в пуле. */
+   size_t count;
+  /*! \brief Флаг завершения работы пула. */
+   bool_t stop;
+ #ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Мьютекс, защищающий пул и ресурс ключа. */
+   pthread_mutex_t mutex;
+  /*! \brief Условная переменная, по которой пробуждается поток заполнения пула. */
+   pthread_cond_t cond;
+  /*! \brief Поток, заполняющий пул. */
+   pthread_t thread;
+  /*! \brief Флаг того, что поток заполнения пула создан. */
+   bool_t created;
+ #endif
+ };
+
+#ifdef AK_HAVE_PTHREAD_H
+ #define ak_signkey_pool_lock( pool ) pthread_mutex_lock( &( pool )->mutex )
+ #define ak_signkey_pool_unlock( pool ) pthread_mutex_unlock( &( pool )->mutex )
+#else
+ #define ak_signkey_pool_lock( pool ) do { } while( 0 )
+ #define ak_signkey_pool_unlock( pool ) do { } while( 0 )
+#endif
 
- /* вычисляем k*e (mod q) и вычисляем s = r*d + k*e (mod q) (в форме Монтгомери) */
-  ak_mpzn_mul_montgomery( wr.y, wr.y, wr.z, wc->q, wc->nq, wc->size ); /* wr.y <- k*e */
-  ak_mpzn_add_montgomery( s, s, wr.y, wc->q, wc->size );
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает случайное число \f$ k \f$ и вычисляет для него значение \f$ r \f$.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_pool_generate( ak_signkey_pool pool, ak_presignature ps )
+{
+  struct wpoint wr;
+  int error = ak_error_ok;
+  ak_wcurve wc = ( ak_wcurve ) pool->sctx->key.data;
 
- /* приводим s к обычной форме */
-  ak_mpzn_mul_montgomery( s, s,  wc->point.z, /* для экономии памяти пользуемся равенством z = 1 */
-                                 wc->q, wc->nq, wc->size );
- /* экспортируем результат */
-  ak_mpzn_to_little_endian( s, wc->size, out, sizeof(ak_uint64)*wc->size, ak_true );
-  ak_mpzn_to_little_endian( r, wc->size, (ak_uint64 *)out + wc->size,
-                                                             sizeof(ak_uint64)*wc->size, ak_true );
- /* завершаемся */
+  memset( ps, 0, sizeof( struct presignature ));
+  if(( error = ak_mpzn_set_random_modulo( ps->km, wc->q, wc->size,
+                                                         pool->generator )) != ak_error_ok ) return error;
+  ak_wpoint_pow_base( &wr, ps->km, wc->size, wc );
+  ak_wpoint_reduce( &wr, wc );
+  ak_wcurve_rem_q_montgomery( ps->rm, wr.x, wc );
+  wc->mulq( ps->r, ps->rm, wc->point.z, wc->q, wc->nq, wc->size );
+  wc->mulq( ps->km, ps->km, wc->r2q, wc->q, wc->nq, wc->size );
   memset( &wr, 0, sizeof( struct wpoint ));
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция помещает в пул выработанную пару значений; каждая пара уменьшает ресурс ключа
+    на единицу. Функция должна вызываться при захваченном мьютексе пула.
+    @return Функция возвращает \ref ak_true, если пара помещена в пул.                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_pool_put( ak_signkey_pool pool, ak_presignature ps )
+{
+  if( pool->stop || ( pool->count >= pool->size ) ||
+                              ( pool->sctx->key.resource.value.counter <= 0 )) return ak_false;
+  pool->sctx->key.resource.value.counter--;
+  memcpy( pool->pairs + pool->count, ps, sizeof( struct presignature ));
+  pool->count++;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заполняет пул в вызывающем потоке.                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_pool_fill( ak_signkey_pool pool )
+{
+  struct presignature ps;
+  int error = ak_error_ok;
+
+  while(( pool->count < pool->size ) && ( pool->sctx->key.resource.value.counter > 0 )) {
+    if(( error = ak_signkey_pool_generate( pool, &ps )) != ak_error_ok ) break;
+    ak_signkey_pool_put( pool, &ps );
+  }
+  ak_ptr_wipe( &ps, sizeof( struct presignature ), pool->generator );
+ return error;
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, заполняющего пул; поток пробуждается после каждого использования
+    пары значений и завершается при уничтожении пула.                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_signkey_pool_thread( void *ptr )
+{
+  struct presignature ps;
+  ak_signkey_pool pool = ( ak_signkey_pool ) ptr;
+
+  pthread_mutex_lock( &pool->mutex );
+  while( !pool->stop ) {
+    if(( pool->count >= pool->size ) || ( pool->sctx->key.resource.value.counter <= 0 )) {
+      pthread_cond_wait( &pool->cond, &pool->mutex );
+      continue;
+    }
+   /* точка вычисляется вне мьютекса, так что выработка подписей не блокируется */
+    pthread_mutex_unlock( &pool->mutex );
+    if( ak_signkey_pool_generate( pool, &ps ) != ak_error_ok ) {
+      ak_error_message( ak_error_get_value(), __func__ ,
+                                                 "incorrect generation of presignature values" );
+      pthread_mutex_lock( &pool->mutex );
+      break;
+    }
+    pthread_mutex_lock( &pool->mutex );
+    ak_signkey_pool_put( pool, &ps );
+    ak_ptr_wipe( &ps, sizeof( struct presignature ), pool->generator );
+  }
+  pthread_mutex_unlock( &pool->mutex );
+
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция извлекает из пула пару значений; извлеченная пара удаляется из пула.
+    @return Функция возвращает \ref ak_true, если пул содержал хотя бы одну пару.                */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_pool_take( ak_signkey sctx, ak_presignature ps )
+{
+  bool_t result = ak_false;
+  ak_signkey_pool pool = sctx->pool;
+
+  ak_signkey_pool_lock( pool );
+  if( pool->count > 0 ) {
+    pool->count--;
+    memcpy( ps, pool->pairs + pool->count, sizeof( struct presignature ));
+    ak_ptr_wipe( pool->pairs + pool->count, sizeof( struct presignature ), &sctx->key.generator );
+    result = ak_true;
+  }
+ #ifdef AK_HAVE_PTHREAD_H
+  if( pool->created ) pthread_cond_signal( &pool->cond );
+ #endif
+  ak_signkey_pool_unlock( pool );
+
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает пул заранее вычисленных пар \f$ (k, r) \f$, где \f$ k \f$ - случайное
+    число, а \f$ r \equiv x_C \pmod{q} \f$ для точки \f$ C = [k]P \f$. Вычисление кратной точки
+    не зависит от подписываемого сообщения, поэтому при наличии в пуле хотя бы одной пары
+    функция ak_signkey_sign_hash() выполняет лишь несколько умножений по модулю \f$ q \f$.
+
+    Если библиотека собрана с поддержкой pthreads, то пул заполняется отдельным потоком,
+    который пополняет пул после каждого использования пары. В противном случае пул заполняется
+    при создании и при вызове функции ak_signkey_pool_refill().
+
+    Каждая пара используется ровно один раз и после использования уничтожается. Выработка
+    каждой пары уменьшает ресурс ключа на единицу, поэтому количество подписей, выработанных
+    с использованием пула, не превосходит ресурса `digital_signature_count_resource`.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param generator генератор случайных чисел, используемый для выработки значений \f$ k \f$;
+    генератор не должен использоваться вне пула до уничтожения пула.
+    @param size максимальное количество пар в пуле.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_pool_create( ak_signkey sctx, ak_random generator, const size_t size )
+{
+  ak_signkey_pool pool = NULL;
+  int error = ak_error_ok;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to secret key context" );
+  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                 "using null pointer to random number generator" );
+  if( !size ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                         "using presignature pool of zero size" );
+  if( sctx->pool != NULL ) return ak_error_message( ak_error_key_usage, __func__ ,
+                                             "secret key already has a presignature pool" );
+  if( sctx->nonce != signkey_nonce_random ) return ak_error_message( ak_error_key_usage,
+                       __func__ , "using presignature pool for secret key with deterministic nonce" );
+
+  if(( pool = calloc( 1, sizeof( struct signkey_pool ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                 "incorrect memory allocation for presignature pool" );
+  if(( pool->pairs = calloc( size, sizeof( struct presignature ))) == NULL ) {
+    free( pool );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                "incorrect memory allocation for presignature values" );
+  }
+  pool->sctx = sctx;
+  pool->generator = generator;
+  pool->size = size;
+  pool->count = 0;
+  pool->stop = ak_false;
+  sctx->pool = pool;
+
+ #ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_init( &pool->mutex, NULL );
+  pthread_cond_init( &pool->cond, NULL );
+  if(( pool->created =
+             ( pthread_create( &pool->thread, NULL, ak_signkey_pool_thread, pool ) == 0 )) == ak_true )
+    return ak_error_ok;
+ #endif
+
+ /* поток не создан: заполняем пул в вызывающем потоке */
+  if(( error = ak_signkey_pool_fill( pool )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect generation of presignature values" );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Если пул заполняется отдельным потоком, функция лишь пробуждает этот поток; в противном
+    случае пул пополняется в вызывающем потоке.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_pool_refill( ak_signkey sctx )
+{
+  int error = ak_error_ok;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to secret key context" );
+  if( sctx->pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                "secret key does not have a presignature pool" );
+ #ifdef AK_HAVE_PTHREAD_H
+  if( sctx->pool->created ) {
+    pthread_mutex_lock( &sctx->pool->mutex );
+    pthread_cond_signal( &sctx->pool->cond );
+    pthread_mutex_unlock( &sctx->pool->mutex );
+    return ak_error_ok;
+  }
+ #endif
+  if(( error = ak_signkey_pool_fill( sctx->pool )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect generation of presignature values" );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @return Функция возвращает количество пар, доступных для выработки подписей. Если пул
+    не создан, возвращается ноль.                                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_signkey_pool_get_count( ak_signkey sctx )
+{
+  size_t count = 0;
+
+  if(( sctx == NULL ) || ( sctx->pool == NULL )) return 0;
+  ak_signkey_pool_lock( sctx->pool );
+  count = sctx->pool->count;
+  ak_signkey_pool_unlock( sctx->pool );
+ return count;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция останавливает поток заполнения пула, уничтожает все неиспользованные пары
+    и освобождает память. Ресурс ключа, израсходованный на неиспользованные пары,
+    не восстанавливается.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_pool_destroy( ak_signkey sctx )
+{
+  ak_signkey_pool pool = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to secret key context" );
+  if(( pool = sctx->pool ) == NULL ) return ak_error_ok;
+
+  ak_signkey_pool_lock( pool );
+  pool->stop = ak_true;
+ #ifdef AK_HAVE_PTHREAD_H
+  pthread_cond_signal( &pool->cond );
+ #endif
+  ak_signkey_pool_unlock( pool );
+ #ifdef AK_HAVE_PTHREAD_H
+  if( pool->created ) pthread_join( pool->thread, NULL );
+  pthread_cond_destroy( &pool->cond );
+  pthread_mutex_destroy( &pool->mutex );
+ #endif
+
+  ak_ptr_wipe( pool->pairs, pool->size*sizeof( struct presignature ), &sctx->key.generator );
+  free( pool->pairs );
+  free( pool );
+  sctx->pool = NULL;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                      детерминированная выработка значений k (RFC 6979)                          */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение HMAC-Стрибог (RFC 2104) от конкатенации `V || sep || data`
+    на ключе `K`; при `sep < 0` разделитель не используется.
+
+    Поскольку ключ `K` меняется при каждом вызове, вместо контекста \ref hmac используется
+    контекст функции хеширования секретного ключа электронной подписи, что позволяет избежать
+    создания и маскирования ключа на каждом шаге.                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_nonce_hmac( ak_signkey sctx, ak_uint8 *kv, ak_uint8 *vv, const size_t lb,
+                     const int sep, const ak_uint8 *data, const size_t dsize, ak_uint8 *out )
+{
+  size_t idx = 0, len = 64 + lb;
+  int error = ak_error_ok;
+  ak_uint8 buffer[64 + 64 + 1 + 3*64];
+
+ /* внутренний хеш H( (K xor ipad) || V || sep || data ) */
+  for( idx = 0; idx < lb; idx++ ) buffer[idx] = kv[idx] ^ 0x36;
+  for( ; idx < 64; idx++ ) buffer[idx] = 0x36;
+  memcpy( buffer+64, vv, lb );
+  if( sep >= 0 ) buffer[len++] = ( ak_uint8 )sep;
+  if( dsize > 0 ) { memcpy( buffer+len, data, dsize ); len += dsize; }
+  if(( error = ak_hash_ptr( &sctx->ctx, buffer, len, buffer+64, lb )) != ak_error_ok ) goto labexit;
+
+ /* внешний хеш H( (K xor opad) || inner ) */
+  for( idx = 0; idx < lb; idx++ ) buffer[idx] = kv[idx] ^ 0x5C;
+  for( ; idx < 64; idx++ ) buffer[idx] = 0x5C;
+  error = ak_hash_ptr( &sctx->ctx, buffer, 64 + lb, out, lb );
+
+ labexit:
+  ak_ptr_wipe( buffer, sizeof( buffer ), &sctx->key.generator );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает значение \f$ k \f$ детерминированным образом по схеме HMAC_DRBG,
+    описанной в RFC 6979 (раздел 3.2), в которой функция HMAC-SHA заменена на HMAC-Стрибог
+    с длиной имитовставки, совпадающей с размером секретного ключа.
+
+    В качестве \f$ x \f$ используется секретный ключ в обычной (немаскированной) форме,
+    в качестве \f$ h_1 \f$ - вычет \f$ e \pmod{q} \f$, вычисляемый из хеш-кода
+    так же, как и при выработке подписи. В режиме \ref signkey_nonce_hedged к ним дописывается
+    случайная последовательность, выработанная при вызове функции ak_signkey_set_nonce().
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param e целое число, соответствующее хеш-коду подписываемого сообщения.
+    @param k вычет, в который помещается результат.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_nonce_generate( ak_signkey sctx, ak_uint64 *e, ak_uint64 *k )
+{
+  int error = ak_error_ok;
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+  size_t i = 0, lb = sizeof( ak_uint64 )*wc->size, dsize = 0, shift = 0;
+  ak_mpzn512 x, one = ak_mpzn512_one;
+  ak_uint8 kv[64], vv[64], data[3*64];
+
+ /* data <- int2octets(x) || bits2octets(h1) [ || k' ] */
+  wc->mulq( x, (ak_uint64 *)sctx->key.key,
+              (ak_uint64 *)( sctx->key.key+sctx->key.key_size ), wc->q, wc->nq, wc->size );
+  wc->mulq( x, x, one, wc->q, wc->nq, wc->size );
   sctx->key.set_mask( &sctx->key );
-  memset( r, 0, sizeof( ak_mpzn512 ));
-  memset( s, 0, sizeof( ak_mpzn512 ));
+  ak_mpzn_to_little_endian( x, wc->size, data, lb, ak_true );
+  ak_wcurve_rem_q( x, e, wc );
+  ak_mpzn_to_little_endian( x, wc->size, data+lb, lb, ak_true );
+  dsize = 2*lb;
+  if( sctx->nonce == signkey_nonce_hedged ) {
+    memcpy( data+dsize, sctx->nonce_entropy, lb );
+    dsize += lb;
+  }
+
+ /* длина порядка q в битах определяет величину сдвига в bits2int() */
+  for( i = wc->size; i > 0; i-- ) if( wc->q[i-1] ) break;
+  shift = 64*( wc->size - i );
+  if( i > 0 ) { ak_uint64 w = wc->q[i-1]; while( !( w&0x8000000000000000LL )) { w <<= 1; shift++; }}
+
+ /* V <- 0x01 ... 0x01, K <- 0x00 ... 0x00 */
+  memset( vv, 0x01, lb );
+  memset( kv, 0x00, lb );
+  if(( error = ak_signkey_nonce_hmac( sctx, kv, vv, lb, 0x00, data, dsize, kv )) != ak_error_ok )
+    goto labexit;
+  if(( error = ak_signkey_nonce_hmac( sctx, kv, vv, lb, -1, NULL, 0, vv )) != ak_error_ok )
+    goto labexit;
+  if(( error = ak_signkey_nonce_hmac( sctx, kv, vv, lb, 0x01, data, dsize, kv )) != ak_error_ok )
+    goto labexit;
+  if(( error = ak_signkey_nonce_hmac( sctx, kv, vv, lb, -1, NULL, 0, vv )) != ak_error_ok )
+    goto labexit;
+
+ /* вырабатываем кандидатов до тех пор, пока не получим 0 < k < q */
+  while( ak_true ) {
+    if(( error = ak_signkey_nonce_hmac( sctx, kv, vv, lb, -1, NULL, 0, vv )) != ak_error_ok )
+      goto labexit;
+    ak_mpzn_set_little_endian( k, wc->size, vv, lb, ak_true );
+    for( i = 0; i < wc->size; i++ ) { /* k <- bits2int(V) = V >> shift */
+       size_t j = i + shift/64;
+       ak_uint64 lo = ( j < wc->size ) ? k[j] : 0, hi = ( j+1 < wc->size ) ? k[j+1] : 0;
+       k[i] = ( shift%64 ) ? ( lo >> ( shift%64 )) | ( hi << ( 64 - shift%64 )) : lo;
+    }
+    if( !ak_mpzn_cmp_ui( k, wc->size, 0 ) && ( ak_mpzn_cmp( k, wc->q, wc->size ) < 0 )) break;
+
+    if(( error = ak_signkey_nonce_hmac( sctx, kv, vv, lb, 0x00, NULL, 0, kv )) != ak_error_ok )
+      goto labexit;
+    if(( error = ak_signkey_nonce_hmac( sctx, kv, vv, lb, -1, NULL, 0, vv )) != ak_error_ok )
+      goto labexit;
+  }
+
+ labexit:
+  if( error != ak_error_ok ) ak_error_message( error, __func__ ,
+                                                    "incorrect calculation of hmac_drbg value" );
+  ak_ptr_wipe( x, sizeof( ak_mpzn512 ), &sctx->key.generator );
+  ak_ptr_wipe( kv, sizeof( kv ), &sctx->key.generator );
+  ak_ptr_wipe( vv, sizeof( vv ), &sctx->key.generator );
+  ak_ptr_wipe( data, sizeof( data ), &sctx->key.generator );
+
+ return error;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! @param sctx Контекст секретного ключа алгоритма электронной подписи.
+/*! Детерминированная выработка значения \f$ k \f$ позволяет не обращаться к генератору
+    случайных чисел при выработке каждой подписи, а также делает подпись воспроизводимой:
+    для одного и того же ключа и хеш-кода всегда вырабатывается одна и та же подпись.
+    В режиме \ref signkey_nonce_hedged из генератора однократно считывается случайная
+    последовательность, которая далее подмешивается к ключу и хеш-коду при выработке каждого
+    значения \f$ k \f$.
+
+    Детерминированные режимы не могут использоваться совместно с пулом заранее вычисленных
+    значений, поскольку значения из пула не зависят от подписываемого сообщения.
+
+    @param sctx контекст секретного ключа алгоритма электронной подписи.
+    @param nonce способ выработки значения \f$ k \f$.
+    @param generator генератор случайных чисел; используется только в режиме
+    \ref signkey_nonce_hedged, в остальных случаях может принимать значение NULL.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_set_nonce( ak_signkey sctx, signkey_nonce_t nonce, ak_random generator )
+{
+  int error = ak_error_ok;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to secret key context" );
+  if(( nonce != signkey_nonce_random ) && ( sctx->pool != NULL ))
+    return ak_error_message( ak_error_key_usage, __func__ ,
+                          "using deterministic nonce for secret key with presignature pool" );
+  switch( nonce ) {
+    case signkey_nonce_random:
+    case signkey_nonce_deterministic:
+      memset( sctx->nonce_entropy, 0, sizeof( sctx->nonce_entropy ));
+      break;
+
+    case signkey_nonce_hedged:
+      if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                 "using null pointer to random number generator" );
+      if(( error = ak_random_ptr( generator,
+                   sctx->nonce_entropy, sizeof( sctx->nonce_entropy ))) != ak_error_ok )
+        return ak_error_message( error, __func__ , "incorrect generation of random value" );
+      break;
+
+    default: return ak_error_message( ak_error_undefined_value, __func__ ,
+                                                             "using unexpected nonce mode" );
+  }
+  sctx->nonce = nonce;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Ресурс ключа `digital_signature_count_resource` уменьшается только при выработке пар
+    значений для пула (см. ak_signkey_pool_create()); подписи, вырабатываемые без использования
+    пула, ресурс ключа не расходуют.
+
+    @param sctx Контекст секретного ключа алгоритма электронной подписи.
     @param generator Генератор случайной последовательности,
-    используемой в алгоритме подписи
+    используемой в алгоритме подписи; если для ключа выбран детерминированный способ выработки
+    значения k (см. ak_signkey_set_nonce()), может принимать значение NULL.
     @param hash Последовательность байт, содержащая в себе хеш-код
     подписываемого сообщения.
     @param size Размер хеш-кода, в байтах.
@@ -655,11 +1208,14 @@
 #endif
   size_t lb = 0;
   ak_mpzn512 k, h;
+  bool_t pooled = ak_false;
+  struct presignature ps;
   int error = ak_error_ok;
 
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                       "using null pointer to secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+  if(( generator == NULL ) && ( sctx->nonce == signkey_nonce_random ))
+    return ak_error_message( ak_error_null_pointer, __func__,
                                                  "using null pointer to random number generator" );
   if( hash == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                               "using null pointer to hash value" );
@@ -669,28 +1225,43 @@
   if( out_size < 2*lb ) return ak_error_message( ak_error_wrong_length, __func__,
                                                        "using small buffer for digital sigature" );
 
- /* вырабатываем случайное число */
-  memset( k, 0, sizeof( ak_uint64 )*ak_mpzn512_size );
-  if(( error = ak_mpzn_set_random_modulo( k, (( ak_wcurve )sctx->key.data)->q,
-                                (( ak_wcurve )sctx->key.data)->size, generator )) != ak_error_ok )
-    return ak_error_message( error, __func__ , "invalid generation of random value");
-
  /* превращаем хеш от сообщения в последовательность 64х битных слов  */
   memcpy( h, hash, sctx->ctx.data.sctx.hsize );
 #ifndef AK_LITTLE_ENDIAN
   for( i = 0; i < (( ak_wcurve )sctx->key.data)->size; i++ ) h[i] = bswap_64( h[i] );
 #endif
 
+ /* используем заранее вычисленную пару значений (ресурс ключа уменьшен при ее выработке),
+    либо вырабатываем значение k */
+  if( sctx->pool != NULL ) pooled = ak_signkey_pool_take( sctx, &ps );
+  if( !pooled ) {
+    memset( k, 0, sizeof( ak_uint64 )*ak_mpzn512_size );
+    if( sctx->nonce == signkey_nonce_random ) {
+      if(( error = ak_mpzn_set_random_modulo( k, (( ak_wcurve )sctx->key.data)->q,
+                                (( ak_wcurve )sctx->key.data)->size, generator )) != ak_error_ok )
+        return ak_error_message( error, __func__ , "invalid generation of random value");
+    } else {
+        if(( error = ak_signkey_nonce_generate( sctx, h, k )) != ak_error_ok )
+          return ak_error_message( error, __func__ , "invalid generation of deterministic value");
+      }
+  }
+
  /* и только теперь вычисляем электронную подпись */
-  ak_signkey_sign_const_values( sctx, k, h, out );
-  ak_ptr_wipe( k, sizeof( ak_uint64 )*ak_mpzn512_size, &sctx->key.generator );
+  if( pooled ) {
+    ak_signkey_sign_values( sctx, ps.r, ps.rm, ps.km, h, out );
+    ak_ptr_wipe( &ps, sizeof( struct presignature ), &sctx->key.generator );
+  } else {
+      ak_signkey_sign_const_values( sctx, k, h, out );
+      ak_ptr_wipe( k, sizeof( ak_uint64 )*ak_mpzn512_size, &sctx->key.generator );
+    }
  return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx Контекст секретного ключа алгоритма электронной подписи.
     @param generator Генератор случайной последовательности,
-    используемой в алгоритме подписи
+    используемой в алгоритме подписи; если для ключа выбран детерминированный способ выработки
+    значения k (см. ak_signkey_set_nonce()), может принимать значение NULL.
     @param in Указатель на входные данные которые подписываются.
     @param size Размер входных данных в байтах.
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
@@ -710,8 +1281,6 @@
  /* необходимые проверки */
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                  "using null pointer to secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
-                                                 "using null pointer to random number generator" );
   if( in == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                    "using null pointer to signifying value" );
   if( sctx->ctx.data.sctx.hsize > sizeof( hash )) return ak_error_message( ak_error_wrong_length,
@@ -730,7 +1299,8 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx Kонтекст секретного ключа алгоритма электронной подписи.
     @param generator Генератор случайной последовательности,
-    используемой в алгоритме подписи
+    используемой в алгоритме подписи; если для ключа выбран детерминированный способ выработки
+    значения k (см. ak_signkey_set_nonce()), может принимать значение NULL.
     @param filename Строка с именем файла для которого вычисляется электронная подпись.
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
     @param out_size Размер выделенной под выработанную ЭП памяти.
@@ -749,8 +1319,6 @@
  /* необходимые проверки */
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                  "using null pointer to secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
-                                                 "using null pointer to random number generator" );
   if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                           "using null pointer to file name" );
   if( sctx->ctx.data.sctx.hsize > 64 ) return ak_error_message( ak_error_wrong_length,
@@ -849,6 +1417,13 @@
 /*! Функция инициализирует контекст открытого ключа и вычисляет его значение
     (точку эллиптической кривой), соответствующее заданному значению секретного ключа.
 
+    Значение секретного ключа \f$ d \f$ в памяти не формируется. Маска \f$ m \f$ секретного
+    ключа \f$ k \f$ представляется в виде суммы \f$ m \equiv t + s \pmod{q} \f$ со случайным
+    вычетом \f$ s \f$, после чего открытый ключ вычисляется как сумма кратных точек
+    \f$ [d-r]P + [r]P \f$, где \f$ d - r \equiv ktR^{-2} \f$ и \f$ r \equiv ksR^{-2} \pmod{q} \f$.
+    Обе кратные точки вычисляются с помощью таблицы кратных базовой точки
+    (функция ak_wpoint_pow_base()), время работы которой не зависит от значения множителя.
+
     @param pctx Контекст открытого ключа электронной подписи
     @param sctx Контекст секретного ключа электронной подписи. Контекст должен быть предварительно
     инициализирован и содержать в себе ключевое значение.
@@ -858,8 +1433,9 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_verifykey_create_from_signkey( ak_verifykey pctx, ak_signkey sctx )
 {
+  struct wpoint wr;
   int error = ak_error_ok;
-  ak_mpzn512 k, one = ak_mpzn512_one;
+  ak_mpzn512 k, s, one = ak_mpzn512_one;
 
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                   "using a null pointer to digital signature secret key context" );
@@ -873,13 +1449,28 @@
    else return ak_error_message( error, __func__, "using incorrect oid for secret key" );
 
  /* теперь определяем открытый ключ */
-  ak_mpzn_mul_montgomery( k, ( ak_uint64 *)sctx->key.key, one,
+  /* произведение ключа и маски равно dR^2 (mod q); значение d в памяти не формируется,
+     вместо этого маска разбивается на два случайных слагаемых s и t = m - s,
+     и открытый ключ вычисляется как сумма [ktR^{-2}]P + [ksR^{-2}]P */
+  memset( s, 0, sizeof( s ));
+  if(( error = ak_mpzn_set_random_modulo( s, pctx->wc->q, pctx->wc->size,
+                                                         &sctx->key.generator )) != ak_error_ok ) {
+    ak_verifykey_destroy( pctx );
+    return ak_error_message( error, __func__, "invalid generation of random value" );
+  }
+  pctx->wc->mulq( k, ( ak_uint64 *)sctx->key.key, s,
+                                                      pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( k, k, one, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  ak_wpoint_pow_base( &pctx->qpoint, k, pctx->wc->size, pctx->wc );
+
+  ak_mpzn_sub_montgomery( s, ( ak_uint64 *)( sctx->key.key + sctx->key.key_size ), s,
+                                                                 pctx->wc->q, pctx->wc->size );
+  pctx->wc->mulq( k, ( ak_uint64 *)sctx->key.key, s,
                                                       pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_wpoint_pow( &pctx->qpoint, &pctx->wc->point, k, pctx->wc->size, pctx->wc );
+  pctx->wc->mulq( k, k, one, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  ak_wpoint_pow_base( &wr, k, pctx->wc->size, pctx->wc );
 
-  ak_mpzn_mul_montgomery( k, ( ak_uint64 *)( sctx->key.key + sctx->key.key_size ),
-                                                  one, pctx->wc->q, pctx->wc->nq, pctx->wc->size);
-  ak_wpoint_pow( &pctx->qpoint, &pctx->qpoint, k, pctx->wc->size, pctx->wc );
+  ak_wpoint_add( &pctx->qpoint, &wr, pctx->wc );
   ak_wpoint_reduce( &pctx->qpoint, pctx->wc );
 
  /* разбираемся с ресурсом */
@@ -897,6 +1488,8 @@
 
  /* перемаскируем секретный ключ */
   ak_ptr_wipe( k, sizeof( ak_uint64 )*ak_mpzn512_size, &sctx->key.generator );
+  ak_ptr_wipe( s, sizeof( ak_uint64 )*ak_mpzn512_size, &sctx->key.generator );
+  ak_ptr_wipe( &wr, sizeof( struct wpoint ), &sctx->key.generator );
   sctx->key.set_mask( &sctx->key );
 
  return ak_error_ok;
@@ -935,98 +1528,577 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! @param pctx контекст открытого ключа алгоритма электронной подписи.
-    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
-    код ошибки.                                                                                    */
+/*                              пакетная выработка ключевых пар                                    */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_verifykey_destroy( ak_verifykey pctx )
+/*! \brief Порция работы, выполняемая одним потоком при пакетной выработке ключевых пар. */
+ typedef struct signkey_keygen_thread {
+  /*! \brief Эллиптическая кривая, на которой вырабатываются ключи. */
+   ak_wcurve wc;
+  /*! \brief Генератор, используемый потоком для выработки секретных ключей. */
+   ak_random generator;
+  /*! \brief Собственный генератор потока. */
+   struct random local;
+  /*! \brief Массив заданий. */
+   ak_signkey_keygen_task tasks;
+  /*! \brief Количество заданий в порции. */
+   size_t count;
+  /*! \brief Пароль для экспорта секретных ключей (или NULL). */
+   const char *password;
+  /*! \brief Длина пароля (в октетах). */
+   size_t pass_size;
+ } *ak_signkey_keygen_thread;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция последовательно вырабатывает ключевые пары для порции заданий.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_signkey_generate_thread( void *ptr )
 {
-  int error = ak_error_ok;
-  if( pctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                      "using null pointer to public key context" );
-  if(( error = ak_hash_destroy( &pctx->ctx )) != ak_error_ok )
-    ak_error_message( error, __func__ , "incorrect destroying hash function context" );
+  size_t idx = 0;
+  ak_signkey_keygen_thread th = ( ak_signkey_keygen_thread ) ptr;
 
- /* если обобщенное имя владельца было определено, то удаляем его */
-  if( pctx->name != NULL ) pctx->name = ak_tlv_delete( pctx->name );
+  for( idx = 0; idx < th->count; idx++ ) {
+     ak_signkey_keygen_task task = th->tasks + idx;
 
-  memset( pctx, 0, sizeof( struct verifykey ));
- return error;
+     task->asn = NULL;
+     if(( task->error = ak_signkey_create( &task->sk, th->wc )) != ak_error_ok ) {
+       ak_error_message( task->error, __func__, "incorrect creation of secret key context" );
+       continue;
+     }
+     if(( task->error = ak_signkey_set_key_random( &task->sk, th->generator )) != ak_error_ok ) {
+       ak_error_message( task->error, __func__, "incorrect assigning a secret key value" );
+       ak_signkey_destroy( &task->sk );
+       continue;
+     }
+     if(( task->error = ak_verifykey_create_from_signkey( &task->vk, &task->sk )) != ak_error_ok ) {
+       ak_error_message( task->error, __func__, "incorrect creation of public key context" );
+       ak_signkey_destroy( &task->sk );
+       continue;
+     }
+     if( th->password == NULL ) continue;
+
+    /* формируем контейнер с зашифрованным секретным ключом */
+     if(( task->error = ak_skey_export_to_asn1_with_password( &task->sk,
+                          task->asn = ak_asn1_new(), th->password, th->pass_size )) != ak_error_ok ) {
+       ak_error_message( task->error, __func__, "incorrect export of secret key to asn1 context" );
+       if( task->asn != NULL ) task->asn = ak_asn1_delete( task->asn );
+       ak_verifykey_destroy( &task->vk );
+       ak_signkey_destroy( &task->sk );
+     }
+  }
+
+ return NULL;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! @param pctx контекст открытого ключа.
-    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
-    @param hsize размер хеш-кода, в байтах.
-    @param sign электронная подпись, для которой выполняется проверка.
-    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
-    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
-    вызова функции ak_error_get_value().                                                           */
+/*! Функция вырабатывает `count` ключевых пар для заданной эллиптической кривой. Для каждого
+    задания функция инициализирует контексты секретного и открытого ключей, вырабатывает
+    случайный секретный ключ и вычисляет соответствующий ему открытый ключ. Открытый ключ
+    вычисляется как сумма двух кратных базовой точки, множители которых являются случайными
+    слагаемыми секретного ключа (см. ak_verifykey_create_from_signkey()). Обе кратные точки
+    вычисляются с помощью таблицы кратных базовой точки, общей для всех ключей кривой;
+    умножение произвольной точки кривой на скаляр не используется.
+
+    Если задан пароль, то секретный ключ дополнительно экспортируется в ASN.1 дерево,
+    указатель на которое помещается в поле `asn` задания (см. ak_skey_export_to_asn1_with_password()).
+    Полученное дерево может быть сохранено в файл с помощью функции ak_asn1_export_to_file().
+
+    Если библиотека собрана с поддержкой pthreads, то массив заданий разбивается на части,
+    количество которых определяется опцией `threads_count`, и части обрабатываются параллельно.
+    Первый поток использует генератор `generator`, каждый из остальных потоков использует
+    собственный генератор того же типа, начальное состояние которого вырабатывается
+    генератором `generator`. Если создать генератор того же типа невозможно,
+    то ключевые пары вырабатываются в одном потоке.
+
+    После использования контексты должны быть уничтожены с помощью функции
+    ak_signkey_generate_batch_destroy().
+
+    @param wc Эллиптическая кривая, на которой вырабатываются ключи.
+    @param generator Генератор случайных последовательностей.
+    @param tasks Массив заданий; содержимое заданий перед вызовом функции не определено.
+    @param count Количество заданий.
+    @param password Пароль, используемый для экспорта секретных ключей, или NULL.
+    @param pass_size Длина пароля (в октетах).
+    @return Функция возвращает \ref ak_error_ok, если все ключевые пары выработаны. В противном
+    случае возвращается код ошибки первого невыполненного задания.                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_generate_batch( const ak_wcurve wc, ak_random generator,
+                                ak_signkey_keygen_task tasks, const size_t count,
+                                                     const char *password, const size_t pass_size )
+{
+  ak_uint8 seed[64];
+  size_t idx = 0, threads = 1;
+  struct signkey_keygen_thread th[ak_libakrypt_threads_max];
+
+  if( wc == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to elliptic curve" );
+  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                "using null pointer to random number generator" );
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                              "using null pointer to tasks array" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "using empty array of tasks" );
+  if(( password != NULL ) && ( !pass_size ))
+    return ak_error_message( ak_error_invalid_value, __func__, "using incorrect password value" );
+
+  threads = ak_libakrypt_get_threads_count( count );
+
+ /* вырабатываем собственные генераторы потоков */
+  for( idx = 1; idx < threads; idx++ ) {
+     if(( generator->oid == NULL ) ||
+        ( ak_random_create_oid( &th[idx].local, generator->oid ) != ak_error_ok )) break;
+     if( th[idx].local.randomize_ptr != NULL ) {
+       if(( ak_random_ptr( generator, seed, sizeof( seed )) != ak_error_ok ) ||
+          ( ak_random_randomize( &th[idx].local, seed, sizeof( seed )) != ak_error_ok )) {
+         ak_random_destroy( &th[idx].local );
+         break;
+       }
+     }
+     th[idx].generator = &th[idx].local;
+  }
+  ak_ptr_wipe( seed, sizeof( seed ), generator );
+  if( idx < threads ) {
+    while( idx > 1 ) ak_random_destroy( &th[--idx].local );
+    threads = 1;
+  }
+  th[0].generator = generator;
+
+ /* каждый поток получает непрерывную часть массива заданий */
+  for( idx = 0; idx < threads; idx++ ) {
+     size_t first = idx*count/threads;
+     th[idx].wc = wc;
+     th[idx].tasks = tasks + first;
+     th[idx].count = ( idx+1 )*count/threads - first;
+     th[idx].password = password;
+     th[idx].pass_size = pass_size;
+  }
+
+  ak_libakrypt_run_threads( ak_signkey_generate_thread, th,
+                                                 sizeof( struct signkey_keygen_thread ), threads );
+  for( idx = 1; idx < threads; idx++ ) ak_random_destroy( &th[idx].local );
+
+  for( idx = 0; idx < count; idx++ )
+     if( tasks[idx].error != ak_error_ok ) return tasks[idx].error;
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
- bool_t ak_verifykey_verify_hash( ak_verifykey pctx,
-                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+/*! Функция уничтожает контексты ключей и ASN.1 деревья, созданные при успешном выполнении
+    заданий функцией ak_signkey_generate_batch(); задания, завершившиеся с ошибкой, пропускаются.
+
+    @param tasks Массив заданий.
+    @param count Количество заданий.
+    @return В случае успеха возвращается \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_generate_batch_destroy( ak_signkey_keygen_task tasks, const size_t count )
 {
-#ifndef AK_LITTLE_ENDIAN
-  int i = 0;
+  size_t idx = 0;
+
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                              "using null pointer to tasks array" );
+  for( idx = 0; idx < count; idx++ ) {
+     if( tasks[idx].error != ak_error_ok ) continue;
+     if( tasks[idx].asn != NULL ) tasks[idx].asn = ak_asn1_delete( tasks[idx].asn );
+     ak_verifykey_destroy( &tasks[idx].vk );
+     ak_signkey_destroy( &tasks[idx].sk );
+     tasks[idx].error = ak_error_undefined_value;
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                         кеш таблиц кратных точек открытых ключей                                */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Элемент кеша таблиц кратных точек открытых ключей. */
+ struct verifykey_table {
+  /*! \brief Следующий элемент списка (список упорядочен по времени последнего использования). */
+   struct verifykey_table *next;
+  /*! \brief Эллиптическая кривая, которой принадлежит открытый ключ. */
+   ak_wcurve wc;
+  /*! \brief Таблица кратных точек открытого ключа. */
+   struct wpoint_table table;
+  /*! \brief Количество контекстов открытых ключей, использующих таблицу. */
+   size_t refs;
+ };
+
+/*! \brief Начало списка таблиц; первой в списке находится последняя использованная таблица. */
+ static struct verifykey_table *verifykey_tables = NULL;
+#ifdef AK_HAVE_PTHREAD_H
+/*! \brief Мьютекс, защищающий список таблиц. */
+ static pthread_mutex_t verifykey_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
-  ak_mpzn512 v, z1, z2, u, r, s, h;
-  struct wpoint cpoint, tpoint;
+/*! \brief Признак того, что работа с кешем таблиц завершена функцией
+    ak_verifykey_destroy_tables(); в этом случае таблица удаляется сразу после того,
+    как перестает использоваться. */
+ static bool_t verifykey_tables_closed = ak_false;
 
-  if( pctx == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__,
-                                               "using a null pointer to secret key context" );
-    return ak_false;
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция удаляет из кеша неиспользуемые таблицы, начиная с наиболее давно
+    использованных, так чтобы количество неиспользуемых таблиц не превышало значения опции
+    `verifykey_tables_count` (после завершения работы с кешем - нуля).
+    Функция вызывается при захваченном мьютексе.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_trim_tables( void )
+{
+  size_t unused = 0, limit = verifykey_tables_closed ? 0 :
+                           ( size_t )ak_libakrypt_get_option_by_name( "verifykey_tables_count" );
+  struct verifykey_table **ptr = &verifykey_tables;
+
+  while( *ptr != NULL ) {
+    struct verifykey_table *entry = *ptr;
+    if(( entry->refs == 0 ) && ( ++unused > limit )) {
+      *ptr = entry->next;
+      ak_wpoint_table_destroy( &entry->table );
+      free( entry );
+    } else ptr = &entry->next;
   }
-  if( hash == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to hash value" );
-    return ak_false;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция уменьшает количество ссылок на таблицу кратных точек. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_release_table( ak_wpoint_table wt )
+{
+  struct verifykey_table *entry = NULL;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &verifykey_tables_mutex );
+#endif
+  for( entry = verifykey_tables; entry != NULL; entry = entry->next )
+     if( &entry->table == wt ) {
+       if( entry->refs ) entry->refs--;
+       break;
+     }
+  ak_verifykey_trim_tables();
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &verifykey_tables_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет таблицу кратных точек открытого ключа (см. ak_wpoint_table_create())
+    и связывает ее с контекстом. После этого функция ak_verifykey_verify_hash() вычисляет
+    обе кратные точки только с помощью сложений, что ускоряет проверку подписи примерно
+    в два раза. Вычисление таблицы занимает время, сравнимое с 10-15 проверками подписи,
+    поэтому функцию имеет смысл вызывать для ключей, которые проверяют много подписей.
+
+    Таблицы хранятся в общем для всех контекстов кеше, ключом которого является
+    сам открытый ключ (точка кривой). Поэтому повторно импортированный ключ (например,
+    из того же сертификата) получает уже вычисленную таблицу. Таблица удаляется из кеша
+    только тогда, когда она не используется ни одним контекстом, а количество
+    неиспользуемых таблиц превышает значение опции `verifykey_tables_count`; из кеша
+    удаляются наиболее давно использованные таблицы.
+
+    @param pctx Контекст открытого ключа; значение ключа должно быть определено.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_precompute( ak_verifykey pctx )
+{
+  int error = ak_error_ok;
+  struct verifykey_table *entry = NULL, **ptr = NULL;
+
+  if( pctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to public key context" );
+  if( pctx->qtable != NULL ) return ak_error_ok;
+  if( !( pctx->flags&ak_key_flag_set_key )) return ak_error_message( ak_error_key_value, __func__ ,
+                                                            "using undefined public key value" );
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &verifykey_tables_mutex );
+#endif
+  verifykey_tables_closed = ak_false;
+  for( ptr = &verifykey_tables; *ptr != NULL; ptr = &(*ptr)->next ) {
+     entry = *ptr;
+     if(( entry->wc == pctx->wc ) &&
+        ( ak_mpzn_cmp( entry->table.point.x, pctx->qpoint.x, pctx->wc->size ) == 0 ) &&
+        ( ak_mpzn_cmp( entry->table.point.y, pctx->qpoint.y, pctx->wc->size ) == 0 )) {
+      /* перемещаем найденную таблицу в начало списка */
+       *ptr = entry->next;
+       break;
+     }
+     entry = NULL;
   }
-  if( hsize != sizeof( ak_uint64 )*(pctx->wc->size )) {
-    ak_error_message( ak_error_wrong_length, __func__, "using hash value with wrong length" );
-    return ak_false;
+  if( entry == NULL ) {
+    if(( entry = calloc( 1, sizeof( struct verifykey_table ))) == NULL )
+      error = ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                   "incorrect memory allocation for table entry" );
+     else {
+       if(( error = ak_wpoint_table_create( &entry->table,
+                                                   &pctx->qpoint, pctx->wc )) != ak_error_ok ) {
+         ak_error_message( error, __func__ , "incorrect creation of public key table" );
+         free( entry );
+         entry = NULL;
+       } else entry->wc = pctx->wc;
+     }
   }
-  if( sign == NULL ) {
-    ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to sign value" );
-    return ak_false;
+  if( entry != NULL ) {
+    entry->next = verifykey_tables;
+    verifykey_tables = entry;
+    entry->refs++;
+    pctx->qtable = &entry->table;
+  }
+  ak_verifykey_trim_tables();
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &verifykey_tables_mutex );
+#endif
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удаляет все неиспользуемые таблицы кратных точек открытых ключей и вызывается
+    при завершении работы с библиотекой. Таблицы, на которые еще ссылаются контексты открытых
+    ключей, остаются в кеше и удаляются функцией ak_verifykey_destroy() при уничтожении
+    последнего ссылающегося на них контекста.                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_verifykey_destroy_tables( void )
+{
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &verifykey_tables_mutex );
+#endif
+  verifykey_tables_closed = ak_true;
+  ak_verifykey_trim_tables();
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &verifykey_tables_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                        кеш открытых ключей, прошедших проверку                                  */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество элементов кеша проверенных открытых ключей (степень двойки). */
+ #define ak_verifykey_checked_count  ( 64 )
+
+/*! \brief Элемент кеша открытых ключей, прошедших проверку. */
+ struct verifykey_checked {
+  /*! \brief Эллиптическая кривая, которой принадлежит открытый ключ (NULL для пустого элемента). */
+   ak_wcurve wc;
+  /*! \brief Значение хеш-функции от открытого ключа. */
+   ak_uint64 hash;
+  /*! \brief x-координата открытого ключа. */
+   ak_uint64 x[ak_mpzn512_size];
+  /*! \brief y-координата открытого ключа. */
+   ak_uint64 y[ak_mpzn512_size];
+ };
+
+/*! \brief Кеш открытых ключей; элемент кеша определяется младшими битами значения хеш-функции. */
+ static struct verifykey_checked verifykey_checked[ak_verifykey_checked_count];
+#ifdef AK_HAVE_PTHREAD_H
+/*! \brief Мьютекс, защищающий кеш проверенных открытых ключей. */
+ static pthread_mutex_t verifykey_checked_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет некриптографическое значение хеш-функции от точки кривой,
+    используемое для поиска точки в кеше; совпадение точек проверяется сравнением координат.      */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_verifykey_checked_hash( ak_wpoint wp, ak_wcurve wc )
+{
+  size_t i = 0;
+  ak_uint64 hash = ( ak_uint64 )( size_t ) wc;
+
+  for( i = 0; i < wc->size; i++ ) {
+     hash = ( hash ^ wp->x[i] )*0x9E3779B97F4A7C15LL;
+     hash = ( hash ^ wp->y[i] )*0x9E3779B97F4A7C15LL;
+     hash ^= hash >> 29;
   }
+ return hash;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что открытый ключ является точкой подгруппы порядка \f$ q \f$
+    эллиптической кривой (см. ak_wpoint_check_subgroup()). Для кривых с кофактором, равным
+    единице, достаточно проверки принадлежности точки кривой; для остальных кривых
+    дополнительно вычисляется кратная точка \f$ [q]Q \f$.
+
+    Ключи, успешно прошедшие проверку, помещаются в кеш, поиск в котором выполняется
+    по значению хеш-функции от точки. Поэтому повторная проверка того же ключа, например,
+    при повторном импорте сертификата или запроса на сертификат, сводится
+    к сравнению координат. Функция может вызываться одновременно из нескольких потоков.
+
+    @param pctx Контекст открытого ключа; точка должна быть приведена к аффинному виду.
+    @return Функция возвращает \ref ak_error_ok, если ключ прошел проверку,
+    \ref ak_error_curve_point, если точка не принадлежит кривой, и
+    \ref ak_error_curve_point_order, если точка не принадлежит подгруппе порядка \f$ q \f$.     */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_check_point( ak_verifykey pctx )
+{
+  ak_uint64 hash = 0;
+  bool_t found = ak_false;
+  struct verifykey_checked *entry = NULL;
+
+  if( pctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to public key context" );
+  if( pctx->wc == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                         "using null pointer to elliptic curve" );
+  if( ak_mpzn_cmp_ui( pctx->qpoint.z, pctx->wc->size, 1 ) != ak_true )
+    return ak_error_message( ak_error_curve_point, __func__ ,
+                                                "using public key with non affine coordinates" );
+
+  hash = ak_verifykey_checked_hash( &pctx->qpoint, pctx->wc );
+  entry = verifykey_checked + ( hash&( ak_verifykey_checked_count - 1 ));
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &verifykey_checked_mutex );
+#endif
+  found = ( entry->wc == pctx->wc ) && ( entry->hash == hash ) &&
+          ( ak_mpzn_cmp( entry->x, pctx->qpoint.x, pctx->wc->size ) == 0 ) &&
+          ( ak_mpzn_cmp( entry->y, pctx->qpoint.y, pctx->wc->size ) == 0 );
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &verifykey_checked_mutex );
+#endif
+  if( found ) return ak_error_ok;
+
+ /* проверка выполняется без захвата мьютекса */
+  if( ak_wpoint_is_ok( &pctx->qpoint, pctx->wc ) != ak_true )
+    return ak_error_message( ak_error_curve_point, __func__ ,
+                                                  "the public key isn't on given elliptic curve" );
+  if( ak_wpoint_check_subgroup( &pctx->qpoint, pctx->wc ) != ak_true )
+    return ak_error_message( ak_error_curve_point_order, __func__ ,
+                                                      "the public key has wrong order" );
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &verifykey_checked_mutex );
+#endif
+  entry->wc = pctx->wc;
+  entry->hash = hash;
+  memcpy( entry->x, pctx->qpoint.x, pctx->wc->size*sizeof( ak_uint64 ));
+  memcpy( entry->y, pctx->qpoint.y, pctx->wc->size*sizeof( ak_uint64 ));
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &verifykey_checked_mutex );
+#endif
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param pctx контекст открытого ключа алгоритма электронной подписи.
+    @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
+    код ошибки.                                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_destroy( ak_verifykey pctx )
+{
+  int error = ak_error_ok;
+  if( pctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to public key context" );
+  if(( error = ak_hash_destroy( &pctx->ctx )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect destroying hash function context" );
+  if( pctx->qtable != NULL ) ak_verifykey_release_table( pctx->qtable );
+
+ /* если обобщенное имя владельца было определено, то удаляем его */
+  if( pctx->name != NULL ) pctx->name = ak_tlv_delete( pctx->name );
+
+  memset( pctx, 0, sizeof( struct verifykey ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет параметры и импортирует значения, необходимые для проверки подписи.
+
+    \param pctx контекст открытого ключа.
+    \param hash хеш-код сообщения.
+    \param hsize размер хеш-кода, в байтах.
+    \param sign электронная подпись.
+    \param r вычет, куда помещается значение r.
+    \param s вычет, куда помещается значение s.
+    \param v вычет, куда помещается значение e (mod q) в представлении Монтгомери.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_verifykey_verify_import( ak_verifykey pctx, const ak_pointer hash,
+                 const size_t hsize, ak_pointer sign, ak_uint64 *r, ak_uint64 *s, ak_uint64 *v )
+{
+#ifndef AK_LITTLE_ENDIAN
+  int i = 0;
+#endif
+
+  if( pctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                     "using a null pointer to secret key context" );
+  if( hash == NULL )
+    return ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to hash value" );
+  if( hsize != sizeof( ak_uint64 )*(pctx->wc->size ))
+    return ak_error_message( ak_error_wrong_length, __func__, "using hash value with wrong length" );
+  if( sign == NULL )
+    return ak_error_message( ak_error_null_pointer, __func__, "using a null pointer to sign value" );
 
  /* импортируем подпись */
   ak_mpzn_set_little_endian( s, pctx->wc->size, sign, sizeof(ak_uint64)*pctx->wc->size, ak_true );
   ak_mpzn_set_little_endian( r, pctx->wc->size, ( ak_uint64* )sign + pctx->wc->size,
                                                       sizeof(ak_uint64)*pctx->wc->size, ak_true );
 
-  memcpy( h, hash, sizeof( ak_uint64 )*pctx->wc->size );
+  memcpy( v, hash, sizeof( ak_uint64 )*pctx->wc->size );
 #ifndef AK_LITTLE_ENDIAN
-  for( i = 0; i < pctx->wc->size; i++ ) h[i] = bswap_64( h[i] );
+  for( i = 0; i < pctx->wc->size; i++ ) v[i] = bswap_64( v[i] );
 #endif
 
-  ak_mpzn_set( v, h, pctx->wc->size );
-  ak_mpzn_rem( v, v, pctx->wc->q, pctx->wc->size );
-  if( ak_mpzn_cmp_ui( v, pctx->wc->size, 0 )) ak_mpzn_set_ui( v, pctx->wc->size, 1 );
-  ak_mpzn_mul_montgomery( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  ak_wcurve_rem_q_montgomery( v, v, pctx->wc );
+  if( ak_mpzn_cmp_ui( v, pctx->wc->size, 0 )) {
+    ak_mpzn_set_ui( v, pctx->wc->size, 1 );
+    pctx->wc->mulq( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет (в проективной форме) точку \f$ C = [z_1]P + [z_2]Q \f$,
+    абсцисса которой сравнивается со значением r.
 
-  /* вычисляем v (в представлении Монтгомери) */
-  ak_mpzn_set_ui( u, pctx->wc->size, 2 );
-  ak_mpzn_sub( u, pctx->wc->q, u, pctx->wc->size );
-  ak_mpzn_modpow_montgomery( v, v, u, pctx->wc->q, pctx->wc->nq, pctx->wc->size ); // v <- v^{q-2} (mod q)
+    \param pctx контекст открытого ключа.
+    \param r значение r.
+    \param s значение s.
+    \param v обратный к хеш-коду элемент \f$ e^{-1} \pmod{q}\f$ в представлении Монтгомери.
+    \param cpoint точка, в которую помещается результат.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_verify_point( ak_verifykey pctx, ak_uint64 *r, ak_uint64 *s,
+                                                                 ak_uint64 *v, ak_wpoint cpoint )
+{
+  ak_mpzn512 z1, z2;
 
   /* вычисляем z1 */
-  ak_mpzn_mul_montgomery( z1, s, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z1, z1, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z1, z1, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( z1, s, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( z1, z1, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( z1, z1, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
   /* вычисляем z2 */
-  ak_mpzn_mul_montgomery( z2, r, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( z2, r, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
   ak_mpzn_sub( z2, pctx->wc->q, z2, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z2, z2, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_mpzn_mul_montgomery( z2, z2, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( z2, z2, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( z2, z2, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+
+ /* данные открыты, поэтому используем вычисление, время которого зависит от z1 и z2 */
+  if( pctx->qtable != NULL )
+    ak_wpoint_double_pow_table( cpoint, z1, pctx->qtable, z2, pctx->wc->size, pctx->wc );
+   else ak_wpoint_double_pow( cpoint, z1, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param pctx контекст открытого ключа.
+    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
+    @param hsize размер хеш-кода, в байтах.
+    @param sign электронная подпись, для которой выполняется проверка.
+    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
+    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
+    вызова функции ak_error_get_value().                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_verifykey_verify_hash( ak_verifykey pctx,
+                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+{
+  ak_mpzn512 v, r, s;
+  struct wpoint cpoint;
+
+  if( ak_verifykey_verify_import( pctx, hash, hsize, sign, r, s, v ) != ak_error_ok )
+    return ak_false;
+
+  /* вычисляем v (в представлении Монтгомери), данные открыты, поэтому время обращения
+     может зависеть от значения v */
+  ak_mpzn_modinv_vartime( v, v, pctx->wc->q, pctx->wc->size ); // v <- v^{-1}r^{-1} (mod q)
+  pctx->wc->mulq( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
+  pctx->wc->mulq( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
  /* сложение точек и проверка */
-  ak_wpoint_pow( &cpoint, &pctx->wc->point, z1, pctx->wc->size, pctx->wc );
-  ak_wpoint_pow( &tpoint, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
-  ak_wpoint_add( &cpoint, &tpoint, pctx->wc );
-  ak_wpoint_reduce( &cpoint, pctx->wc );
-  ak_mpzn_rem( cpoint.x, cpoint.x, pctx->wc->q, pctx->wc->size );
+  ak_verifykey_verify_point( pctx, r, s, v, &cpoint );
+  ak_wpoint_reduce_vartime( &cpoint, pctx->wc );
+  ak_wcurve_rem_q( cpoint.x, cpoint.x, pctx->wc );
 
   if( ak_mpzn_cmp( cpoint.x, r, pctx->wc->size )) {
     ak_ptr_is_equal_with_log( cpoint.x, r, pctx->wc->size*sizeof( ak_uint64 ));
@@ -1035,6 +2107,146 @@
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                                пакетная проверка подписей                                       */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество подписей, для которых обращения выполняются одновременно. */
+ #define ak_verifykey_batch_block  ( 32 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет блок подписей, открытые ключи которых принадлежат одной кривой.
+
+    Обращение хеш-кодов по модулю \f$ q \f$ и приведение точек к аффинной форме выполняются
+    для всего блока одновременно с помощью приема Монтгомери, поэтому на блок приходится
+    по одному возведению в степень по модулю \f$ q \f$ и по модулю \f$ p \f$.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_verify_block( ak_verifykey_task tasks, const size_t count )
+{
+  size_t idx = 0, n = 0, map[ak_verifykey_batch_block];
+  ak_mpzn512 r[ak_verifykey_batch_block], s[ak_verifykey_batch_block],
+             v[ak_verifykey_batch_block], prod[ak_verifykey_batch_block], u, w;
+  struct wpoint cpoints[ak_verifykey_batch_block];
+  ak_wcurve wc = tasks[0].key->wc;
+
+  for( idx = 0; idx < count; idx++ ) {
+     tasks[idx].result = ak_false;
+     if(( tasks[idx].error = ak_verifykey_verify_import( tasks[idx].key, tasks[idx].hash,
+                                 tasks[idx].hash_size, tasks[idx].sign, r[n], s[n], v[n] )) == ak_error_ok )
+       map[n++] = idx;
+  }
+  if( !n ) return;
+
+ /* одновременное обращение всех v[i] по модулю q */
+  ak_mpzn_set( prod[0], v[0], wc->size );
+  for( idx = 1; idx < n; idx++ )
+     wc->mulq( prod[idx], prod[idx-1], v[idx], wc->q, wc->nq, wc->size );
+  ak_mpzn_modinv_vartime( u, prod[n-1], wc->q, wc->size );
+  wc->mulq( u, u, wc->r2q, wc->q, wc->nq, wc->size );
+  wc->mulq( u, u, wc->r2q, wc->q, wc->nq, wc->size );
+  for( idx = n-1; idx > 0; idx-- ) {
+     wc->mulq( w, u, prod[idx-1], wc->q, wc->nq, wc->size );
+     wc->mulq( u, u, v[idx], wc->q, wc->nq, wc->size );
+     ak_mpzn_set( v[idx], w, wc->size );
+  }
+  ak_mpzn_set( v[0], u, wc->size );
+
+ /* вычисляем точки и одновременно приводим их к аффинной форме */
+  for( idx = 0; idx < n; idx++ )
+     ak_verifykey_verify_point( tasks[map[idx]].key, r[idx], s[idx], v[idx], cpoints+idx );
+  if(( tasks[map[0]].error = ak_wpoint_reduce_batch( cpoints, n, wc )) != ak_error_ok ) {
+    for( idx = 1; idx < n; idx++ ) tasks[map[idx]].error = tasks[map[0]].error;
+    return;
+  }
+
+  for( idx = 0; idx < n; idx++ ) {
+     ak_wcurve_rem_q( cpoints[idx].x, cpoints[idx].x, wc );
+     if( ak_mpzn_cmp( cpoints[idx].x, r[idx], wc->size ))
+       tasks[map[idx]].error = ak_error_not_equal_data;
+      else tasks[map[idx]].result = ak_true;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Порция работы, выполняемая одним потоком при пакетной проверке подписей. */
+ typedef struct verifykey_thread {
+  /*! \brief Массив заданий. */
+   ak_verifykey_task tasks;
+  /*! \brief Количество заданий в порции. */
+   size_t count;
+ } *ak_verifykey_thread;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция разбивает порцию заданий на блоки последовательно идущих заданий, открытые
+    ключи которых принадлежат одной кривой, и проверяет их.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_verifykey_verify_thread( void *ptr )
+{
+  size_t idx = 0, len = 0;
+  ak_verifykey_thread th = ( ak_verifykey_thread ) ptr;
+
+  while( idx < th->count ) {
+    ak_verifykey_task task = th->tasks + idx;
+    if( task->key == NULL ) {
+      task->result = ak_false;
+      task->error = ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to public key context" );
+      idx++;
+      continue;
+    }
+    for( len = 1; ( len < ak_verifykey_batch_block ) && ( idx + len < th->count ); len++ )
+       if(( task[len].key == NULL ) || ( task[len].key->wc != task->key->wc )) break;
+    ak_verifykey_verify_block( task, len );
+    idx += len;
+  }
+
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет массив электронных подписей. Для каждого задания должны быть определены
+    открытый ключ, хеш-код сообщения и электронная подпись; результат проверки помещается
+    в поля `result` и `error` задания.
+
+    Задания обрабатываются блоками; для последовательно идущих заданий, открытые ключи
+    которых принадлежат одной эллиптической кривой, вычисление обратных элементов
+    выполняется одновременно. Поэтому задания с ключами одной кривой выгодно располагать
+    в массиве подряд. Если библиотека собрана с поддержкой pthreads, то массив заданий
+    разбивается на части, количество которых определяется опцией `threads_count`,
+    и части обрабатываются параллельно.
+
+    @param tasks Массив заданий.
+    @param count Количество заданий.
+    @return Функция возвращает \ref ak_error_ok, если все подписи верны. В противном случае
+    возвращается код ошибки первого задания, подпись которого не прошла проверку
+    (\ref ak_error_not_equal_data для неверной подписи).                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_verify_batch( ak_verifykey_task tasks, const size_t count )
+{
+  size_t idx = 0, threads = 1;
+  struct verifykey_thread th[ak_libakrypt_threads_max];
+
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                              "using null pointer to tasks array" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "using empty array of tasks" );
+  threads = ak_libakrypt_get_threads_count(
+                               ( count + ak_verifykey_batch_block - 1 )/ak_verifykey_batch_block );
+
+ /* каждый поток получает непрерывную часть массива заданий */
+  for( idx = 0; idx < threads; idx++ ) {
+     size_t first = idx*count/threads;
+     th[idx].tasks = tasks + first;
+     th[idx].count = ( idx+1 )*count/threads - first;
+  }
+
+  ak_libakrypt_run_threads( ak_verifykey_verify_thread, th,
+                                                      sizeof( struct verifykey_thread ), threads );
+
+  for( idx = 0; idx < count; idx++ )
+     if( tasks[idx].error != ak_error_ok ) return tasks[idx].error;
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param pctx контекст открытого ключа.
     @param in область памяти для которой проверяется электронная подпись.
@@ -1287,6 +2499,326 @@
  return result;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция тестирует выработку электронной подписи с использованием пула заранее
+    вычисленных значений: подписи, выработанные как с использованием пула, так и после его
+    исчерпания, должны проверяться. Ресурс ключа должен уменьшаться только при выработке
+    пар значений для пула, а подписи без использования пула должны вырабатываться
+    и после исчерпания ресурса.
+
+    @return Функция возвращает истину только в том случае,
+    когда будут пройдены все тесты. В противном случае возвращается ложь.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_test_pool( void )
+{
+  size_t i = 0;
+  ssize_t counter = 0;
+  ak_uint8 message = 0, sign[64];
+  struct signkey skey;
+  struct verifykey vkey;
+  struct random generator, pgenerator;
+  int error = ak_error_ok;
+  bool_t result = ak_false;
+
+  if(( error = ak_random_create_lcg( &generator )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of random generator" );
+    return ak_false;
+  }
+  if(( error = ak_random_create_lcg( &pgenerator )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of random generator" );
+    ak_random_destroy( &generator );
+    return ak_false;
+  }
+  if(( error = ak_signkey_create_streebog256( &skey )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of secret key context" );
+    goto labexit;
+  }
+  if(( error = ak_signkey_set_key_random( &skey, &generator )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect assigning a secret key value" );
+    ak_signkey_destroy( &skey );
+    goto labexit;
+  }
+  if(( error = ak_verifykey_create_from_signkey( &vkey, &skey )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of public key value" );
+    ak_signkey_destroy( &skey );
+    goto labexit;
+  }
+
+  counter = skey.key.resource.value.counter;
+
+ /* ресурс ключа исчерпан, однако подписи без использования пула вырабатываются */
+  skey.key.resource.value.counter = 0;
+  for( i = 0; i < 3; i++ ) {
+     message = ( ak_uint8 )i;
+     if((( error = ak_signkey_sign_ptr( &skey, &generator,
+                                        &message, 1, sign, sizeof( sign ))) != ak_error_ok ) ||
+        !ak_verifykey_verify_ptr( &vkey, &message, 1, sign )) {
+       ak_error_message( ak_error_not_equal_data, __func__,
+                                     "wrong digital signature for key with exhausted resource" );
+       goto labexit1;
+     }
+  }
+  if( skey.key.resource.value.counter != 0 ) {
+    ak_error_message( ak_error_low_key_resource, __func__,
+                                  "resource of secret key was changed without presignature pool" );
+    goto labexit1;
+  }
+
+ /* ресурса ключа хватает только на две пары значений пула */
+  skey.key.resource.value.counter = 2;
+  if(( error = ak_signkey_pool_create( &skey, &pgenerator, 4 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of presignature pool" );
+    goto labexit1;
+  }
+
+ /* вырабатываем подписей больше, чем помещается в пул */
+  for( i = 0; i < 10; i++ ) {
+     message = ( ak_uint8 )i;
+     ak_signkey_sign_ptr( &skey, &generator, &message, 1, sign, sizeof( sign ));
+     if( !ak_verifykey_verify_ptr( &vkey, &message, 1, sign )) {
+       ak_error_message( ak_error_not_equal_data, __func__,
+                                 "wrong checking of digital signature with presignature pool" );
+       goto labexit1;
+     }
+  }
+  ak_signkey_pool_destroy( &skey );
+  if( skey.key.resource.value.counter < 0 ) {
+    ak_error_message( ak_error_low_key_resource, __func__,
+                                  "wrong resource accounting for presignature pool" );
+    goto labexit1;
+  }
+  skey.key.resource.value.counter = counter;
+  result = ak_true;
+
+ labexit1:
+  ak_verifykey_destroy( &vkey );
+  ak_signkey_destroy( &skey );
+ labexit:
+  ak_random_destroy( &pgenerator );
+  ak_random_destroy( &generator );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция тестирует детерминированную выработку значения \f$ k \f$: для одного и того же
+    сообщения должна вырабатываться одна и та же подпись, для различных сообщений, а также
+    при подмешивании случайной последовательности, подписи должны различаться.
+
+    @return Функция возвращает истину только в том случае,
+    когда будут пройдены все тесты. В противном случае возвращается ложь.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_test_deterministic_nonce( void )
+{
+  size_t i = 0;
+  struct signkey skey;
+  struct verifykey vkey;
+  struct random generator;
+  int error = ak_error_ok;
+  bool_t result = ak_false;
+  ak_uint8 message[2] = { 0x01, 0x02 }, sign[4][128];
+  const char *curves[2] = { "id-tc26-gost-3410-2012-256-paramSetA",
+                            "id-tc26-gost-3410-2012-512-paramSetC" };
+
+  if(( error = ak_random_create_lcg( &generator )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of random generator" );
+    return ak_false;
+  }
+
+  for( i = 0; i < 2; i++ ) {
+    if(( error = ak_signkey_create_str( &skey, curves[i] )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect creation of secret key context" );
+      goto labexit;
+    }
+    if(( error = ak_signkey_set_key_random( &skey, &generator )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect assigning a secret key value" );
+      ak_signkey_destroy( &skey );
+      goto labexit;
+    }
+    if(( error = ak_verifykey_create_from_signkey( &vkey, &skey )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect creation of public key value" );
+      ak_signkey_destroy( &skey );
+      goto labexit;
+    }
+
+   /* подписи без генератора: две для одного сообщения, одна для другого */
+    memset( sign, 0, sizeof( sign ));
+    ak_signkey_set_nonce( &skey, signkey_nonce_deterministic, NULL );
+    ak_signkey_sign_ptr( &skey, NULL, message, 1, sign[0], sizeof( sign[0] ));
+    ak_signkey_sign_ptr( &skey, NULL, message, 1, sign[1], sizeof( sign[1] ));
+    ak_signkey_sign_ptr( &skey, NULL, message+1, 1, sign[2], sizeof( sign[2] ));
+   /* подпись с подмешиванием случайной последовательности */
+    ak_signkey_set_nonce( &skey, signkey_nonce_hedged, &generator );
+    ak_signkey_sign_ptr( &skey, NULL, message, 1, sign[3], sizeof( sign[3] ));
+
+    if( !ak_verifykey_verify_ptr( &vkey, message, 1, sign[0] ) ||
+        !ak_verifykey_verify_ptr( &vkey, message+1, 1, sign[2] ) ||
+        !ak_verifykey_verify_ptr( &vkey, message, 1, sign[3] )) {
+      ak_error_message( ak_error_not_equal_data, __func__,
+                      "wrong checking of digital signature with deterministic nonce" );
+      goto labexit1;
+    }
+    if( !ak_ptr_is_equal( sign[0], sign[1], sizeof( sign[0] )) ||
+         ak_ptr_is_equal( sign[0], sign[2], sizeof( sign[0] )) ||
+         ak_ptr_is_equal( sign[0], sign[3], sizeof( sign[0] ))) {
+      ak_error_message( ak_error_not_equal_data, __func__,
+                      "wrong reproducibility of digital signature with deterministic nonce" );
+      goto labexit1;
+    }
+    ak_verifykey_destroy( &vkey );
+    ak_signkey_destroy( &skey );
+  }
+  result = ak_true;
+  goto labexit;
+
+ labexit1:
+  ak_verifykey_destroy( &vkey );
+  ak_signkey_destroy( &skey );
+ labexit:
+  ak_random_destroy( &generator );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция тестирует пакетную выработку ключевых пар: подпись, выработанная каждым
+    секретным ключом, должна проверяться соответствующим открытым ключом и не должна
+    проверяться открытым ключом другой пары; при задании пароля должны формироваться
+    ASN.1 контейнеры с секретными ключами.
+
+    @return Функция возвращает истину только в том случае,
+    когда будут пройдены все тесты. В противном случае возвращается ложь.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_test_generate_batch( void )
+{
+  size_t i = 0;
+  ak_uint8 message[4] = { 0x01, 0x02, 0x03, 0x04 }, sign[128];
+  struct signkey_keygen_task tasks[6];
+  struct random generator;
+  int error = ak_error_ok;
+  bool_t result = ak_false;
+  ak_wcurve wc = ( ak_wcurve ) ak_oid_find_by_name( "id-tc26-gost-3410-2012-512-paramSetC" )->data;
+
+  if(( error = ak_random_create_lcg( &generator )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of random generator" );
+    return ak_false;
+  }
+
+ /* вырабатываем ключевые пары без экспорта */
+  if(( error = ak_signkey_generate_batch( wc, &generator, tasks, 6, NULL, 0 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect generation of key pairs" );
+    goto labexit;
+  }
+  for( i = 0; i < 6; i++ ) {
+     if(( tasks[i].asn != NULL ) ||
+        ( memcmp( tasks[i].sk.verifykey_number, tasks[i].vk.number,
+                                                            sizeof( tasks[i].vk.number )) != 0 )) {
+       ak_error_message( ak_error_not_equal_data, __func__, "wrong content of generated key pair" );
+       goto labexit1;
+     }
+     ak_signkey_sign_ptr( &tasks[i].sk, &generator, message, sizeof( message ),
+                                                                             sign, sizeof( sign ));
+     if( !ak_verifykey_verify_ptr( &tasks[i].vk, message, sizeof( message ), sign ) ||
+          ak_verifykey_verify_ptr( &tasks[(i+1)%6].vk, message, sizeof( message ), sign )) {
+       ak_error_message( ak_error_not_equal_data, __func__,
+                                         "wrong checking of digital signature for generated key" );
+       goto labexit1;
+     }
+  }
+  ak_signkey_generate_batch_destroy( tasks, 6 );
+
+ /* вырабатываем ключевые пары с экспортом секретных ключей */
+  if(( error = ak_signkey_generate_batch( wc, &generator, tasks, 2, "password", 8 ))
+                                                                                != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect generation of exported key pairs" );
+    goto labexit;
+  }
+  for( i = 0; i < 2; i++ ) {
+     if(( tasks[i].asn == NULL ) || ( tasks[i].asn->count != 1 )) {
+       ak_error_message( ak_error_null_pointer, __func__, "wrong export of generated secret key" );
+       ak_signkey_generate_batch_destroy( tasks, 2 );
+       goto labexit;
+     }
+  }
+  ak_signkey_generate_batch_destroy( tasks, 2 );
+  result = ak_true;
+  goto labexit;
+
+ labexit1:
+  ak_signkey_generate_batch_destroy( tasks, 6 );
+ labexit:
+  ak_random_destroy( &generator );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция тестирует проверку открытых ключей: для кривой с кофактором 4 точки,
+    не лежащие в подгруппе порядка \f$ q \f$, должны отвергаться, а точки подгруппы,
+    в том числе при повторной проверке, должны приниматься.
+
+    @return Функция возвращает истину только в том случае,
+    когда будут пройдены все тесты. В противном случае возвращается ложь.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_verifykey_test_check_point( void )
+{
+  struct wpoint wt;
+  struct verifykey vkey;
+  int error = ak_error_ok;
+  bool_t result = ak_false;
+  ak_uint64 one[ak_mpzn512_size] = ak_mpzn512_one;
+  ak_wcurve wc = ( ak_wcurve ) ak_oid_find_by_name( "id-tc26-gost-3410-2012-256-paramSetA" )->data;
+
+  if(( error = ak_verifykey_create( &vkey, wc )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of public key context" );
+    return ak_false;
+  }
+
+ /* образующая точка принадлежит подгруппе; повторная проверка использует кеш */
+  ak_wpoint_set( &vkey.qpoint, wc );
+  if(( ak_verifykey_check_point( &vkey ) != ak_error_ok ) ||
+     ( ak_verifykey_check_point( &vkey ) != ak_error_ok )) {
+    ak_error_message( ak_error_curve_point, __func__, "wrong checking of base point" );
+    goto labexit;
+  }
+
+ /* точка T = (t, 0) второго порядка принадлежит кривой, но не подгруппе порядка q */
+  wc->mul( wt.x, ( ak_uint64 *)wc->ecurve->t, one, wc->p, wc->n, wc->size );
+  ak_mpzn_set_ui( wt.y, wc->size, 0 );
+  ak_mpzn_set_ui( wt.z, wc->size, 1 );
+  ak_wpoint_set_wpoint( &vkey.qpoint, &wt, wc );
+  if( ak_wpoint_is_ok( &vkey.qpoint, wc ) != ak_true ) {
+    ak_error_message( ak_error_curve_point, __func__, "wrong creation of point of order two" );
+    goto labexit;
+  }
+  if( ak_verifykey_check_point( &vkey ) != ak_error_curve_point_order ) {
+    ak_error_message( ak_error_curve_point_order, __func__,
+                                                  "wrong checking of point of order two" );
+    goto labexit;
+  }
+
+ /* сумма образующей точки и точки T также не принадлежит подгруппе */
+  ak_wpoint_set( &vkey.qpoint, wc );
+  ak_wpoint_add( &vkey.qpoint, &wt, wc );
+  ak_wpoint_reduce( &vkey.qpoint, wc );
+  if( ak_verifykey_check_point( &vkey ) != ak_error_curve_point_order ) {
+    ak_error_message( ak_error_curve_point_order, __func__,
+                                           "wrong checking of point outside of the subgroup" );
+    goto labexit;
+  }
+
+ /* точка, не принадлежащая кривой */
+  ak_wpoint_set( &vkey.qpoint, wc );
+  vkey.qpoint.y[0] ^= 1;
+  if( ak_verifykey_check_point( &vkey ) != ak_error_curve_point ) {
+    ak_error_message( ak_error_curve_point, __func__, "wrong checking of point outside of curve" );
+    goto labexit;
+  }
+  ak_error_set_value( ak_error_ok );
+  result = ak_true;
+
+ labexit:
+  ak_verifykey_destroy( &vkey );
+ return result;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_libakrypt_test_sign( void )
 {
@@ -1363,9 +2895,11 @@
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
+  size_t idx = 0;
   struct signkey sk;
   ak_uint8 sign[128];
   struct verifykey pk;
+  struct verifykey_task tasks[3];
   int error = ak_error_ok, audit = ak_log_get_level();
 
   if( audit >= ak_log_maximum )
@@ -1439,6 +2973,39 @@
       ak_verifykey_destroy( &pk );
       return ak_false;
   }
+
+ /* повторяем проверку с использованием таблицы кратных точек открытого ключа */
+  if(( error = ak_verifykey_precompute( &pk )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect precomputation of public key table" );
+    ak_verifykey_destroy( &pk );
+    return ak_false;
+  }
+  if( !ak_verifykey_verify_hash( &pk, e256, sizeof( e256 ), sign )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+           "digital signature verification with precomputed public key table is wrong" );
+    ak_verifykey_destroy( &pk );
+    return ak_false;
+  }
+
+ /* пакетная проверка: две верные подписи и одна искаженная */
+  memcpy( sign+64, sign, 64 );
+  sign[64] ^= 0x01;
+  for( idx = 0; idx < 3; idx++ ) {
+     tasks[idx].key = &pk;
+     tasks[idx].hash = e256;
+     tasks[idx].hash_size = sizeof( e256 );
+     tasks[idx].sign = ( idx == 1 ) ? sign+64 : sign;
+  }
+  if(( ak_verifykey_verify_batch( tasks, 3 ) != ak_error_not_equal_data ) ||
+     ( tasks[0].result != ak_true ) || ( tasks[1].result != ak_false ) ||
+     ( tasks[1].error != ak_error_not_equal_data ) || ( tasks[2].result != ak_true )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                          "batch digital signature verification is wrong" );
+    ak_verifykey_destroy( &pk );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum )
+    ak_error_message( ak_error_ok, __func__ , "batch digital signature verification is Ok" );
   ak_verifykey_destroy( &pk );
 
  /* возвращаем константу в исходное состояние */
@@ -1520,6 +3087,18 @@
 
  /* 3. Тестирование случайно сгенеренных электронных подписей для всех определенных                                                                              эллиптических кривых */
   if( !ak_signkey_test_random_signatures( )) return ak_false;
+
+ /* 4. Тестирование выработки электронных подписей с использованием пула */
+  if( !ak_signkey_test_pool( )) return ak_false;
+
+ /* 5. Тестирование детерминированной выработки электронных подписей */
+  if( !ak_signkey_test_deterministic_nonce( )) return ak_false;
+
+ /* 6. Тестирование пакетной выработки ключевых пар */
+  if( !ak_signkey_test_generate_batch( )) return ak_false;
+
+ /* 7. Тестирование проверки открытых ключей */
+  if( !ak_verifykey_test_check_point( )) return ak_false;
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_get_value(), __func__ ,
                                                 "testing digital signatures ended successfully" );
  return ak_true;
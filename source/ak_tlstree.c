@@ -0,0 +1,675 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  Copyright (c) 2020 by Axel Kenzo, axelkenzo@mail.ru                                            */
+/*                                                                                                 */
+/*  Файл ak_tlstree.c                                                                              */
+/*  - содержит реализацию защиты записей протокола TLS 1.3 с использованием режима MGM             */
+/*    и преобразования ключей TLSTREE (Р 1323565.1.030-2020, RFC 9367)                             */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <libakrypt-internal.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef AK_HAVE_STRING_H
+ #include <string.h>
+#else
+ #error Library cannot be compiled without string.h header
+#endif
+#ifdef AK_HAVE_LIMITS_H
+ #include <limits.h>
+#endif
+#ifndef SSIZE_MAX
+ #define SSIZE_MAX ( (ssize_t)((( size_t )-1 ) >> 1 ))
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Константы \f$ C_1, C_2, C_3 \f$ преобразования TLSTREE для каждого из наборов
+    алгоритмов (порядок следования совпадает с перечислением \ref tls_suite_t).                    */
+ static const ak_uint64 tlstree_constants[4][3] = {
+  { 0xf800000000000000LL, 0xfffffff000000000LL, 0xffffffffffffe000LL }, /* kuznyechik_mgm_l */
+  { 0xffe0000000000000LL, 0xffffffffc0000000LL, 0xffffffffffffff80LL }, /* magma_mgm_l */
+  { 0xffffffffe0000000LL, 0xffffffffffff0000LL, 0xfffffffffffffff8LL }, /* kuznyechik_mgm_s */
+  { 0xfffffffffc000000LL, 0xffffffffffffe000LL, 0xffffffffffffffffLL }  /* magma_mgm_s */
+ };
+
+/*! \brief Метки, используемые на каждом из уровней преобразования TLSTREE. */
+ static const char *tlstree_labels[3] = { "level1", "level2", "level3" };
+
+/*! \brief Максимальная длина зашифровываемой части записи (TLSInnerPlaintext) в октетах. */
+ #define ak_tlsrecord_max_size  ( 16384 + 256 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает количество ключей, которые вырабатываются из одного ключа уровня
+    с маской `parent` для уровня с маской `child`; это значение является ресурсом ключа.
+    Для ключа K_root маска `parent` полагается равной нулю.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_tlsrecord_derivations( const ak_uint64 parent, const ak_uint64 child )
+{
+ return (( ~parent )/( ~child + 1 )) + 1;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция приводит значение ресурса к типу счетчика ресурса ключа.
+    \details Ресурс ключа K_root для наборов `_mgm_s` равен \f$ 2^{35} \f$ и \f$ 2^{38} \f$
+    и не помещается в 32-х битный тип `ssize_t`, поэтому значение ограничивается сверху
+    величиной `SSIZE_MAX`.                                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ssize_t ak_tlsrecord_resource( const ak_uint64 value )
+{
+ return ( value > ( ak_uint64 )SSIZE_MAX ) ? SSIZE_MAX : ( ssize_t )value;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует преобразование HKDF-Expand-Label протокола TLS 1.3 с пустым
+    контекстом и длиной результата, не превосходящей длины хеш-кода функции Стрибог256.
+
+    \param secret Ключ алгоритма hmac-streebog256, значением которого является секрет.
+    \param label Метка (без префикса "tls13 ").
+    \param out Область памяти, куда помещается результат.
+    \param out_size Длина результата в октетах (не более 32-х).
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_tlsrecord_expand_label( ak_hmac secret, const char *label,
+                                                               ak_uint8 *out, const size_t out_size )
+{
+  int error = ak_error_ok;
+  ak_uint8 info[32], result[32];
+  size_t len = strlen( label );
+
+ /* формируем структуру HkdfLabel, за которой следует номер блока T(1) */
+  info[0] = 0;
+  info[1] = ( ak_uint8 )out_size;
+  info[2] = ( ak_uint8 )( 6 + len );
+  memcpy( info+3, "tls13 ", 6 );
+  memcpy( info+9, label, len );
+  info[9+len] = 0;    /* пустой контекст */
+  info[10+len] = 1;   /* номер блока */
+
+  if(( error = ak_hmac_ptr( secret, info, 11+len, result, sizeof( result ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect calculation of hkdf-expand-label" );
+  memcpy( out, result, out_size );
+  ak_ptr_wipe( result, sizeof( result ), &secret->key.generator );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает из секрета (traffic secret) протокола TLS 1.3 ключ K_root (write_key)
+    и вектор write_iv, после чего создает ключи всех уровней преобразования TLSTREE.
+    Значение номера записи устанавливается равным нулю.
+
+    @param ctx Контекст защиты записей.
+    @param suite Набор алгоритмов.
+    @param secret Секрет (traffic secret), длина которого равна 32 октетам.
+    @param secret_size Длина секрета в октетах.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlsrecord_create( ak_tlsrecord ctx, tls_suite_t suite,
+                                                const ak_pointer secret, const size_t secret_size )
+{
+  size_t idx = 0;
+  struct hmac hsecret;
+  int error = ak_error_ok;
+  ak_uint8 key[32], iv[16];
+
+  if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to tls record context" );
+  if( secret == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                          "using null pointer to traffic secret" );
+  if( secret_size != 32 ) return ak_error_message( ak_error_wrong_length, __func__,
+                                                       "using traffic secret with wrong length" );
+  memset( ctx, 0, sizeof( struct tlsrecord ));
+  switch( suite ) {
+    case tls_kuznechik_mgm_l:
+    case tls_kuznechik_mgm_s: error = ak_bckey_create_kuznechik( &ctx->key ); break;
+    case tls_magma_mgm_l:
+    case tls_magma_mgm_s: error = ak_bckey_create_magma( &ctx->key ); break;
+    default: return ak_error_message( ak_error_undefined_value, __func__,
+                                                              "using unsupported cipher suite" );
+  }
+  if( error != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of record key" );
+  ctx->suite = suite;
+  memcpy( ctx->mask, tlstree_constants[suite], sizeof( ctx->mask ));
+
+  if(( error = ak_hmac_create_streebog256( &ctx->root )) != ak_error_ok ) {
+    ak_bckey_destroy( &ctx->key );
+    return ak_error_message( error, __func__, "incorrect creation of root key" );
+  }
+  if(( error = ak_hmac_create_streebog256( &ctx->level1 )) != ak_error_ok ) {
+    ak_hmac_destroy( &ctx->root );
+    ak_bckey_destroy( &ctx->key );
+    return ak_error_message( error, __func__, "incorrect creation of first level key" );
+  }
+  if(( error = ak_hmac_create_streebog256( &ctx->level2 )) != ak_error_ok ) {
+    ak_hmac_destroy( &ctx->level1 );
+    ak_hmac_destroy( &ctx->root );
+    ak_bckey_destroy( &ctx->key );
+    return ak_error_message( error, __func__, "incorrect creation of second level key" );
+  }
+
+ /* вырабатываем write_key и write_iv */
+  if(( error = ak_hmac_create_streebog256( &hsecret )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of traffic secret context" );
+    goto labex;
+  }
+  if(( error = ak_hmac_set_key( &hsecret, secret, secret_size )) == ak_error_ok )
+    if(( error = ak_tlsrecord_expand_label( &hsecret, "key", key, 32 )) == ak_error_ok )
+      error = ak_tlsrecord_expand_label( &hsecret, "iv", iv, ctx->key.bsize );
+  ak_hmac_destroy( &hsecret );
+  if( error != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect derivation of write key and write iv" );
+    goto labex;
+  }
+  if(( error = ak_hmac_set_key( &ctx->root, key, 32 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect assigning of root key value" );
+    goto labex;
+  }
+  ctx->root.key.resource.value.counter =
+                               ak_tlsrecord_resource( ak_tlsrecord_derivations( 0, ctx->mask[0] ));
+
+ /* вектор write_iv сохраняется в принятом в библиотеке порядке следования октетов
+    (младший октет - первый), поэтому номер записи складывается с его младшими октетами */
+  for( idx = 0; idx < ctx->key.bsize; idx++ ) ctx->iv[idx] = iv[ctx->key.bsize-1-idx];
+
+  labex:
+   ak_ptr_wipe( key, sizeof( key ), &ctx->root.key.generator );
+   ak_ptr_wipe( iv, sizeof( iv ), &ctx->root.key.generator );
+   if( error != ak_error_ok ) ak_tlsrecord_destroy( ctx );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ctx Контекст защиты записей.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlsrecord_destroy( ak_tlsrecord ctx )
+{
+  if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to tls record context" );
+  ak_hmac_destroy( &ctx->root );
+  ak_hmac_destroy( &ctx->level1 );
+  ak_hmac_destroy( &ctx->level2 );
+  ak_bckey_destroy( &ctx->key );
+  memset( ctx, 0, sizeof( struct tlsrecord ));
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ctx Контекст защиты записей.
+    @param seqnum Номер следующей обрабатываемой записи.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlsrecord_set_seqnum( ak_tlsrecord ctx, const ak_uint64 seqnum )
+{
+  if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to tls record context" );
+  ctx->seqnum = seqnum;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ctx Контекст защиты записей.
+    @return Функция возвращает длину имитовставки в октетах (длину блока шифра).
+    В случае ошибки возвращается ноль.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_tlsrecord_get_tag_size( ak_tlsrecord ctx )
+{
+  if( ctx == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to tls record context" );
+    return 0;
+  }
+ return ctx->key.bsize;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет ключ записи с номером ctx->seqnum.
+
+    Ключи каждого уровня преобразования TLSTREE хранятся вместе со значением
+    \f$ seqnum \& C_j \f$, для которого они были выработаны. Поэтому заново вычисляются только
+    те уровни, для которых это значение изменилось; как правило, это только ключ записи.
+
+    \param ctx Контекст защиты записей.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_tlsrecord_update_keys( ak_tlsrecord ctx )
+{
+  ak_uint8 seed[8];
+  ak_uint64 records = 0;
+  ak_hmac parents[3];
+  ak_pointer children[3];
+  struct kdf_tree_task task;
+  size_t idx = 0, level = 0;
+  int error = ak_error_ok;
+
+  if( !ctx->ready ) level = 0;
+   else {
+     for( level = 0; level < 3; level++ )
+        if(( ctx->seqnum&ctx->mask[level] ) != ctx->cached[level] ) break;
+     if( level == 3 ) return ak_error_ok;
+   }
+
+  parents[0] = &ctx->root; parents[1] = &ctx->level1; parents[2] = &ctx->level2;
+  children[0] = &ctx->level1; children[1] = &ctx->level2; children[2] = &ctx->key;
+
+  ctx->ready = ak_false;
+  for( ; level < 3; level++ ) {
+     ak_uint64 value = ctx->seqnum&ctx->mask[level];
+     for( idx = 0; idx < 8; idx++ ) seed[idx] = ( ak_uint8 )( value >> ( 56 - ( idx << 3 )));
+
+     memset( &task, 0, sizeof( struct kdf_tree_task ));
+     task.label = ( ak_pointer )tlstree_labels[level];
+     task.label_size = 6;
+     task.seed = seed;
+     task.seed_size = sizeof( seed );
+     task.size = 32;
+     task.key = children[level];
+     if(( error = ak_hmac_kdf_tree_batch( parents[level], 1, &task, 1 )) != ak_error_ok )
+       return ak_error_message_fmt( error, __func__,
+                                          "incorrect derivation of tlstree %s key", task.label );
+     ctx->cached[level] = value;
+    /* ресурс ключей промежуточных уровней определяется константами C_j набора алгоритмов */
+     if( level < 2 ) (( ak_hmac )children[level] )->key.resource.value.counter =
+        ak_tlsrecord_resource( ak_tlsrecord_derivations( ctx->mask[level], ctx->mask[level+1] ));
+  }
+
+ /* ресурс ключа записи определяется количеством записей, защищаемых на одном ключе */
+  records = ( ~ctx->mask[2] ) + 1;
+  ctx->key.key.resource.value.counter = ak_tlsrecord_resource(
+                                  records*( 2*( ak_tlsrecord_max_size/ctx->key.bsize + 2 ) + 4 ));
+  ctx->ready = ak_true;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция формирует синхропосылку для записи с номером ctx->seqnum.
+    \details Синхропосылка равна сумме по модулю два вектора write_iv и номера записи;
+    выделения памяти не производится.                                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_tlsrecord_nonce( ak_tlsrecord ctx, ak_uint8 *nonce )
+{
+  size_t idx = 0;
+  ak_uint64 seqnum = ctx->seqnum;
+
+  memcpy( nonce, ctx->iv, ctx->key.bsize );
+  for( idx = 0; idx < 8; idx++, seqnum >>= 8 ) nonce[idx] ^= ( ak_uint8 )seqnum;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифровывает или расшифровывает одну запись с номером ctx->seqnum
+    и увеличивает номер записи на единицу.                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_tlsrecord_process( ak_tlsrecord ctx, ak_function_aead *aead,
+                               const ak_pointer adata, const size_t adata_size, const ak_pointer in,
+                                             ak_pointer out, const size_t size, ak_pointer icode )
+{
+  ak_uint8 nonce[16];
+  int error = ak_error_ok;
+
+  if( size > ak_tlsrecord_max_size ) return ak_error_message( ak_error_wrong_length, __func__,
+                                                                    "using very huge tls record" );
+  if(( error = ak_tlsrecord_update_keys( ctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect update of record key" );
+
+  ak_tlsrecord_nonce( ctx, nonce );
+  error = aead( &ctx->key, &ctx->key, adata, adata_size, in, out, size,
+                                                  nonce, ctx->key.bsize, icode, ctx->key.bsize );
+  ctx->seqnum++;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция зашифровывает запись с номером, хранящимся в контексте, и вырабатывает имитовставку,
+    после чего номер записи увеличивается на единицу.
+
+    @param ctx Контекст защиты записей.
+    @param adata Ассоциированные данные (заголовок записи).
+    @param adata_size Длина ассоциированных данных в октетах.
+    @param in Зашифровываемые данные.
+    @param out Область памяти, куда помещаются зашифрованные данные.
+    @param size Длина зашифровываемых данных в октетах.
+    @param icode Область памяти, куда помещается имитовставка; длина области должна быть
+    не менее значения, возвращаемого функцией ak_tlsrecord_get_tag_size().
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlsrecord_seal( ak_tlsrecord ctx, const ak_pointer adata, const size_t adata_size,
+                      const ak_pointer in, ak_pointer out, const size_t size, ak_pointer icode )
+{
+  if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to tls record context" );
+ return ak_tlsrecord_process( ctx, ak_bckey_encrypt_mgm, adata, adata_size, in, out, size, icode );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция расшифровывает запись с номером, хранящимся в контексте, и проверяет имитовставку,
+    после чего номер записи увеличивается на единицу.
+
+    @param ctx Контекст защиты записей.
+    @param adata Ассоциированные данные (заголовок записи).
+    @param adata_size Длина ассоциированных данных в октетах.
+    @param in Расшифровываемые данные.
+    @param out Область памяти, куда помещаются расшифрованные данные.
+    @param size Длина расшифровываемых данных в октетах.
+    @param icode Имитовставка.
+
+    @return Функция возвращает \ref ak_error_ok, если имитовставка верна. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlsrecord_open( ak_tlsrecord ctx, const ak_pointer adata, const size_t adata_size,
+                      const ak_pointer in, ak_pointer out, const size_t size, ak_pointer icode )
+{
+  if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to tls record context" );
+ return ak_tlsrecord_process( ctx, ak_bckey_decrypt_mgm, adata, adata_size, in, out, size, icode );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработка массива записей с последовательными номерами. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_tlsrecord_process_batch( ak_tlsrecord ctx, ak_function_aead *aead,
+                                                   ak_tlsrecord_item items, const size_t count )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+
+  if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                  "using null pointer to tls record context" );
+  if( items == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                          "using null pointer to record array" );
+  for( idx = 0; idx < count; idx++ )
+     if(( items[idx].error = ak_tlsrecord_process( ctx, aead, items[idx].adata,
+               items[idx].adata_size, items[idx].in, items[idx].out, items[idx].size,
+                                                      items[idx].icode )) != ak_error_ok )
+       error = items[idx].error;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция зашифровывает массив записей, которым присваиваются последовательные номера,
+    начиная с номера, хранящегося в контексте. Ключи уровней преобразования TLSTREE
+    вычисляются заново только при изменении соответствующих им фрагментов номера записи.
+
+    @param ctx Контекст защиты записей.
+    @param items Массив записей; результат обработки каждой записи помещается в поле `error`.
+    @param count Количество записей.
+
+    @return В случае успешной обработки всех записей функция возвращает \ref ak_error_ok.
+    В противном случае возвращается код ошибки, возникшей при обработке одной из записей.          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlsrecord_seal_batch( ak_tlsrecord ctx, ak_tlsrecord_item items, const size_t count )
+{
+  return ak_tlsrecord_process_batch( ctx, ak_bckey_encrypt_mgm, items, count );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция расшифровывает массив записей, которым присваиваются последовательные номера,
+    начиная с номера, хранящегося в контексте, и проверяет их имитовставки.
+
+    @param ctx Контекст защиты записей.
+    @param items Массив записей; результат обработки каждой записи помещается в поле `error`.
+    @param count Количество записей.
+
+    @return Функция возвращает \ref ak_error_ok, если имитовставки всех записей верны.
+    В противном случае возвращается код ошибки, возникшей при обработке одной из записей.          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_tlsrecord_open_batch( ak_tlsrecord ctx, ak_tlsrecord_item items, const size_t count )
+{
+  return ak_tlsrecord_process_batch( ctx, ak_bckey_decrypt_mgm, items, count );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                 функции тестирования                                            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сравнивает ключ записи, хранящийся в контексте, с заданным значением ключа,
+    сравнивая результаты зашифрования одного блока.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_tlsrecord_test_compare_key( ak_tlsrecord ctx, ak_uint8 *key )
+{
+  struct bckey bkey;
+  bool_t result = ak_false;
+  ak_uint8 in[16], out[32];
+
+  memset( in, 0x11, sizeof( in ));
+  if( ctx->key.bsize == 16 ) ak_bckey_create_kuznechik( &bkey );
+    else ak_bckey_create_magma( &bkey );
+  ak_bckey_set_key( &bkey, key, 32 );
+
+  bkey.encrypt( &bkey.key, in, out );
+  ctx->key.encrypt( &ctx->key.key, in, out+16 );
+  result = ak_ptr_is_equal_with_log( out, out+16, ctx->key.bsize );
+
+  ak_bckey_destroy( &bkey );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сравнивает ключ записи, хранящийся в контексте, с ключом, выработанным
+    непосредственно по определению преобразования TLSTREE.                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_tlsrecord_test_leaf_key( ak_tlsrecord ctx, const ak_uint64 seqnum )
+{
+  size_t idx = 0, jdx = 0;
+  struct hmac hkey;
+  bool_t result = ak_false;
+  ak_uint8 key[32], seed[8];
+
+  ak_hmac_create_streebog256( &hkey );
+  ctx->root.key.unmask( &ctx->root.key );
+  ak_hmac_set_key( &hkey, ctx->root.key.key, 32 );
+  ctx->root.key.set_mask( &ctx->root.key );
+
+  for( idx = 0; idx < 3; idx++ ) {
+     ak_uint64 value = seqnum&ctx->mask[idx];
+     for( jdx = 0; jdx < 8; jdx++ ) seed[jdx] = ( ak_uint8 )( value >> ( 56 - ( jdx << 3 )));
+     ak_hmac_kdf_tree( &hkey, ( ak_pointer )tlstree_labels[idx], 6, seed, 8, 1, key, 32 );
+     ak_hmac_set_key( &hkey, key, 32 );
+  }
+  result = ak_tlsrecord_test_compare_key( ctx, key );
+
+  ak_hmac_destroy( &hkey );
+  ak_ptr_wipe( key, sizeof( key ), &ctx->root.key.generator );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет значения write_key, write_iv и ключей записей, вырабатываемых
+    преобразованием TLSTREE для каждого из наборов алгоритмов.
+
+    В качестве секрета используется последовательность октетов 01 04 07 ... 5e.
+    Для каждого набора вычисляются ключи записи с номером 0 и записи, номер которой отличается
+    от нуля на всех трех уровнях преобразования; значения ключей записаны в порядке
+    следования октетов, определяемом RFC 9367.                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_tlsrecord_test_tlstree( void )
+{
+  size_t idx = 0, jdx = 0;
+  ak_uint8 secret[32], iv[16];
+  struct tlsrecord ctx;
+  int error = ak_error_ok;
+  bool_t result = ak_true;
+
+ /* значения write_key и write_iv (для длины блока 16 и 8 октетов) */
+  ak_uint8 write_key[32] = {
+    0x76, 0x6a, 0xd4, 0xa8, 0x2c, 0xf2, 0x69, 0xe9, 0xaa, 0xbe, 0x68, 0x9d, 0x6b, 0xbd, 0xd4, 0xd8,
+    0x1d, 0x78, 0x9a, 0x57, 0xc3, 0x81, 0xc7, 0x0b, 0x6c, 0x2b, 0x0e, 0x00, 0x38, 0x89, 0x34, 0xf3 };
+  ak_uint8 write_iv16[16] = {
+    0x18, 0x98, 0xc6, 0xf7, 0x73, 0xaf, 0xdf, 0xf5, 0x90, 0x47, 0x7d, 0x71, 0x91, 0xf2, 0x12, 0xf9 };
+  ak_uint8 write_iv8[8] = {
+    0xe2, 0x2f, 0x2e, 0xeb, 0x66, 0xf4, 0xce, 0x78 };
+
+ /* ключ записи с номером 0 (совпадает для всех наборов алгоритмов) */
+  ak_uint8 key_zero[32] = {
+    0xa3, 0xde, 0x4d, 0x06, 0xba, 0x9a, 0xb0, 0x9f, 0x50, 0xbf, 0x30, 0x26, 0x8a, 0xd6, 0xc1, 0x14,
+    0xe3, 0x7c, 0xb2, 0x25, 0x66, 0x8b, 0x33, 0xb1, 0x0b, 0x83, 0xf6, 0x67, 0x16, 0xf8, 0x35, 0xec };
+
+ /* ключи записей с номерами (~C_1 + 1) + (~C_2 + 1) + (~C_3 + 1) + 1 */
+  ak_uint8 keys[4][32] = {
+   {
+    0x5d, 0x3d, 0x4b, 0xc8, 0xb3, 0x81, 0x87, 0x00, 0x46, 0x4f, 0xce, 0xcc, 0x85, 0xfd, 0x57, 0x52,
+    0x66, 0xb8, 0x49, 0x1d, 0x7e, 0x21, 0x2f, 0x9d, 0x57, 0x8c, 0xd3, 0xb4, 0x1e, 0xcd, 0xf2, 0x4e },
+   {
+    0x0f, 0x30, 0xed, 0x4f, 0xad, 0x51, 0xcb, 0x34, 0x53, 0xcc, 0x5d, 0x07, 0xb8, 0x2d, 0xf6, 0x27,
+    0x70, 0x65, 0x26, 0x47, 0x41, 0xcf, 0x8c, 0xbc, 0x00, 0x30, 0xd8, 0x10, 0x73, 0xb8, 0xe5, 0x68 },
+   {
+    0x5f, 0xc1, 0xe8, 0xd9, 0x0d, 0x1f, 0x65, 0xfd, 0x01, 0x76, 0xb0, 0x78, 0x8f, 0x90, 0xb2, 0xa2,
+    0x33, 0x36, 0xbd, 0xcf, 0x88, 0xcf, 0x2d, 0x85, 0x07, 0x2c, 0xae, 0xf0, 0x3b, 0x2d, 0x3f, 0xa8 },
+   {
+    0x47, 0x60, 0x92, 0x55, 0x9d, 0x32, 0x94, 0xb1, 0x5c, 0xe8, 0xb2, 0x4c, 0x29, 0xfd, 0xc3, 0x1d,
+    0x15, 0x7b, 0x34, 0xce, 0xdb, 0xb1, 0x3f, 0x5b, 0x74, 0x77, 0x0a, 0xe3, 0xdf, 0x8a, 0x56, 0xf0 }
+  };
+
+  for( idx = 0; idx < sizeof( secret ); idx++ ) secret[idx] = ( ak_uint8 )( 3*idx + 1 );
+  for( jdx = 0; ( jdx < 4 ) && result; jdx++ ) {
+     ak_uint64 seqnum = 1;
+     if(( error = ak_tlsrecord_create( &ctx, ( tls_suite_t )jdx, secret, 32 )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect creation of tls record context" );
+       return ak_false;
+     }
+
+    /* write_key является ключом K_root, а write_iv хранится в обратном порядке октетов */
+     ctx.root.key.unmask( &ctx.root.key );
+     result = ak_ptr_is_equal_with_log( ctx.root.key.key, write_key, 32 );
+     ctx.root.key.set_mask( &ctx.root.key );
+     for( idx = 0; idx < ctx.key.bsize; idx++ ) iv[idx] = ctx.iv[ctx.key.bsize-1-idx];
+     if( result ) result = ak_ptr_is_equal_with_log( iv,
+                                     ( ctx.key.bsize == 16 ) ? write_iv16 : write_iv8, ctx.key.bsize );
+     if( !result ) ak_error_message( ak_error_not_equal_data, __func__,
+                                                          "wrong value of write_key or write_iv" );
+
+     if( result && (( ak_tlsrecord_update_keys( &ctx ) != ak_error_ok ) ||
+                                              !ak_tlsrecord_test_compare_key( &ctx, key_zero ))) {
+       ak_error_message( ak_error_not_equal_data, __func__, "wrong tlstree key for record 0" );
+       result = ak_false;
+     }
+
+     for( idx = 0; idx < 3; idx++ ) seqnum += ~ctx.mask[idx] + 1;
+     ak_tlsrecord_set_seqnum( &ctx, seqnum );
+     if( result && (( ak_tlsrecord_update_keys( &ctx ) != ak_error_ok ) ||
+                                              !ak_tlsrecord_test_compare_key( &ctx, keys[jdx] ))) {
+       ak_error_message_fmt( ak_error_not_equal_data, __func__,
+                        "wrong tlstree key for record %llu", ( unsigned long long )seqnum );
+       result = ak_false;
+     }
+     ak_tlsrecord_destroy( &ctx );
+  }
+  if( result && ( ak_log_get_level() >= ak_log_maximum ))
+    ak_error_message( ak_error_ok, __func__, "tlstree key derivation test is Ok" );
+
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что ключи, вычисляемые с использованием кеширования уровней
+    преобразования TLSTREE, совпадают с ключами, вычисляемыми непосредственно по определению,
+    а также корректность пакетной обработки записей, номера которых пересекают границы
+    смены ключей. Для набора magma_mgm_s номера записей пересекают границу смены ключа
+    первого уровня; при этом проверяется расходование ресурса ключа K_root.                        */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_test_tlsrecord( void )
+{
+  size_t idx = 0, jdx = 0;
+  ak_uint8 secret[32], header[5] = { 0x17, 0x03, 0x03, 0x00, 0x00 };
+  ak_uint8 data[12][40], cipher[12][40], plain[12][40], icode[12][16];
+  struct tlsrecord_item items[12];
+  struct tlsrecord sender, receiver;
+  int error = ak_error_ok, audit = ak_log_get_level();
+  tls_suite_t suites[3] = { tls_kuznechik_mgm_s, tls_magma_mgm_l, tls_magma_mgm_s };
+  const char *names[3] = { "kuznechik_mgm_s", "magma_mgm_l", "magma_mgm_s" };
+  ak_uint64 start[3] = { 0x7fa, 0x77, 0x3fffffa };
+  ssize_t resource = 0;
+
+  if( !ak_tlsrecord_test_tlstree( )) return ak_false;
+
+  for( idx = 0; idx < sizeof( secret ); idx++ ) secret[idx] = ( ak_uint8 )( 3*idx + 1 );
+  for( idx = 0; idx < 12; idx++ )
+     for( jdx = 0; jdx < 40; jdx++ ) data[idx][jdx] = ( ak_uint8 )( idx*jdx + 7 );
+
+  for( jdx = 0; jdx < 3; jdx++ ) {
+     if(( error = ak_tlsrecord_create( &sender, suites[jdx], secret, 32 )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect creation of tls record context" );
+       return ak_false;
+     }
+     if(( error = ak_tlsrecord_create( &receiver, suites[jdx], secret, 32 )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect creation of tls record context" );
+       ak_tlsrecord_destroy( &sender );
+       return ak_false;
+     }
+
+    /* зашифровываем записи, номера которых пересекают границу смены ключа записи */
+     memset( items, 0, sizeof( items ));
+     for( idx = 0; idx < 12; idx++ ) {
+        items[idx].adata = header; items[idx].adata_size = sizeof( header );
+        items[idx].in = data[idx]; items[idx].out = cipher[idx];
+        items[idx].size = 40 - idx; items[idx].icode = icode[idx];
+     }
+     resource = sender.root.key.resource.value.counter;
+     ak_tlsrecord_set_seqnum( &sender, start[jdx] );
+     if(( error = ak_tlsrecord_seal_batch( &sender, items, 12 )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect encryption of tls records" );
+       goto labex;
+     }
+    /* ключ K_root используется повторно только при смене ключа первого уровня */
+     resource -= ((( start[jdx]+11 )&sender.mask[0] ) != ( start[jdx]&sender.mask[0] )) ? 2 : 1;
+     if( sender.root.key.resource.value.counter != resource ) {
+       ak_error_message( error = ak_error_low_key_resource, __func__,
+                                                        "wrong resource of tlstree root key" );
+       goto labex;
+     }
+     if( !ak_tlsrecord_test_leaf_key( &sender, start[jdx]+11 )) {
+       ak_error_message( error = ak_error_not_equal_data, __func__,
+                                                         "wrong caching of tlstree record key" );
+       goto labex;
+     }
+
+    /* расшифровываем записи по одной, начиная с последней (ключи вычисляются заново) */
+     for( idx = 0; idx < 12; idx++ ) {
+        ak_tlsrecord_set_seqnum( &receiver, start[jdx]+11-idx );
+        if(( error = ak_tlsrecord_open( &receiver, header, sizeof( header ),
+                       cipher[11-idx], plain[11-idx], 29+idx, icode[11-idx] )) != ak_error_ok ) {
+          ak_error_message( error, __func__, "incorrect decryption of tls record" );
+          goto labex;
+        }
+        if( !ak_ptr_is_equal_with_log( plain[11-idx], data[11-idx], 29+idx )) {
+          ak_error_message( error = ak_error_not_equal_data, __func__,
+                                                                "wrong decryption of tls record" );
+          goto labex;
+        }
+     }
+
+    /* пакетное расшифрование с одной испорченной записью */
+     cipher[5][0] ^= 1;
+     for( idx = 0; idx < 12; idx++ ) items[idx].in = cipher[idx], items[idx].out = plain[idx];
+     ak_tlsrecord_set_seqnum( &receiver, start[jdx] );
+     ak_tlsrecord_open_batch( &receiver, items, 12 );
+     for( idx = 0; idx < 12; idx++ )
+        if(( items[idx].error == ak_error_ok ) != ( idx != 5 )) {
+          ak_error_message( error = ak_error_not_equal_data, __func__,
+                                             "wrong integrity checking of tls records batch" );
+          goto labex;
+        }
+     error = ak_error_ok;
+     if( audit >= ak_log_maximum ) ak_error_message_fmt( ak_error_ok, __func__,
+                            "the tls record protection test for %s suite is Ok", names[jdx] );
+     labex:
+      ak_tlsrecord_destroy( &receiver );
+      ak_tlsrecord_destroy( &sender );
+      if( error != ak_error_ok ) return ak_false;
+  }
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                   ak_tlstree.c  */
+/* ----------------------------------------------------------------------------------------------- */
@@ -0,0 +1,564 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  Copyright (c) 2020 by Axel Kenzo, axelkenzo@mail.ru                                            */
+/*                                                                                                 */
+/*  Файл ak_vko.c                                                                                  */
+/*  - содержит реализацию алгоритма выработки общего ключа VKO, регламентируемого                  */
+/*    рекомендациями Р 50.1.113-2016 (RFC 7836).                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <libakrypt-internal.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/** \addtogroup skey-vko-doc Выработка общего ключа по алгоритму VKO @{
+   Алгоритм VKO позволяет двум абонентам, обладающим ключевыми парами алгоритма
+   ГОСТ Р 34.10-2012 на одной эллиптической кривой, выработать общий ключ шифрования ключей
+   (KEK). Для секретного ключа \f$ x \f$ одного абонента, открытого ключа \f$ Y = [y]P \f$
+   другого абонента и случайного числа \f$ UKM \f$ вычисляется точка
+
+   \f[ K(x, Y, UKM) = [(m/q) \cdot UKM \cdot x \pmod{q}]Y, \f]
+
+   где \f$ m/q \f$ - кофактор эллиптической кривой, после чего общий ключ
+   определяется равенством \f$ KEK = H( K_x \| K_y ) \f$. Координаты точки \f$ K \f$
+   представляются в виде последовательностей октетов в порядке little-endian,
+   а \f$ H \f$ - функция хеширования Стрибог-256 (алгоритм VKO_GOSTR3410_2012_256)
+   или Стрибог-512 (алгоритм VKO_GOSTR3410_2012_512).
+
+   Кратная точка вычисляется с помощью лесенки Монтгомери в co-Z координатах
+   (функция ak_wpoint_pow_coz()), а для кривых, имеющих эквивалентную форму Эдвардса, -
+   с помощью лесенки на кривой Эдвардса. При выработке общих ключей с несколькими абонентами
+   (функция ak_signkey_vko_batch()) приведение точек к аффинной форме выполняется
+   одновременно, с одним обращением в конечном поле на блок абонентов.                          */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество точек, приводимых к аффинной форме одновременно. */
+ #define ak_signkey_vko_batch_block  ( 16 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет, что секретный и открытый ключи могут использоваться
+    для выработки общего ключа: ключи должны принадлежать одной кривой, а открытый ключ -
+    подгруппе порядка \f$ q \f$ (см. ak_verifykey_check_point()). Для кривых с кофактором,
+    отличным от единицы, тем самым отвергаются точки малого порядка.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_vko_check( ak_signkey sctx, ak_verifykey pctx )
+{
+  int error = ak_error_ok;
+
+  if( pctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to public key context" );
+  if( pctx->wc != ( ak_wcurve ) sctx->key.data ) return ak_error_message(
+               ak_error_curve_not_supported, __func__ , "using keys from different elliptic curves" );
+  if(( error = ak_verifykey_check_point( pctx )) != ak_error_ok )
+    return ak_error_message( error, __func__ ,
+                                              "public key is not a point of prime order subgroup" );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет вычет \f$ t \equiv (m/q) \cdot UKM \cdot x \pmod{q} \f$, где
+    \f$ x \f$ - секретный ключ; после вычисления секретный ключ перемаскируется.
+
+    @param sctx контекст секретного ключа.
+    @param ukm указатель на случайное число \f$ UKM \f$ (последовательность октетов
+    в порядке little-endian); нулевое значение \f$ UKM \f$ заменяется единицей.
+    @param ukm_size размер \f$ UKM \f$ в октетах.
+    @param t вычет, в который помещается результат.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_vko_scalar( ak_signkey sctx, const ak_pointer ukm,
+                                                            const size_t ukm_size, ak_uint64 *t )
+{
+  ak_mpzn512 u, h, one = ak_mpzn512_one;
+  ak_uint8 buffer[sizeof( ak_mpzn512 )];
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+
+  if( ukm == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                               "using null pointer to ukm value" );
+  if( !ukm_size ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                "using ukm with zero length" );
+  if( ukm_size > sizeof( ak_uint64 )*wc->size )
+    return ak_error_message( ak_error_wrong_length, __func__ , "using ukm with wrong length" );
+
+ /* u <- UKM (mod q) в представлении Монтгомери, нулевое значение заменяется единицей */
+  memset( buffer, 0, sizeof( buffer ));
+  memcpy( buffer, ukm, ukm_size );
+  ak_mpzn_set_little_endian( u, wc->size, buffer, sizeof( ak_uint64 )*wc->size, ak_false );
+  ak_wcurve_rem_q_montgomery( u, u, wc );
+  if( ak_mpzn_cmp_ui( u, wc->size, 0 )) {
+    ak_mpzn_set_ui( u, wc->size, 1 );
+    wc->mulq( u, u, wc->r2q, wc->q, wc->nq, wc->size );
+  }
+
+ /* t <- (m/q)*u*x (mod q); секретный ключ хранится в виде произведения x = k*m*R^{-2},
+    поэтому домножаем на ключ, потом на маску, и возвращаемся к обычной форме */
+  ak_mpzn_set_ui( h, wc->size, wc->cofactor );
+  wc->mulq( h, h, wc->r2q, wc->q, wc->nq, wc->size );
+  wc->mulq( t, u, h, wc->q, wc->nq, wc->size );
+  wc->mulq( t, t, (ak_uint64 *)sctx->key.key, wc->q, wc->nq, wc->size );
+  wc->mulq( t, t,
+              (ak_uint64 *)( sctx->key.key+sctx->key.key_size ), wc->q, wc->nq, wc->size );
+  wc->mulq( t, t, one, wc->q, wc->nq, wc->size );
+
+  sctx->key.set_mask( &sctx->key );
+  ak_ptr_wipe( u, sizeof( ak_mpzn512 ), &sctx->key.generator );
+  ak_ptr_wipe( buffer, sizeof( buffer ), &sctx->key.generator );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет общую точку \f$ K = [t]Y \f$ в проективной форме. Для кривых,
+    имеющих эквивалентную форму Эдвардса, лесенка на кривой Эдвардса выполняется быстрее
+    лесенки в co-Z координатах, поэтому для них используется функция ak_wpoint_pow().           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_signkey_vko_pow( ak_wpoint wk, ak_wpoint wy, ak_uint64 *t, ak_wcurve wc )
+{
+  if( wc->ecurve != NULL ) ak_wpoint_pow( wk, wy, t, wc->size, wc );
+   else ak_wpoint_pow_coz( wk, wy, t, wc );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение \f$ KEK = H( K_x \| K_y ) \f$ для точки \f$ K \f$,
+    приведенной к аффинной форме.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_vko_export( ak_signkey sctx, ak_wpoint wk, ak_hash ctx,
+                                                             ak_pointer out, const size_t out_size )
+{
+  int error = ak_error_ok;
+  ak_uint8 buffer[2*sizeof( ak_mpzn512 )];
+  ak_wcurve wc = ( ak_wcurve ) sctx->key.data;
+  size_t len = sizeof( ak_uint64 )*wc->size;
+
+  if( ak_mpzn_cmp_ui( wk->z, wc->size, 0 ) == ak_true )
+    return ak_error_message( ak_error_curve_point, __func__ ,
+                                                 "shared point is a point at infinity" );
+  ak_mpzn_to_little_endian( wk->x, wc->size, buffer, len, ak_false );
+  ak_mpzn_to_little_endian( wk->y, wc->size, buffer + len, len, ak_false );
+  if(( error = ak_hash_ptr( ctx, buffer, 2*len, out, out_size )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect hashing of shared point" );
+  ak_ptr_wipe( buffer, sizeof( buffer ), &sctx->key.generator );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает контекст функции хеширования, определяемой длиной общего ключа:
+    Стрибог-256 для ключа длины 32 октета и Стрибог-512 для ключа длины 64 октета.               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_signkey_vko_create_hash( ak_hash ctx, const size_t out_size )
+{
+  switch( out_size ) {
+    case 32: return ak_hash_create_streebog256( ctx );
+    case 64: return ak_hash_create_streebog512( ctx );
+  }
+ return ak_error_message( ak_error_wrong_length, __func__ ,
+                                         "using shared key with unexpected length" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает общий ключ \f$ KEK \f$ по алгоритму VKO_GOSTR3410_2012_256 (если длина
+    ключа равна 32 октетам) или VKO_GOSTR3410_2012_512 (если длина ключа равна 64 октетам).
+
+    @param sctx контекст секретного ключа электронной подписи.
+    @param pctx контекст открытого ключа другого абонента; ключ должен принадлежать
+    той же эллиптической кривой, что и секретный ключ.
+    @param ukm указатель на случайное число \f$ UKM \f$ (последовательность октетов
+    в порядке little-endian).
+    @param ukm_size размер \f$ UKM \f$ в октетах; не должен превосходить длины порядка
+    подгруппы точек эллиптической кривой.
+    @param out область памяти, куда помещается общий ключ.
+    @param out_size длина общего ключа в октетах (32 или 64).
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_vko( ak_signkey sctx, ak_verifykey pctx, const ak_pointer ukm,
+                                   const size_t ukm_size, ak_pointer out, const size_t out_size )
+{
+  ak_mpzn512 t;
+  struct hash ctx;
+  struct wpoint wk;
+  int error = ak_error_ok;
+  ak_wcurve wc = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to secret key context" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                        "using null pointer to shared key buffer" );
+  if(( sctx->key.flags&ak_key_flag_set_key ) == 0 ) return ak_error_message( ak_error_key_value,
+                                        __func__ , "using secret key with unassigned value" );
+  if(( error = ak_signkey_vko_check( sctx, pctx )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "using wrong public key" );
+  if(( error = ak_signkey_vko_create_hash( &ctx, out_size )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "incorrect creation of hash function context" );
+
+  wc = ( ak_wcurve ) sctx->key.data;
+  if(( error = ak_signkey_vko_scalar( sctx, ukm, ukm_size, t )) != ak_error_ok )
+    ak_error_message( error, __func__ , "incorrect calculation of secret scalar" );
+   else {
+     ak_signkey_vko_pow( &wk, &pctx->qpoint, t, wc );
+     ak_wpoint_reduce( &wk, wc );
+     error = ak_signkey_vko_export( sctx, &wk, &ctx, out, out_size );
+   }
+
+  ak_ptr_wipe( t, sizeof( ak_mpzn512 ), &sctx->key.generator );
+  ak_ptr_wipe( &wk, sizeof( struct wpoint ), &sctx->key.generator );
+  ak_hash_destroy( &ctx );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает общие ключи секретного ключа `sctx` с открытыми ключами, заданными
+    в массиве заданий. Для каждого задания должны быть определены открытый ключ, \f$ UKM \f$
+    и буффер для общего ключа; результат выполнения задания помещается в поле `error`.
+
+    В отличие от последовательного вызова функции ak_signkey_vko(), приведение общих точек
+    к аффинной форме выполняется блоками с помощью функции ak_wpoint_reduce_batch(), то есть
+    с одним обращением элемента конечного поля на блок заданий.
+
+    @param sctx контекст секретного ключа электронной подписи.
+    @param tasks массив заданий.
+    @param count количество заданий.
+    @return Функция возвращает \ref ak_error_ok, если все общие ключи выработаны. В противном
+    случае возвращается код ошибки первого невыполненного задания.                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_signkey_vko_batch( ak_signkey sctx, ak_vko_task tasks, const size_t count )
+{
+  ak_mpzn512 t;
+  struct hash ctx256, ctx512;
+  struct wpoint wk[ak_signkey_vko_batch_block];
+  size_t idx = 0, first = 0, len = 0;
+  int error = ak_error_ok;
+  ak_wcurve wc = NULL;
+
+  if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to secret key context" );
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                              "using null pointer to tasks array" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                 "using empty array of tasks" );
+  if(( sctx->key.flags&ak_key_flag_set_key ) == 0 ) return ak_error_message( ak_error_key_value,
+                                        __func__ , "using secret key with unassigned value" );
+  if(( error = ak_hash_create_streebog256( &ctx256 )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "incorrect creation of hash function context" );
+  if(( error = ak_hash_create_streebog512( &ctx512 )) != ak_error_ok ) {
+    ak_hash_destroy( &ctx256 );
+    return ak_error_message( error, __func__ , "incorrect creation of hash function context" );
+  }
+
+  wc = ( ak_wcurve ) sctx->key.data;
+  for( first = 0; first < count; first += len ) {
+     len = ak_min( count - first, ak_signkey_vko_batch_block );
+
+    /* вычисляем общие точки в проективной форме */
+     for( idx = 0; idx < len; idx++ ) {
+        ak_vko_task task = tasks + first + idx;
+        ak_wpoint_set_as_unit( wk+idx, wc );
+        if( task->out == NULL ) {
+          task->error = ak_error_message( ak_error_null_pointer, __func__ ,
+                                                        "using null pointer to shared key buffer" );
+          continue;
+        }
+        if(( task->out_size != 32 ) && ( task->out_size != 64 )) {
+          task->error = ak_error_message( ak_error_wrong_length, __func__ ,
+                                                        "using shared key with unexpected length" );
+          continue;
+        }
+        if(( task->error = ak_signkey_vko_check( sctx, task->key )) != ak_error_ok ) continue;
+        if(( task->error = ak_signkey_vko_scalar( sctx, task->ukm, task->ukm_size, t ))
+                                                                          != ak_error_ok ) continue;
+        ak_signkey_vko_pow( wk+idx, &task->key->qpoint, t, wc );
+     }
+
+    /* одно обращение на блок */
+     if(( error = ak_wpoint_reduce_batch( wk, len, wc )) != ak_error_ok ) {
+       ak_error_message( error, __func__ , "incorrect reduction of shared points" );
+       break;
+     }
+     for( idx = 0; idx < len; idx++ ) {
+        ak_vko_task task = tasks + first + idx;
+        if( task->error != ak_error_ok ) continue;
+        task->error = ak_signkey_vko_export( sctx, wk+idx,
+                         task->out_size == 32 ? &ctx256 : &ctx512, task->out, task->out_size );
+     }
+  }
+
+  ak_ptr_wipe( t, sizeof( ak_mpzn512 ), &sctx->key.generator );
+  ak_ptr_wipe( wk, sizeof( wk ), &sctx->key.generator );
+  ak_hash_destroy( &ctx512 );
+  ak_hash_destroy( &ctx256 );
+  if( error != ak_error_ok ) return error;
+
+  for( idx = 0; idx < count; idx++ )
+     if( tasks[idx].error != ak_error_ok ) return tasks[idx].error;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                    функции тестирования                                         */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет выработку общего ключа для двух абонентов на заданной кривой:
+    общие ключи, выработанные каждым из абонентов, должны совпадать, общие ключи,
+    выработанные в пакетном режиме, должны совпадать с ключами, выработанными по одному,
+    а изменение \f$ UKM \f$ должно приводить к изменению общего ключа. Для кривых, имеющих
+    эквивалентную форму Эдвардса, открытые ключи, содержащие точку второго порядка,
+    должны отвергаться.                                                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_test_vko_curve( ak_wcurve wc, ak_random generator )
+{
+  size_t i = 0;
+  bool_t result = ak_false;
+  int error = ak_error_ok;
+  struct signkey ska, skb;
+  struct verifykey pka, pkb;
+  struct vko_task tasks[3];
+  ak_uint8 ukm[8] = { 0x1d, 0x80, 0x60, 0x3c, 0x85, 0x44, 0xc7, 0x27 }, ukm2[8];
+  ak_uint8 kek[6][64];
+
+  if(( error = ak_signkey_create( &ska, wc )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of secret key context" );
+    return ak_false;
+  }
+  if(( error = ak_signkey_create( &skb, wc )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of secret key context" );
+    ak_signkey_destroy( &ska );
+    return ak_false;
+  }
+  if((( error = ak_signkey_set_key_random( &ska, generator )) != ak_error_ok ) ||
+     (( error = ak_signkey_set_key_random( &skb, generator )) != ak_error_ok )) {
+    ak_error_message( error, __func__ , "incorrect assigning a secret key value" );
+    goto labexit;
+  }
+  if(( error = ak_verifykey_create_from_signkey( &pka, &ska )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of public key value" );
+    goto labexit;
+  }
+  if(( error = ak_verifykey_create_from_signkey( &pkb, &skb )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of public key value" );
+    ak_verifykey_destroy( &pka );
+    goto labexit;
+  }
+
+ /* общие ключи, выработанные каждым из абонентов */
+  memset( kek, 0, sizeof( kek ));
+  ak_signkey_vko( &ska, &pkb, ukm, sizeof( ukm ), kek[0], 32 );
+  ak_signkey_vko( &skb, &pka, ukm, sizeof( ukm ), kek[1], 32 );
+  ak_signkey_vko( &ska, &pkb, ukm, sizeof( ukm ), kek[2], 64 );
+  ak_signkey_vko( &skb, &pka, ukm, sizeof( ukm ), kek[3], 64 );
+  if( !ak_ptr_is_equal( kek[0], kek[1], 32 ) || !ak_ptr_is_equal( kek[2], kek[3], 64 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ , "different shared keys for two parties" );
+    goto labexit1;
+  }
+
+ /* пакетный режим */
+  memcpy( ukm2, ukm, sizeof( ukm ));
+  ukm2[0] ^= 0x01;
+  for( i = 0; i < 3; i++ ) {
+     tasks[i].key = &pkb;
+     tasks[i].ukm = ( i == 2 ) ? ukm2 : ukm;
+     tasks[i].ukm_size = sizeof( ukm );
+     tasks[i].out = kek[4] + 32*( i >> 1 );
+     tasks[i].out_size = 32;
+  }
+  tasks[1].out = kek[5];
+  tasks[1].out_size = 64;
+  if(( error = ak_signkey_vko_batch( &ska, tasks, 3 )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect batch generation of shared keys" );
+    goto labexit1;
+  }
+  if( !ak_ptr_is_equal( kek[4], kek[0], 32 ) || !ak_ptr_is_equal( kek[5], kek[2], 64 ) ||
+                                                      ak_ptr_is_equal( kek[4]+32, kek[0], 32 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ , "wrong batch generation of shared keys" );
+    goto labexit1;
+  }
+
+ /* точка T = (t, 0) второго порядка и сумма открытого ключа с ней не принадлежат подгруппе */
+  if( wc->ecurve != NULL ) {
+    struct wpoint wq, wt;
+    ak_uint64 one[ak_mpzn512_size] = ak_mpzn512_one;
+
+    wc->mul( wt.x, ( ak_uint64 *)wc->ecurve->t, one, wc->p, wc->n, wc->size );
+    ak_mpzn_set_ui( wt.y, wc->size, 0 );
+    ak_mpzn_set_ui( wt.z, wc->size, 1 );
+    ak_wpoint_set_wpoint( &wq, &pkb.qpoint, wc );
+    for( i = 0; i < 2; i++ ) {
+       if( i ) ak_wpoint_add( &pkb.qpoint, &wt, wc );
+        else ak_wpoint_set_wpoint( &pkb.qpoint, &wt, wc );
+       ak_wpoint_reduce( &pkb.qpoint, wc );
+       if(( ak_signkey_vko( &ska, &pkb, ukm, sizeof( ukm ), kek[0], 32 )
+                                                              != ak_error_curve_point_order ) ||
+          ( ak_signkey_vko_batch( &ska, tasks, 1 ) != ak_error_curve_point_order )) {
+         ak_error_message( ak_error_curve_point_order, __func__ ,
+                                          "public key outside of the subgroup is accepted" );
+         goto labexit1;
+       }
+       ak_wpoint_set_wpoint( &pkb.qpoint, &wq, wc );
+    }
+    ak_error_set_value( ak_error_ok );
+  }
+  result = ak_true;
+
+ labexit1:
+  ak_verifykey_destroy( &pkb );
+  ak_verifykey_destroy( &pka );
+ labexit:
+  ak_signkey_destroy( &skb );
+  ak_signkey_destroy( &ska );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет выработку общего ключа на контрольном примере из приложения A.2
+    рекомендаций Р 50.1.113-2016 (RFC 7836, кривая id-tc26-gost-3410-2012-512-paramSetA):
+    проверяются открытые ключи обоих абонентов, а также общие ключи длины 32 и 64 октета.       */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_signkey_test_vko_rfc7836( void )
+{
+  bool_t result = ak_false;
+  int error = ak_error_ok;
+  struct signkey ska, skb;
+  struct verifykey pka, pkb;
+  ak_uint8 kek[2][64];
+  ak_wcurve wc = ( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA;
+
+ /* секретные ключи абонентов (последовательности октетов в порядке little-endian) */
+  ak_uint8 keya[64] = {
+   0xc9, 0x90, 0xec, 0xd9, 0x72, 0xfc, 0xe8, 0x4e, 0xc4, 0xdb, 0x02, 0x27, 0x78, 0xf5, 0x0f, 0xca,
+   0xc7, 0x26, 0xf4, 0x67, 0x08, 0x38, 0x4b, 0x8d, 0x45, 0x83, 0x04, 0x96, 0x2d, 0x71, 0x47, 0xf8,
+   0xc2, 0xdb, 0x41, 0xce, 0xf2, 0x2c, 0x90, 0xb1, 0x02, 0xf2, 0x96, 0x84, 0x04, 0xf9, 0xb9, 0xbe,
+   0x6d, 0x47, 0xc7, 0x96, 0x92, 0xd8, 0x18, 0x26, 0xb3, 0x2b, 0x8d, 0xac, 0xa4, 0x3c, 0xb6, 0x67 };
+  ak_uint8 keyb[64] = {
+   0x48, 0xc8, 0x59, 0xf7, 0xb6, 0xf1, 0x15, 0x85, 0x88, 0x7c, 0xc0, 0x5e, 0xc6, 0xef, 0x13, 0x90,
+   0xcf, 0xea, 0x73, 0x9b, 0x1a, 0x18, 0xc0, 0xd4, 0x66, 0x22, 0x93, 0xef, 0x63, 0xb7, 0x9e, 0x3b,
+   0x80, 0x14, 0x07, 0x0b, 0x44, 0x91, 0x85, 0x90, 0xb4, 0xb9, 0x96, 0xac, 0xfe, 0xa4, 0xed, 0xfb,
+   0xbb, 0xcc, 0xcc, 0x8c, 0x06, 0xed, 0xd8, 0xbf, 0x5b, 0xda, 0x92, 0xa5, 0x13, 0x92, 0xd0, 0xdb };
+
+ /* открытые ключи абонентов */
+  ak_mpzn512 pkeyax =
+    { 0x2021FFABA4EDB0AALL, 0x6655A8B99F79188DLL, 0x0CA1EB703078BA54LL, 0xF5DC56EC53B2ABB9LL,
+      0xE664E49261BACCD3LL, 0x2F7937A1DEB6BCE5LL, 0x3C1BEB97C8F63124LL, 0xA7C0ADB12743C10CLL };
+  ak_mpzn512 pkeyay =
+    { 0x3A364E07A3134691LL, 0x9763358DD304B2EDLL, 0xB19D8C878E75D81BLL, 0x382D00481B720314LL,
+      0x92EA402D47921F46LL, 0x75934CFA0F8C95F9LL, 0x0BBEFD897FB90164LL, 0x5ADB1C63A4E4465ELL };
+  ak_mpzn512 pkeybx =
+    { 0x073A71B983E12F19LL, 0x2EDE35872CC75372LL, 0x7831EA66BC3D2AA4LL, 0x5ECD2325A35FB638LL,
+      0xF463C8A7ED74A9FCLL, 0x5CB2F2F147114D95LL, 0xE87591121CCE5F39LL, 0x51A6D54EE932D176LL };
+  ak_mpzn512 pkeyby =
+    { 0x2E599B4C413B8804LL, 0xB6D0076F8284DCC4LL, 0x8CE46C17DA6D00D9LL, 0x3BE002D1973F1E39LL,
+      0x458A222A13BF98B5LL, 0x4A52FC08BA1A20F7LL, 0x22B02A363AE4772DLL, 0x793BDE5BF72840ADLL };
+
+ /* случайное число UKM и общие ключи KEK_VKO длины 32 и 64 октета */
+  ak_uint8 ukm[8] = { 0x1d, 0x80, 0x60, 0x3c, 0x85, 0x44, 0xc7, 0x27 };
+  ak_uint8 kek256[32] = {
+   0xc9, 0xa9, 0xa7, 0x73, 0x20, 0xe2, 0xcc, 0x55, 0x9e, 0xd7, 0x2d, 0xce, 0x6f, 0x47, 0xe2, 0x19,
+   0x2c, 0xce, 0xa9, 0x5f, 0xa6, 0x48, 0x67, 0x05, 0x82, 0xc0, 0x54, 0xc0, 0xef, 0x36, 0xc2, 0x21 };
+  ak_uint8 kek512[64] = {
+   0x79, 0xf0, 0x02, 0xa9, 0x69, 0x40, 0xce, 0x7b, 0xde, 0x32, 0x59, 0xa5, 0x2e, 0x01, 0x52, 0x97,
+   0xad, 0xaa, 0xd8, 0x45, 0x97, 0xa0, 0xd2, 0x05, 0xb5, 0x0e, 0x3e, 0x17, 0x19, 0xf9, 0x7b, 0xfa,
+   0x7e, 0xe1, 0xd2, 0x66, 0x1f, 0xa9, 0x97, 0x9a, 0x5a, 0xa2, 0x35, 0xb5, 0x58, 0xa7, 0xe6, 0xd9,
+   0xf8, 0x8f, 0x98, 0x2d, 0xd6, 0x3f, 0xc3, 0x5a, 0x8e, 0xc0, 0xdd, 0x5e, 0x24, 0x2d, 0x3b, 0xdf };
+
+  if(( error = ak_signkey_create( &ska, wc )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of secret key context" );
+    return ak_false;
+  }
+  if(( error = ak_signkey_create( &skb, wc )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of secret key context" );
+    ak_signkey_destroy( &ska );
+    return ak_false;
+  }
+  if((( error = ak_signkey_set_key( &ska, keya, sizeof( keya ))) != ak_error_ok ) ||
+     (( error = ak_signkey_set_key( &skb, keyb, sizeof( keyb ))) != ak_error_ok )) {
+    ak_error_message( error, __func__ , "incorrect assigning a constant key value" );
+    goto labexit;
+  }
+  if(( error = ak_verifykey_create_from_signkey( &pka, &ska )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of public key value" );
+    goto labexit;
+  }
+  if(( error = ak_verifykey_create_from_signkey( &pkb, &skb )) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "incorrect creation of public key value" );
+    ak_verifykey_destroy( &pka );
+    goto labexit;
+  }
+
+ /* проверяем открытые ключи */
+  if( ak_mpzn_cmp( pka.qpoint.x, pkeyax, wc->size ) ||
+      ak_mpzn_cmp( pka.qpoint.y, pkeyay, wc->size ) ||
+      ak_mpzn_cmp( pkb.qpoint.x, pkeybx, wc->size ) ||
+      ak_mpzn_cmp( pkb.qpoint.y, pkeyby, wc->size )) {
+    ak_error_message( ak_error_not_equal_data, __func__ , "wrong public keys from RFC 7836" );
+    goto labexit1;
+  }
+
+ /* проверяем общие ключи */
+  memset( kek, 0, sizeof( kek ));
+  ak_signkey_vko( &ska, &pkb, ukm, sizeof( ukm ), kek[0], 32 );
+  ak_signkey_vko( &skb, &pka, ukm, sizeof( ukm ), kek[1], 64 );
+  if( !ak_ptr_is_equal_with_log( kek[0], kek256, 32 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                             "wrong VKO_GOSTR3410_2012_256 key from RFC 7836" );
+    goto labexit1;
+  }
+  if( !ak_ptr_is_equal_with_log( kek[1], kek512, 64 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                             "wrong VKO_GOSTR3410_2012_512 key from RFC 7836" );
+    goto labexit1;
+  }
+  result = ak_true;
+
+ labexit1:
+  ak_verifykey_destroy( &pkb );
+  ak_verifykey_destroy( &pka );
+ labexit:
+  ak_signkey_destroy( &skb );
+  ak_signkey_destroy( &ska );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @return Функция возвращает истину только в том случае, когда будут пройдены все тесты.
+    В противном случае возвращается ложь.                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_test_vko( void )
+{
+  struct random generator;
+  int error = ak_error_ok, audit = ak_log_get_level();
+  bool_t result = ak_true;
+
+  if( audit >= ak_log_maximum )
+    ak_error_message( ak_error_ok, __func__ , "testing key agreement started" );
+  if(( error = ak_random_create_lcg( &generator )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect creation of random generator" );
+    return ak_false;
+  }
+
+ /* контрольный пример из RFC 7836 */
+  if( !ak_signkey_test_vko_rfc7836( )) {
+    ak_error_message( ak_error_get_value(), __func__ , "key agreement VKO from RFC 7836 is wrong" );
+    ak_random_destroy( &generator );
+    return ak_false;
+  } else
+      if( audit >= ak_log_maximum )
+        ak_error_message( ak_error_ok, __func__ , "key agreement VKO from RFC 7836 is Ok" );
+
+ /* кривая с кофактором 4 и кривая с кофактором 1 */
+  if( !ak_signkey_test_vko_curve(
+                         ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA, &generator ) ||
+      !ak_signkey_test_vko_curve(
+                         ( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA, &generator )) {
+    ak_error_message( ak_error_get_value(), __func__ , "key agreement VKO is wrong" );
+    result = ak_false;
+  } else
+      if( audit >= ak_log_maximum )
+        ak_error_message( ak_error_ok, __func__ , "key agreement VKO is Ok" );
+
+  ak_random_destroy( &generator );
+ return result;
+}
+
+/** @} */
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                       ak_vko.c  */
+/* ----------------------------------------------------------------------------------------------- */
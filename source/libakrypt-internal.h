@@ -10,6 +10,23 @@
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt.h>
 
+/* ----------------------------------------------------------------------------------------------- */
+/** \addtogroup options-doc
+ @{ */
+/*! \brief Определение расширений процессора и выбор реализаций вычислительных функций. */
+ int ak_libakrypt_init_cpu_features( void );
+/*! \brief Выбор реализаций умножения в конечных полях характеристики два. */
+ ak_uint32 ak_gf2n_set_functions( const ak_uint32 );
+/*! \brief Выбор реализаций умножения вычетов в представлении Монтгомери. */
+ ak_uint32 ak_mpzn_set_functions( const ak_uint32 );
+/*! \brief Максимальное количество потоков, между которыми распределяются вычисления. */
+ #define ak_libakrypt_threads_max  ( 256 )
+/*! \brief Количество потоков для обработки заданного количества независимых порций работы. */
+ size_t ak_libakrypt_get_threads_count( const size_t );
+/*! \brief Выполнение порций работы в отдельных потоках. */
+ void ak_libakrypt_run_threads( void *( * )( void * ), ak_pointer , const size_t , const size_t );
+/** @} */
+
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup mac-doc
  @{ */
@@ -74,6 +91,18 @@
  int ak_mac_file( ak_mac , const char* , ak_pointer , const size_t );
 /** @} */
 
+/** \addtogroup curves-doc
+ @{ */
+/*! \brief Уничтожение таблиц кратных точек, вычисленных для образующих точек кривых. */
+ void ak_wcurve_destroy_tables( void );
+/** @} */
+
+/** \addtogroup sign-doc
+ @{ */
+/*! \brief Уничтожение кеша таблиц кратных точек открытых ключей. */
+ void ak_verifykey_destroy_tables( void );
+/** @} */
+
 /** \addtogroup aead-doc
  @{ */
  #define ak_aead_assosiated_data_bit  (0x1)
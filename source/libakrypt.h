@@ -130,6 +130,14 @@ extern "C" {
 /*! \brief Функция выводит текущие значения всех опций библиотеки. */
  dll_export void ak_libakrypt_log_options( void );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Флаг наличия команды PCLMULQDQ (умножение многочленов над полем из двух элементов). */
+ #define ak_cpu_feature_clmul                  (0x01)
+/*! \brief Флаг наличия команд mulx, adcx и adox (расширения BMI2 и ADX). */
+ #define ak_cpu_feature_mulx                   (0x02)
+/*! \brief Функция возвращает маску расширений процессора, используемых библиотекой. */
+ dll_export ak_uint32 ak_libakrypt_get_cpu_features( void );
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция устанавливает режим совместимости криптографических преобразований с библиотекой openssl. */
  dll_export int ak_libakrypt_set_openssl_compability( bool_t );
@@ -163,6 +171,8 @@ extern "C" {
  dll_export bool_t ak_libakrypt_test_hmac_streebog( void );
 /*! \brief Тестирование алгоритма PBKDF2, регламентируемого Р 50.1.113-2016. */
  dll_export bool_t ak_libakrypt_test_pbkdf2( void );
+/*! \brief Тестирование алгоритма выработки производных ключей KDF_TREE (Р 50.1.113-2016). */
+ dll_export bool_t ak_libakrypt_test_kdf_tree( void );
 /*! \brief Функция тестирует корректность реализации блочных шифрова и режимов их использования. */
  dll_export bool_t ak_libakrypt_test_block_ciphers( void ); 
 /*! \brief Тестирование корректной работы алгоритма блочного шифрования Магма (ГОСТ Р 34.12-2015). */
@@ -174,10 +184,15 @@ extern "C" {
 /*! \brief Тестирование корректной работы режима блочного шифрования с одновременной
     выработкой имитовставки. */
  dll_export bool_t ak_libakrypt_test_mgm( void );
+/*! \brief Тестирование корректной работы защиты записей протокола TLS 1.3
+    с преобразованием ключей TLSTREE. */
+ dll_export bool_t ak_libakrypt_test_tlsrecord( void );
 /*! \brief Тестирование корректной работы режима шифрования `ACPKM`, регламентируемого Р 1323565.1.017—2018. */
  dll_export bool_t ak_libakrypt_test_acpkm( void );
 /*! \brief Выполнение тестовых примеров для алгоритмов выработки и проверки электронной подписи */
  dll_export bool_t ak_libakrypt_test_sign( void );
+/*! \brief Тестирование алгоритма выработки общего ключа VKO (Р 50.1.113-2016). */
+ dll_export bool_t ak_libakrypt_test_vko( void );
 
 /** @}*//** @}*/
 
@@ -946,6 +961,59 @@ extern "C" {
 /*! \brief Развертка ключевого вектора из пароля (согласно Р 50.1.111-2016, раздел 4) */
  dll_export int ak_hmac_pbkdf2_streebog512( const ak_pointer , const size_t ,
                    const ak_pointer , const size_t, const size_t , const size_t , ak_pointer );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание для пакетной выработки ключевых векторов из паролей. */
+ typedef struct pbkdf2_task {
+  /*! \brief Пароль, строка символов в utf8 кодировке */
+   ak_pointer pass;
+  /*! \brief Размер пароля в байтах */
+   size_t pass_size;
+  /*! \brief Инициализационный вектор */
+   ak_pointer salt;
+  /*! \brief Размер инициализационного вектора в байтах */
+   size_t salt_size;
+  /*! \brief Количество итераций алгоритма */
+   size_t cnt;
+  /*! \brief Длина вырабатываемого ключевого вектора в байтах */
+   size_t dklen;
+  /*! \brief Указатель на область памяти, куда помещается результат */
+   ak_pointer out;
+  /*! \brief Код ошибки, возникшей при обработке задания */
+   int error;
+ } *ak_pbkdf2_task;
+
+/*! \brief Пакетная выработка ключевых векторов из паролей (согласно Р 50.1.111-2016, раздел 4) */
+ dll_export int ak_hmac_pbkdf2_streebog512_batch( ak_pbkdf2_task , const size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задание для выработки производного ключа с помощью алгоритма KDF_TREE. */
+ typedef struct kdf_tree_task {
+  /*! \brief Метка, определяющая назначение производного ключа */
+   ak_pointer label;
+  /*! \brief Длина метки в октетах */
+   size_t label_size;
+  /*! \brief Инициализационный вектор */
+   ak_pointer seed;
+  /*! \brief Длина инициализационного вектора в октетах */
+   size_t seed_size;
+  /*! \brief Длина производного ключа в октетах (нулевое значение - текущая длина ключа key) */
+   size_t size;
+  /*! \brief Общая длина выхода алгоритма в октетах (нулевое значение - длина производного ключа) */
+   size_t length;
+  /*! \brief Номер первого используемого блока выхода алгоритма (нулевое значение - первый блок) */
+   size_t first;
+  /*! \brief Созданный заранее ключ (\ref bckey или \ref hmac), которому присваивается значение */
+   ak_pointer key;
+  /*! \brief Код ошибки, возникшей при обработке задания */
+   int error;
+ } *ak_kdf_tree_task;
+
+/*! \brief Выработка производной ключевой информации (согласно Р 50.1.113-2016, раздел 4.5) */
+ dll_export int ak_hmac_kdf_tree( ak_hmac , const ak_pointer , const size_t ,
+                           const ak_pointer , const size_t , const size_t , ak_pointer , const size_t );
+/*! \brief Пакетная выработка производных ключей из одного родительского ключа (KDF_TREE). */
+ dll_export int ak_hmac_kdf_tree_batch( ak_hmac , const size_t , ak_kdf_tree_task , const size_t );
 /** @} */
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -993,6 +1061,85 @@ extern "C" {
  dll_export int ak_bckey_decrypt_ctr_hmac( ak_pointer , ak_pointer , const ak_pointer ,
     const size_t , const ak_pointer , ak_pointer , const size_t , const ak_pointer , const size_t ,
                                                                           ak_pointer, const size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Наборы алгоритмов защиты записей протокола TLS 1.3 (Р 1323565.1.030-2020). */
+ typedef enum {
+  /*! \brief Набор TLS_GOSTR341112_256_WITH_KUZNYECHIK_MGM_L. */
+   tls_kuznechik_mgm_l,
+  /*! \brief Набор TLS_GOSTR341112_256_WITH_MAGMA_MGM_L. */
+   tls_magma_mgm_l,
+  /*! \brief Набор TLS_GOSTR341112_256_WITH_KUZNYECHIK_MGM_S. */
+   tls_kuznechik_mgm_s,
+  /*! \brief Набор TLS_GOSTR341112_256_WITH_MAGMA_MGM_S. */
+   tls_magma_mgm_s
+} tls_suite_t;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Контекст защиты записей протокола TLS 1.3 с преобразованием ключей TLSTREE.
+    \details Контекст хранит ключи всех трех уровней преобразования TLSTREE вместе
+    со значениями номера записи, для которых они были выработаны. При переходе к следующей
+    записи заново вычисляются только те ключи, которые действительно изменились.               */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct tlsrecord {
+  /*! \brief Используемый набор алгоритмов. */
+   tls_suite_t suite;
+  /*! \brief Ключ K_root (write_key). */
+   struct hmac root;
+  /*! \brief Ключ первого уровня преобразования TLSTREE. */
+   struct hmac level1;
+  /*! \brief Ключ второго уровня преобразования TLSTREE. */
+   struct hmac level2;
+  /*! \brief Ключ записи (ключ третьего уровня преобразования TLSTREE). */
+   struct bckey key;
+  /*! \brief Константы C_1, C_2, C_3 преобразования TLSTREE. */
+   ak_uint64 mask[3];
+  /*! \brief Значения seqnum & C_j, для которых были выработаны ключи уровней. */
+   ak_uint64 cached[3];
+  /*! \brief Вектор write_iv (младший октет - первый). */
+   ak_uint8 iv[16];
+  /*! \brief Номер следующей обрабатываемой записи. */
+   ak_uint64 seqnum;
+  /*! \brief Флаг готовности кешированных ключей. */
+   bool_t ready;
+} *ak_tlsrecord;
+
+/*! \brief Описание одной записи при пакетной обработке. */
+ typedef struct tlsrecord_item {
+  /*! \brief Ассоциированные данные (заголовок записи). */
+   ak_pointer adata;
+  /*! \brief Длина ассоциированных данных в октетах. */
+   size_t adata_size;
+  /*! \brief Входные данные. */
+   ak_pointer in;
+  /*! \brief Область памяти для выходных данных. */
+   ak_pointer out;
+  /*! \brief Длина входных данных в октетах. */
+   size_t size;
+  /*! \brief Имитовставка. */
+   ak_pointer icode;
+  /*! \brief Результат обработки записи. */
+   int error;
+} *ak_tlsrecord_item;
+
+/*! \brief Создание контекста защиты записей по секрету протокола TLS 1.3. */
+ dll_export int ak_tlsrecord_create( ak_tlsrecord , tls_suite_t , const ak_pointer , const size_t );
+/*! \brief Уничтожение контекста защиты записей. */
+ dll_export int ak_tlsrecord_destroy( ak_tlsrecord );
+/*! \brief Установка номера следующей обрабатываемой записи. */
+ dll_export int ak_tlsrecord_set_seqnum( ak_tlsrecord , const ak_uint64 );
+/*! \brief Получение длины имитовставки. */
+ dll_export size_t ak_tlsrecord_get_tag_size( ak_tlsrecord );
+/*! \brief Зашифрование одной записи с выработкой имитовставки. */
+ dll_export int ak_tlsrecord_seal( ak_tlsrecord , const ak_pointer , const size_t ,
+                                      const ak_pointer , ak_pointer , const size_t , ak_pointer );
+/*! \brief Расшифрование одной записи с проверкой имитовставки. */
+ dll_export int ak_tlsrecord_open( ak_tlsrecord , const ak_pointer , const size_t ,
+                                      const ak_pointer , ak_pointer , const size_t , ak_pointer );
+/*! \brief Зашифрование массива записей с последовательными номерами. */
+ dll_export int ak_tlsrecord_seal_batch( ak_tlsrecord , ak_tlsrecord_item , const size_t );
+/*! \brief Расшифрование массива записей с последовательными номерами. */
+ dll_export int ak_tlsrecord_open_batch( ak_tlsrecord , ak_tlsrecord_item , const size_t );
 /** @} */
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1023,6 +1170,12 @@ extern "C" {
  typedef ak_uint64 ak_mpzn512[ ak_mpzn512_size ];
 /*! \brief Тип данных для хранения максимально возможного большого числа. */
  typedef ak_uint64 ak_mpznmax[ ak_mpznmax_size ];
+/*! \brief Функция умножения двух вычетов в представлении Монтгомери. */
+ typedef void ( ak_function_mpzn_mul_montgomery )( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Функция возведения вычета в квадрат в представлении Монтгомери. */
+ typedef void ( ak_function_mpzn_sqr_montgomery )( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Присвоение вычету другого вычета. */
@@ -1067,14 +1220,50 @@ extern "C" {
 /*! \brief Сложение двух вычетов в представлении Монтгомери. */
  dll_export void ak_mpzn_add_montgomery( ak_uint64 *, ak_uint64 *,
                                                          ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычитание двух вычетов в представлении Монтгомери. */
+ dll_export void ak_mpzn_sub_montgomery( ak_uint64 *, ak_uint64 *,
+                                                         ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Удвоение на двойку в представлении Монтгомери. */
  dll_export void ak_mpzn_lshift_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Умножение двух вычетов в представлении Монтгомери. */
  dll_export void ak_mpzn_mul_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                            ak_uint64 *, ak_uint64, const size_t );
-/*! \brief Модульное возведение в степень в представлении Монтгомери. */
+/*! \brief Умножение в представлении Монтгомери для вычетов длины 256 бит. */
+ dll_export void ak_mpzn_mul_montgomery_256( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение в представлении Монтгомери для вычетов длины 512 бит. */
+ dll_export void ak_mpzn_mul_montgomery_512( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение в квадрат в представлении Монтгомери для вычетов длины 256 бит. */
+ dll_export void ak_mpzn_sqr_montgomery_256( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение в квадрат в представлении Монтгомери для вычетов длины 512 бит. */
+ dll_export void ak_mpzn_sqr_montgomery_512( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение в представлении Монтгомери по модулю вида \f$ 2^{256} - c \f$. */
+ dll_export void ak_mpzn_mul_pseudo_mersenne_256( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение в представлении Монтгомери по модулю вида \f$ 2^{512} - c \f$. */
+ dll_export void ak_mpzn_mul_pseudo_mersenne_512( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение в квадрат в представлении Монтгомери по модулю вида \f$ 2^{256} - c \f$. */
+ dll_export void ak_mpzn_sqr_pseudo_mersenne_256( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение в квадрат в представлении Монтгомери по модулю вида \f$ 2^{512} - c \f$. */
+ dll_export void ak_mpzn_sqr_pseudo_mersenne_512( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Модульное возведение в степень в представлении Монтгомери
+    (время вычисления не зависит от данных). */
  dll_export void ak_mpzn_modpow_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                            ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Модульное возведение в степень в представлении Монтгомери
+    (только для открытых данных). */
+ dll_export void ak_mpzn_modpow_montgomery_vartime( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Вычисление обратного элемента по модулю (время вычисления не зависит от данных). */
+ dll_export void ak_mpzn_modinv( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычисление обратного элемента по модулю (только для открытых данных). */
+ dll_export void ak_mpzn_modinv_vartime( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_GMP_H
 /*! \brief Преобразование ak_mpznxxx в mpz_t. */
@@ -1123,6 +1312,8 @@ extern "C" {
  dll_export bool_t ak_wpoint_is_ok( ak_wpoint , ak_wcurve );
 /*! \brief Проверка порядка заданной точки. */
  dll_export bool_t ak_wpoint_check_order( ak_wpoint , ak_wcurve );
+/*! \brief Проверка принадлежности точки подгруппе порядка q с учетом кофактора кривой. */
+ dll_export bool_t ak_wpoint_check_subgroup( ak_wpoint , ak_wcurve );
 
 /*! \brief Удвоение точки эллиптической кривой, заданной в короткой форме Вейерштрасса. */
  dll_export void ak_wpoint_double( ak_wpoint , ak_wcurve );
@@ -1130,8 +1321,76 @@ extern "C" {
  dll_export void ak_wpoint_add( ak_wpoint , ak_wpoint , ak_wcurve );
 /*! \brief Приведение проективной точки к аффинному виду. */
  dll_export void ak_wpoint_reduce( ak_wpoint , ak_wcurve );
+/*! \brief Приведение проективной точки к аффинному виду (только для открытых данных). */
+ dll_export void ak_wpoint_reduce_vartime( ak_wpoint , ak_wcurve );
+/*! \brief Одновременное приведение массива проективных точек к аффинному виду. */
+ dll_export int ak_wpoint_reduce_batch( ak_wpoint , const size_t , ak_wcurve );
 /*! \brief Вычисление кратной точки эллиптической кривой. */
  dll_export void ak_wpoint_pow( ak_wpoint , ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление кратной точки подгруппы порядка q с помощью лесенки Монтгомери
+    в co-Z координатах. */
+ dll_export void ak_wpoint_pow_coz( ak_wpoint , ak_wpoint , ak_uint64 *, ak_wcurve );
+/*! \brief Вычисление кратной точки для образующей точки эллиптической кривой
+    с использованием заранее вычисленной таблицы. */
+ dll_export void ak_wpoint_pow_base( ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Таблица кратных точек, используемая для вычисления кратной точки с фиксированным
+    основанием.
+
+    Скаляр \f$ k \f$ разбивается на 4-х битные окна \f$ k = \sum_i k_i 16^i \f$, а таблица
+    содержит аффинные точки \f$ [j16^i]P \f$ для всех \f$ i \f$ и \f$ 1 \leq j \leq 15 \f$.
+    Тогда \f$ [k]P = \sum_i [k_i16^i]P \f$ вычисляется только с помощью сложений точек,
+    без удвоений.                                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct wpoint_table {
+  /*! \brief Точка \f$ P \f$, для которой вычислена таблица. */
+   struct wpoint point;
+  /*! \brief Координаты \f$ x, y \f$ кратных точек (по 15 точек для каждого окна); для кривых,
+      имеющих эквивалентную форму Эдвардса, - координаты \f$ u, v, duv \f$ точек кривой Эдвардса. */
+   ak_uint64 *data;
+  /*! \brief Количество окон. */
+   size_t count;
+  /*! \brief Размер координат точек, исчисляемый количеством 64-х битных блоков. */
+   size_t size;
+} *ak_wpoint_table;
+
+/*! \brief Вычисление таблицы кратных точек для заданной точки эллиптической кривой. */
+ dll_export int ak_wpoint_table_create( ak_wpoint_table , ak_wpoint , ak_wcurve );
+/*! \brief Уничтожение таблицы кратных точек. */
+ dll_export int ak_wpoint_table_destroy( ak_wpoint_table );
+/*! \brief Вычисление кратной точки с использованием таблицы кратных точек. */
+ dll_export void ak_wpoint_table_pow( ak_wpoint , ak_wpoint_table , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление суммы кратных точек \f$ [k_1]P + [k_2]R \f$ для образующей точки \f$ P \f$
+    (время выполнения зависит от скаляров). */
+ dll_export void ak_wpoint_double_pow( ak_wpoint , ak_uint64 *, ak_wpoint , ak_uint64 *,
+                                                                          size_t , ak_wcurve );
+/*! \brief Вычисление суммы кратных точек \f$ [k_1]P + [k_2]R \f$ с использованием таблицы
+    кратных точек для точки \f$ R \f$ (время выполнения зависит от скаляров). */
+ dll_export void ak_wpoint_double_pow_table( ak_wpoint , ak_uint64 *, ak_wpoint_table ,
+                                                              ak_uint64 *, size_t , ak_wcurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Параметры кривой в искривленной форме Эдвардса, бирационально эквивалентной
+    кривой в короткой форме Вейерштрасса.
+
+    Кривая Эдвардса задается сравнением \f$ eu^2 + v^2 \equiv 1 + du^2v^2 \pmod{p} \f$, где
+    \f$ e = 1 \f$ (это условие выполнено для всех кривых из Р 1323565.1.024-2019).
+    Точки кривых связаны соотношениями
+    \f$ u = \frac{x-t}{y},\ v = \frac{x-t-s}{x-t+s} \f$ и
+    \f$ x = \frac{s(1+v)}{1-v} + t,\ y = \frac{s(1+v)}{(1-v)u} \f$,
+    где \f$ s = \frac{e-d}{4},\ t = \frac{e+d}{6} \f$. Все величины хранятся
+    в представлении Монтгомери.                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ struct ecurve
+{
+ /*! \brief Коэффициент \f$ d \f$ кривой Эдвардса. */
+  ak_uint64 d[ak_mpzn512_size];
+ /*! \brief Величина \f$ s = (e-d)/4 \f$. */
+  ak_uint64 s[ak_mpzn512_size];
+ /*! \brief Величина \f$ t = (e+d)/6 \f$. */
+  ak_uint64 t[ak_mpzn512_size];
+};
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Класс, реализующий эллиптическую кривую, заданную в короткой форме Вейерштрасса
@@ -1176,6 +1435,24 @@ extern "C" {
  /*! \brief Строка, содержащая символьную запись модуля \f$ p \f$.
      \details Используется для проверки корректного хранения параметров кривой в памяти. */
   const char *pchar;
+ /*! \brief Функция умножения вычетов по модулю \f$ p \f$ в представлении Монтгомери,
+     специализированная для длины параметров кривой. */
+  ak_function_mpzn_mul_montgomery *mul;
+ /*! \brief Функция возведения в квадрат вычетов по модулю \f$ p \f$ в представлении Монтгомери,
+     специализированная для длины параметров кривой. */
+  ak_function_mpzn_sqr_montgomery *sqr;
+ /*! \brief Признак того, что коэффициент \f$ a \f$ сравним с \f$ -3 \f$ по модулю \f$ p \f$.
+     \details Для таких кривых удвоение точки в координатах Якоби выполняется
+     с помощью специализированных формул. */
+  bool_t a_is_minus_three;
+ /*! \brief Параметры эквивалентной кривой в форме Эдвардса, через которую выполняется
+     вычисление кратных точек (NULL, если такая кривая не задана). */
+  const struct ecurve *ecurve;
+ /*! \brief Функция умножения вычетов по модулю \f$ q \f$ в представлении Монтгомери,
+     специализированная для длины параметров кривой.
+     \details Вместе с величинами \f$ q \f$, \f$ r^2 \pmod{q} \f$ и \f$ n_q \f$ образует контекст,
+     используемый для приведения вычетов по модулю \f$ q \f$ (см. ak_wcurve_rem_q()). */
+  ak_function_mpzn_mul_montgomery *mulq;
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1185,6 +1462,10 @@ extern "C" {
  dll_export int ak_wcurve_discriminant_is_ok( ak_wcurve );
 /*! \brief Проверка корректности параметров, необходимых для вычисления по модулю q. */
  dll_export int ak_wcurve_check_order_parameters( ak_wcurve );
+/*! \brief Приведение значения по модулю q. */
+ dll_export void ak_wcurve_rem_q( ak_uint64 *, ak_uint64 *, ak_wcurve );
+/*! \brief Приведение значения по модулю q с переводом в представление Монтгомери. */
+ dll_export void ak_wcurve_rem_q_montgomery( ak_uint64 *, ak_uint64 *, ak_wcurve );
 /*! \brief Проверка набора параметров эллиптической кривой, заданной в форме Вейерштрасса. */
  dll_export int ak_wcurve_is_ok( ak_wcurve );
 
@@ -1249,24 +1530,62 @@ extern "C" {
  dll_export void ak_gf256_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b );
 /*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$. */
  dll_export void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b );
-
- #define ak_gf64_mul ak_gf64_mul_pcmulqdq
- #define ak_gf128_mul ak_gf128_mul_pcmulqdq
- #define ak_gf256_mul ak_gf256_mul_pcmulqdq
- #define ak_gf512_mul ak_gf512_mul_pcmulqdq
-#else
-
- #define ak_gf64_mul ak_gf64_mul_uint64
- #define ak_gf128_mul ak_gf128_mul_uint64
- #define ak_gf256_mul ak_gf256_mul_uint64
- #define ak_gf512_mul ak_gf512_mul_uint64
 #endif
 
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{64}}\f$ с помощью реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf64_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{128}}\f$ с помощью реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf128_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{256}}\f$ с помощью реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf256_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$ с помощью реализации,
+    выбранной при инициализации библиотеки. */
+ dll_export void ak_gf512_mul( ak_pointer z, ak_pointer x, ak_pointer y );
+
 /* Размеры конечных полей (в октетах) */
  #define ak_galois64_size               (8)
  #define ak_galois128_size             (16)
  #define ak_galois256_size             (32)
  #define ak_galois512_size             (64)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{64}}\f$ оконным методом. */
+ dll_export void ak_gf64_mul_window( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{128}}\f$ оконным методом. */
+ dll_export void ak_gf128_mul_window( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{256}}\f$ оконным методом. */
+ dll_export void ak_gf256_mul_window( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$ оконным методом. */
+ dll_export void ak_gf512_mul_window( ak_pointer z, ak_pointer x, ak_pointer y );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Таблица кратных значений фиксированного множителя в конечном поле характеристики два.
+    \details Таблица используется в случаях, когда один и тот же элемент поля последовательно
+    умножается на большое количество других элементов (например, при вычислении значений
+    многочлена по схеме Горнера). Для каждого многочлена \f$ i(x) \f$, степень которого меньше
+    ширины окна, в таблице хранится произведение \f$ i(x)h(x) \f$, где \f$ h(x) \f$ --
+    фиксированный множитель; умножение на произвольный элемент поля выполняется за
+    \f$ n/w \f$ шагов, где \f$ w \f$ -- ширина окна (метод Шоупа).                            */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct gf2n_table {
+  /*! \brief Фиксированный множитель */
+   ak_uint64 h[8];
+  /*! \brief Произведения фиксированного множителя на все многочлены степени меньше ширины окна */
+   ak_uint64 t[256*8];
+  /*! \brief Количество 64-х битных слов в элементе поля */
+   size_t n;
+  /*! \brief Ширина окна в битах (4 или 8); нулевое значение означает, что таблица
+      не вычислялась и умножение выполняется функцией, выбранной при инициализации библиотеки */
+   size_t window;
+ } *ak_gf2n_table;
+
+/*! \brief Вычисление таблицы кратных значений фиксированного множителя. */
+ dll_export int ak_gf2n_table_create( ak_gf2n_table , const ak_pointer , const size_t , const size_t );
+/*! \brief Умножение элемента поля на фиксированный множитель с помощью таблицы. */
+ dll_export void ak_gf2n_table_mul( ak_gf2n_table , ak_pointer , const ak_pointer );
 /** @} *//** @} */
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1604,6 +1923,23 @@ extern "C" {
    использующего вычисления с эллиптическими кривыми в короткой форме Вейерштрасса, либо
    в искривленной форме Эдвардса. Кривые указанных форм поддерживаются отечественными
    рекомендациями Р 1323565.024-2019.                                                              */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул заранее вычисленных значений, используемых для выработки электронной подписи. */
+ typedef struct signkey_pool *ak_signkey_pool;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Способ выработки значения \f$ k \f$, используемого при выработке электронной подписи. */
+ typedef enum {
+  /*! \brief Значение вырабатывается генератором случайных чисел (по-умолчанию). */
+   signkey_nonce_random,
+  /*! \brief Значение детерминированно вырабатывается из секретного ключа и хеш-кода
+      подписываемого сообщения с помощью HMAC-Стрибог (по аналогии с RFC 6979). */
+   signkey_nonce_deterministic,
+  /*! \brief Детерминированная выработка, дополненная однократно считанной
+      из генератора случайной последовательностью. */
+   signkey_nonce_hedged
+} signkey_nonce_t;
+
 /* ----------------------------------------------------------------------------------------------- */
  typedef struct signkey {
  /*! \brief контекст секретного ключа */
@@ -1612,6 +1948,13 @@ extern "C" {
   struct hash ctx;
  /*! \brief номер открытого ключа, выработанного из данного секретного ключа. */
   ak_uint8 verifykey_number[32];
+ /*! \brief пул заранее вычисленных пар (k, r); по-умолчанию пул не создается. */
+  ak_signkey_pool pool;
+ /*! \brief способ выработки значения k; по-умолчанию используется генератор случайных чисел. */
+  signkey_nonce_t nonce;
+ /*! \brief случайная последовательность, подмешиваемая при выработке значения k
+     в режиме \ref signkey_nonce_hedged. */
+  ak_uint8 nonce_entropy[64];
 } *ak_signkey;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1645,6 +1988,16 @@ extern "C" {
  dll_export int ak_signkey_destroy( ak_signkey );
 /*! \brief Размер области памяти, которую занимает электронная подпись. */
  dll_export size_t ak_signkey_get_tag_size( ak_signkey );
+/*! \brief Создание пула заранее вычисленных значений для выработки электронной подписи. */
+ dll_export int ak_signkey_pool_create( ak_signkey , ak_random , const size_t );
+/*! \brief Пополнение пула заранее вычисленных значений. */
+ dll_export int ak_signkey_pool_refill( ak_signkey );
+/*! \brief Количество пар значений, доступных в пуле. */
+ dll_export size_t ak_signkey_pool_get_count( ak_signkey );
+/*! \brief Уничтожение пула заранее вычисленных значений. */
+ dll_export int ak_signkey_pool_destroy( ak_signkey );
+/*! \brief Выбор способа выработки значения k при формировании электронной подписи. */
+ dll_export int ak_signkey_set_nonce( ak_signkey , signkey_nonce_t , ak_random );
 /*! \brief Присвоение секретному ключу электронной подписи константного значения. */
  dll_export int ak_signkey_set_key( ak_signkey , const ak_pointer , const size_t );
 /*! \brief Присвоение секретному ключу электронной подписи случайного значения. */
@@ -1688,6 +2041,9 @@ extern "C" {
   ak_tlv name;
  /*! \brief флаги состояния ключа */
   ak_uint64 flags;
+ /*! \brief таблица кратных точек открытого ключа (вычисляется функцией
+     ak_verifykey_precompute() и используется при проверке подписи) */
+  ak_wpoint_table qtable;
 } *ak_verifykey;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1772,6 +2128,10 @@ extern "C" {
  dll_export int ak_verifykey_add_name_string( ak_verifykey , const char * , const char * );
 /*! \brief Уничтожение контекста открытого ключа. */
  dll_export int ak_verifykey_destroy( ak_verifykey );
+/*! \brief Вычисление таблицы кратных точек открытого ключа для ускорения проверки подписи. */
+ dll_export int ak_verifykey_precompute( ak_verifykey );
+/*! \brief Проверка принадлежности открытого ключа подгруппе порядка q с кешированием результата. */
+ dll_export int ak_verifykey_check_point( ak_verifykey );
 /** \addtogroup cert-export-doc Функции экспорта и импорта открытых ключей
  @{ */
 /*! \brief Функция экспортирует открытый ключ асиметричного криптографического алгоритма
@@ -1830,6 +2190,42 @@ extern "C" {
 /*! \brief Проверка электронной подписи для вычисленного заранее значения хеш-функции. */
  dll_export bool_t ak_verifykey_verify_hash( ak_verifykey , const ak_pointer ,
                                                                        const size_t , ak_pointer );
+/*! \brief Задание для пакетной проверки электронной подписи. */
+ typedef struct verifykey_task {
+  /*! \brief Открытый ключ, с помощью которого проверяется подпись. */
+   ak_verifykey key;
+  /*! \brief Хеш-код сообщения. */
+   ak_pointer hash;
+  /*! \brief Размер хеш-кода (в байтах). */
+   size_t hash_size;
+  /*! \brief Проверяемая электронная подпись. */
+   ak_pointer sign;
+  /*! \brief Результат проверки: истина, если подпись верна. */
+   bool_t result;
+  /*! \brief Код ошибки, возникшей при проверке подписи. */
+   int error;
+ } *ak_verifykey_task;
+
+/*! \brief Пакетная проверка электронных подписей для вычисленных заранее значений хеш-функции. */
+ dll_export int ak_verifykey_verify_batch( ak_verifykey_task , const size_t );
+/*! \brief Задание для пакетной выработки ключевых пар. */
+ typedef struct signkey_keygen_task {
+  /*! \brief Контекст выработанного секретного ключа. */
+   struct signkey sk;
+  /*! \brief Контекст открытого ключа, соответствующего секретному ключу. */
+   struct verifykey vk;
+  /*! \brief Экспортное (зашифрованное на пароле) представление секретного ключа
+      или NULL, если экспорт не выполнялся. */
+   ak_asn1 asn;
+  /*! \brief Код ошибки, возникшей при выработке ключевой пары. */
+   int error;
+ } *ak_signkey_keygen_task;
+
+/*! \brief Пакетная выработка ключевых пар алгоритма ГОСТ Р 34.10-2012. */
+ dll_export int ak_signkey_generate_batch( const ak_wcurve , ak_random , ak_signkey_keygen_task ,
+                                                  const size_t , const char * , const size_t );
+/*! \brief Уничтожение контекстов, выработанных функцией ak_signkey_generate_batch(). */
+ dll_export int ak_signkey_generate_batch_destroy( ak_signkey_keygen_task , const size_t );
 /*! \brief Проверка электронной подписи для заданной области памяти. */
  dll_export bool_t ak_verifykey_verify_ptr( ak_verifykey , const ak_pointer ,
                                                                        const size_t , ak_pointer );
@@ -1837,6 +2233,32 @@ extern "C" {
  dll_export bool_t ak_verifykey_verify_file( ak_verifykey , const char * , ak_pointer );
 /** @} *//** @} */
 
+/* ----------------------------------------------------------------------------------------------- */
+/** \addtogroup skey-vko-doc Выработка общего ключа по алгоритму VKO
+ @{ */
+/*! \brief Выработка общего ключа по алгоритму VKO ГОСТ Р 34.10-2012 (Р 50.1.113-2016). */
+ dll_export int ak_signkey_vko( ak_signkey , ak_verifykey , const ak_pointer , const size_t ,
+                                                                      ak_pointer , const size_t );
+/*! \brief Задание для пакетной выработки общих ключей. */
+ typedef struct vko_task {
+  /*! \brief Открытый ключ другого абонента. */
+   ak_verifykey key;
+  /*! \brief Случайное число UKM (последовательность октетов в порядке little-endian). */
+   ak_pointer ukm;
+  /*! \brief Размер UKM (в октетах). */
+   size_t ukm_size;
+  /*! \brief Область памяти, куда помещается общий ключ. */
+   ak_pointer out;
+  /*! \brief Длина общего ключа (32 или 64 октета). */
+   size_t out_size;
+  /*! \brief Код ошибки, возникшей при выработке общего ключа. */
+   int error;
+ } *ak_vko_task;
+
+/*! \brief Пакетная выработка общих ключей по алгоритму VKO с несколькими открытыми ключами. */
+ dll_export int ak_signkey_vko_batch( ak_signkey , ak_vko_task , const size_t );
+/** @} */
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \addtogroup skey-doc
  @{ */
@@ -1844,6 +2266,9 @@ extern "C" {
  typedef int ( ak_function_password_read ) ( char *, const size_t );
 /*! \brief Функция устанавливает обработчик - функцию чтения пользовательского пароля. */
  dll_export int ak_libakrypt_set_password_read_function( ak_function_password_read * );
+/*! \brief Функция экспортирует секретный ключ в ASN.1 дерево. */
+ dll_export int ak_skey_export_to_asn1_with_password( ak_pointer , ak_asn1 ,
+                                                                     const char * , const size_t );
 /*! \brief Функция экспортирует секретный ключ в указанный файл. */
  dll_export int ak_skey_export_to_file_with_password( ak_pointer ,
                             const char *, const size_t , char * , const size_t , export_format_t );
@@ -1901,6 +2326,26 @@ extern "C" {
 /*! \brief Функция создает ключ парной связи и помещает его в контекст секретного ключа */
  dll_export ak_pointer ak_blomkey_new_pairwise_key( ak_blomkey , ak_pointer ,
                                                                            const size_t , ak_oid );
+/*! \brief Задание для пакетной выработки ключей парной связи. */
+ typedef struct blomkey_pairwise_task {
+  /*! \brief Идентификатор абонента, с которым вырабатывается ключ парной связи. */
+   ak_pointer id;
+  /*! \brief Длина идентификатора (в октетах). */
+   size_t id_size;
+  /*! \brief Область памяти, куда помещается ключ парной связи (может быть NULL). */
+   ak_pointer key;
+  /*! \brief Размер области памяти для ключа парной связи (в октетах). */
+   size_t key_size;
+  /*! \brief Контекст секретного ключа парной связи, создаваемый при заданном идентификаторе
+      алгоритма, или NULL. */
+   ak_pointer skey;
+  /*! \brief Код ошибки, возникшей при выработке ключа парной связи. */
+   int error;
+ } *ak_blomkey_pairwise_task;
+
+/*! \brief Функция вырабатывает ключи парной связи для нескольких абонентов */
+ dll_export int ak_blomkey_create_pairwise_key_batch( ak_blomkey ,
+                                               ak_blomkey_pairwise_task , const size_t , ak_oid );
 /*! \brief Функция возвращает элемент ключа с заданным индексом */
  dll_export ak_uint8 *ak_blomkey_get_element_by_index( ak_blomkey ,
                                                                const ak_uint32 , const ak_uint32 );